@@ -0,0 +1,42 @@
+/**
+ * @file datatype_size_hash.h
+ * @brief Perfect hash table of the data type names.
+ *
+ * Generated by `make datatype_hash` from DATATYPE_SIZE_LIST, do not edit.
+ * Each slot holds 1 + the index of its name in the list, or 0.
+ */
+
+#ifndef DATATYPE_SIZE_HASH_H_
+#define DATATYPE_SIZE_HASH_H_
+
+#include <stdint.h>
+
+#define DATATYPE_HASH_SEED 0x811ca5a4u
+#define DATATYPE_HASH_SLOTS 256
+
+static const uint8_t datatype_hash_table[DATATYPE_HASH_SLOTS] = {
+     0,   6,  55,   0,   0,   7,   0,   0,  34,  56,   0,   0,
+     0,   0,   0,   0,  59,   0,   0,  25,   5,  29,   0,   0,
+     0,  41,   3,   0,   0,   0,   0,   0,   0,  48,   0,  36,
+     0,   1,   0,   0,   0,   0,   0,   0,   0,   0,   0,  42,
+     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+     0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,  26,
+     0,   0,   0,   0,  22,   0,   0,   0,   0,   0,   9,  23,
+     0,   0,   0,   0,   0,   0,   0,   0,   0,  28,   0,  43,
+     0,  12,  51,   0,   0,   0,   0,   0,  52,   0,   0,   0,
+     0,   0,   0,   0,  44,   0,   0,   0,   0,   0,   0,   0,
+     0,   4,   0,   0,   0,  31,  27,  58,   0,   0,   0,  46,
+     0,   0,  53,   0,   0,  32,   0,   0,   0,   0,  35,   0,
+     0,   0,   0,  50,   0,   0,   0,   0,   0,   0,  10,   0,
+     0,   0,   0,   0,   0,   0,   0,   0,  57,   0,   0,   0,
+    14,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    11,   0,   0,   0,   0,  49,   0,   0,   0,   0,   0,   0,
+     0,   0,   0,  40,   0,  33,   0,  17,  15,   0,   0,  21,
+    20,   0,  54,   0,  30,   0,   0,   0,  19,   0,   0,   0,
+     0,   0,  45,  60,  18,   0,  24,   0,   0,  13,   0,   0,
+     0,   0,   0,  37,   8,  16,   0,   0,  39,   0,  61,   0,
+     0,   0,   0,   2,   0,   0,  38,   0,   0,   0,   0,   0,
+     0,   0,   0,  47,
+};
+
+#endif /**< DATATYPE_SIZE_HASH_H_ */
@@ -9,9 +9,12 @@
 #ifndef DATATYPE_SIZE_LOOKUP_H_
 #define DATATYPE_SIZE_LOOKUP_H_
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/types.h>
 
 /**
  * @def MAX_STRUCT_NAME_LEN
@@ -21,11 +24,107 @@
  */
 #define MAX_STRUCT_NAME_LEN 50
 
+/**
+ * @def DATATYPE_SIZE_LIST
+ * @brief The data types whose size is known by name.
+ *
+ * Expands `X(name, type)` for every C scalar type, its common spellings, and
+ * the `<stdint.h>`, `<stddef.h>` and `<sys/types.h>` typedefs. The perfect
+ * hash of these names in `datatype_size_hash.h` is generated from this list:
+ * run `make datatype_hash` after editing it.
+ */
+#define DATATYPE_SIZE_LIST(X)                                                  \
+  X("char", char)                                                              \
+  X("signed char", signed char)                                                \
+  X("unsigned char", unsigned char)                                            \
+  X("short", short)                                                            \
+  X("short int", short int)                                                    \
+  X("unsigned short", unsigned short)                                          \
+  X("unsigned short int", unsigned short int)                                  \
+  X("int", int)                                                                \
+  X("signed", signed)                                                          \
+  X("signed int", signed int)                                                  \
+  X("unsigned", unsigned)                                                      \
+  X("unsigned int", unsigned int)                                              \
+  X("long", long)                                                              \
+  X("long int", long int)                                                      \
+  X("unsigned long", unsigned long)                                            \
+  X("unsigned long int", unsigned long int)                                    \
+  X("long long", long long)                                                    \
+  X("long long int", long long int)                                            \
+  X("unsigned long long", unsigned long long)                                  \
+  X("unsigned long long int", unsigned long long int)                          \
+  X("float", float)                                                            \
+  X("double", double)                                                          \
+  X("long double", long double)                                                \
+  X("_Bool", _Bool)                                                            \
+  X("bool", bool)                                                              \
+  X("void *", void *)                                                          \
+  X("char *", char *)                                                          \
+  X("int8_t", int8_t)                                                          \
+  X("int16_t", int16_t)                                                        \
+  X("int32_t", int32_t)                                                        \
+  X("int64_t", int64_t)                                                        \
+  X("uint8_t", uint8_t)                                                        \
+  X("uint16_t", uint16_t)                                                      \
+  X("uint32_t", uint32_t)                                                      \
+  X("uint64_t", uint64_t)                                                      \
+  X("int_least8_t", int_least8_t)                                              \
+  X("int_least16_t", int_least16_t)                                            \
+  X("int_least32_t", int_least32_t)                                            \
+  X("int_least64_t", int_least64_t)                                            \
+  X("uint_least8_t", uint_least8_t)                                            \
+  X("uint_least16_t", uint_least16_t)                                          \
+  X("uint_least32_t", uint_least32_t)                                          \
+  X("uint_least64_t", uint_least64_t)                                          \
+  X("int_fast8_t", int_fast8_t)                                                \
+  X("int_fast16_t", int_fast16_t)                                              \
+  X("int_fast32_t", int_fast32_t)                                              \
+  X("int_fast64_t", int_fast64_t)                                              \
+  X("uint_fast8_t", uint_fast8_t)                                              \
+  X("uint_fast16_t", uint_fast16_t)                                            \
+  X("uint_fast32_t", uint_fast32_t)                                            \
+  X("uint_fast64_t", uint_fast64_t)                                            \
+  X("intptr_t", intptr_t)                                                      \
+  X("uintptr_t", uintptr_t)                                                    \
+  X("intmax_t", intmax_t)                                                      \
+  X("uintmax_t", uintmax_t)                                                    \
+  X("size_t", size_t)                                                          \
+  X("ssize_t", ssize_t)                                                        \
+  X("ptrdiff_t", ptrdiff_t)                                                    \
+  X("wchar_t", wchar_t)                                                        \
+  X("off_t", off_t)                                                            \
+  X("pid_t", pid_t)
+
+/**
+ * @brief Hashes a data type name for the perfect hash table.
+ *
+ * FNV-1a over the name, starting from `seed`, with the high bits folded into
+ * the low ones that index the table.
+ *
+ * @param name The data type name.
+ * @param seed The seed the table was generated with.
+ * @param len Receives the length of the name.
+ * @return The hash of the name.
+ */
+static inline uint32_t datatype_hash(const char *name, uint32_t seed,
+                                     size_t *len) {
+  const char *c = name;
+  uint32_t hash = seed;
+
+  while (*c) {
+    hash = (hash ^ (uint8_t)*c++) * 16777619u;
+  }
+  *len = c - name;
+  return hash ^ (hash >> 16);
+}
+
 /**
  * @brief Gets the size of a data type by its name.
  *
- * This function searches for the given data type name in a pre-defined
- * mapping table and returns the size of the data type if found.
+ * This function looks the given data type name up in the perfect hash table
+ * of `DATATYPE_SIZE_LIST`, with one hash and one comparison, and returns the
+ * size of the data type if found.
  *
  * @param data_type The name of the data type to get the size of.
  * @return The size of the data type if found, otherwise 0.
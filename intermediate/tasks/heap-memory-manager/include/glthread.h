@@ -30,6 +30,35 @@ typedef struct glthread_ {
   struct glthread_ *right; /**< Pointer to the right node in the linked list. */
 } glthread_t;
 
+/**
+ * @brief Structure representing a node of an intrusive pairing heap.
+ *
+ * Like `glthread_t`, this node is embedded in a user-defined structure, and
+ * the heap reaches the user data through the node's offset within it.
+ */
+typedef struct glthread_heap_node_ {
+  struct glthread_heap_node_ *child; /**< First child of the node. */
+  struct glthread_heap_node_ *next;  /**< Next sibling of the node. */
+  struct glthread_heap_node_ *prev;  /**< Previous sibling of the node, or its
+                                          parent if it is the first child. */
+} glthread_heap_node_t;
+
+/**
+ * @brief Structure representing an intrusive pairing heap.
+ *
+ * The root is the node that `glthread_priority_insert()` would keep at the
+ * head of a sorted list: no other node compares before it. The number of
+ * nodes is kept up to date, so it costs nothing to read.
+ */
+typedef struct glthread_heap_ {
+  glthread_heap_node_t *root;      /**< Node of the highest priority. */
+  unsigned int count;              /**< Number of nodes in the heap. */
+  int (*comp_fn)(void *, void *);  /**< Returns -1 if the first user data
+                                        comes before the second one. */
+  int offset;                      /**< Offset of the node within the user
+                                        data. */
+} glthread_heap_t;
+
 //-----------------< Public functions interface -----------------/
 /**
  * @brief Initialize a glthread_t structure.
@@ -126,6 +155,47 @@ void glthread_priority_insert(glthread_t *base_glthread, glthread_t *glthread,
 void *glthread_search(glthread_t *base_glthread,
                       void *(*thread_to_struct_fn)(glthread_t *), void *key,
                       int (*comparison_fn)(void *, void *));
+
+/**
+ * @brief Initialize an empty pairing heap.
+ *
+ * @param heap Pointer to the heap.
+ * @param comp_fn Pointer to the comparison function used to determine
+ * priority, with the same convention as in `glthread_priority_insert()`.
+ * @param offset Offset of the glthread_heap_node_t member within the user
+ * data.
+ */
+void init_glthread_heap(glthread_heap_t *heap, int (*comp_fn)(void *, void *),
+                        int offset);
+
+/**
+ * @brief Insert a node into a pairing heap in constant time.
+ *
+ * @param heap Pointer to the heap.
+ * @param node Pointer to the node to be inserted, which must not be in a heap.
+ */
+void glthread_heap_insert(glthread_heap_t *heap, glthread_heap_node_t *node);
+
+/**
+ * @brief Remove the node of the highest priority from a pairing heap.
+ *
+ * Takes O(log n) amortized time.
+ *
+ * @param heap Pointer to the heap.
+ * @return glthread_heap_node_t* The removed node, or NULL if the heap is empty.
+ */
+glthread_heap_node_t *glthread_heap_pop(glthread_heap_t *heap);
+
+/**
+ * @brief Remove any node from a pairing heap.
+ *
+ * Takes O(log n) amortized time.
+ *
+ * @param heap Pointer to the heap.
+ * @param node Pointer to a node of the heap.
+ */
+void glthread_heap_remove(glthread_heap_t *heap, glthread_heap_node_t *node);
+
 //-----------------< Function-like macro section -----------------/
 /**
  * @brief Macro to check if a linked list of glthread_t structures is empty.
@@ -240,4 +310,39 @@ void *glthread_search(glthread_t *base_glthread,
 #define GLTHREAD_GET_USER_DATA_FROM_OFFSET(glthreadptr, offset)                \
   (void *)((char *)(glthreadptr)-offset)
 
+/**
+ * @brief Macro to convert a glthread_heap_node_t structure to a user-defined
+ * structure.
+ *
+ * Same as `GLTHREAD_TO_STRUCT`, for a `glthread_heap_node_t` member.
+ *
+ * @param fn_name The name of the conversion function to be created.
+ * @param structure_name The type of the user-defined structure.
+ * @param field_name The name of the glthread_heap_node_t member within the
+ * user-defined structure.
+ * @param nodeptr The name of the glthread_heap_node_t pointer variable.
+ */
+#define GLTHREAD_HEAP_TO_STRUCT(fn_name, structure_name, field_name, nodeptr)  \
+  static inline structure_name *fn_name(glthread_heap_node_t *nodeptr) {       \
+    return (structure_name *)((char *)(nodeptr) -                              \
+                              (char *)&(((structure_name *)0)->field_name));   \
+  }
+
+/**
+ * @brief Macro to get the node of the highest priority of a pairing heap,
+ * without removing it.
+ *
+ * @param heapptr Pointer to the heap.
+ * @return glthread_heap_node_t* The root node, or NULL if the heap is empty.
+ */
+#define GLTHREAD_HEAP_PEEK(heapptr) ((heapptr)->root)
+
+/**
+ * @brief Macro to get the number of nodes in a pairing heap.
+ *
+ * @param heapptr Pointer to the heap.
+ * @return unsigned int The number of nodes.
+ */
+#define GLTHREAD_HEAP_COUNT(heapptr) ((heapptr)->count)
+
 #endif /**< GLUETHREAD_H_ */
@@ -20,6 +20,7 @@
 
 //-----------------< Includes section -----------------/
 /**< System includes */
+#include <pthread.h>
 #include <stdint.h>
 /**< External includes */
 #include "glthread.h"
@@ -28,6 +29,226 @@
 #define MM_MAX_STRUCT_NAME 32
 #define MAX_STRUCT_NAME_LEN 50
 
+/**
+ * @brief Number of page families that can own a per-thread cache bin.
+ *
+ * Families are numbered in registration order; families registered after
+ * this limit is reached bypass the thread cache and always take the family
+ * lock.
+ */
+#define MM_TCACHE_MAX_FAMILIES 64
+
+/**
+ * @brief Size of the huge pages requested with `MAP_HUGETLB`.
+ *
+ * Large object spans of at least this size are mapped with huge pages when
+ * `mm_set_large_object_hugepages()` enabled them; the span length is rounded
+ * up to a multiple of this size.
+ */
+#define MM_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+/**
+ * @brief Number of buckets of the page family hash index.
+ */
+#define MM_FAMILY_HASH_BUCKETS 256
+
+/**
+ * @brief Maximum number of objects held by one per-thread cache bin.
+ */
+#define MM_TCACHE_CAPACITY 32
+
+/**
+ * @brief Number of objects moved between a thread cache bin and its page
+ * family on a refill or flush.
+ */
+#define MM_TCACHE_BATCH 16
+
+/**
+ * @brief Value stored in the first word of every object sitting in a thread
+ * cache bin, so that freeing a cached object again can be caught.
+ */
+#define MM_TCACHE_KEY ((uintptr_t)0x6d6d74636163686bULL)
+
+/**
+ * @brief Number of objects `xcalloc_bulk()` and `xfree_bulk()` handle per
+ * acquisition of a family lock.
+ */
+#define MM_BULK_CHUNK 64
+
+/**
+ * @brief Number of allocations and frees a thread counts locally before
+ * adding them to the global counters read by `mm_get_stats()`.
+ */
+#define MM_STATS_PUBLISH_BATCH 64
+
+/**
+ * @brief Average number of bytes allocated between two heap profile samples
+ * when `mm_heap_profile_start()` is given 0.
+ */
+#define MM_PROFILE_DEFAULT_INTERVAL (512 * 1024)
+
+/**
+ * @brief Limits of the heap profiler tables.
+ *
+ * Stacks deeper than `MM_PROFILE_MAX_DEPTH` frames are truncated. Samples
+ * taken while `MM_PROFILE_MAX_SITES` distinct stacks or
+ * `MM_PROFILE_MAX_SAMPLES` live samples are recorded are dropped. Both
+ * `MM_PROFILE_MAX_SAMPLES` and `MM_PROFILE_FILTER_SIZE` are powers of two.
+ */
+#define MM_PROFILE_MAX_DEPTH 24
+
+/**
+ * @brief Number of frames of the allocation functions captured on top of
+ * `MM_PROFILE_MAX_DEPTH`, since they are trimmed from sampled stacks.
+ */
+#define MM_PROFILE_MAX_ALLOC_FRAMES 8
+#define MM_PROFILE_MAX_SITES 1024
+#define MM_PROFILE_SITE_BUCKETS 1024
+#define MM_PROFILE_MAX_SAMPLES 16384
+#define MM_PROFILE_FILTER_SIZE 65536
+
+/**
+ * @brief Bytes in front of every movable object, holding the address of its
+ * handle so that the compactor can update it. Keeps the objects aligned on
+ * `MM_BLOCK_ALIGNMENT`.
+ */
+#define MM_MOVABLE_PREFIX 16
+
+/**
+ * @brief Bit of `mm_handle_slot_t::pins` set while the compactor moves the
+ * object.
+ */
+#define MM_HANDLE_MOVING 0x80000000u
+
+/**
+ * @brief Limits of the compactor.
+ *
+ * Pages whose live blocks take less than `MM_COMPACT_SPARSE_PERCENT` of their
+ * memory are evacuated, at most `MM_COMPACT_MAX_PAGES` per `mm_compact()`
+ * call and `MM_COMPACT_STEP_PAGES` per page family and interval of the
+ * compactor thread.
+ */
+#define MM_COMPACT_SPARSE_PERCENT 50
+#define MM_COMPACT_MAX_PAGES 64
+#define MM_COMPACT_STEP_PAGES 8
+
+/**
+ * @brief Number of segregated free block bins per page family.
+ *
+ * Bins 0 to `MM_FREE_BINS_SMALL - 1` hold free blocks whose size falls in one
+ * `MM_FREE_BIN_SMALL_STEP` byte wide range. The remaining bins split every
+ * power of two above `MM_FREE_BINS_SMALL * MM_FREE_BIN_SMALL_STEP` into
+ * `MM_FREE_BIN_SUBDIVISIONS` ranges; the last bin also takes every larger
+ * block. The bin count matches the width of `free_bins_bitmap`.
+ */
+#define MM_FREE_BINS 64
+#define MM_FREE_BINS_SMALL 32
+#define MM_FREE_BIN_SMALL_STEP 16
+#define MM_FREE_BIN_SUBDIVISIONS_LOG2 2
+#define MM_FREE_BIN_SUBDIVISIONS (1 << MM_FREE_BIN_SUBDIVISIONS_LOG2)
+
+/**
+ * @brief Default number of empty pages each page family keeps for reuse.
+ *
+ * @see mm_set_page_pool_limits()
+ */
+#define MM_FAMILY_PAGE_POOL_DEFAULT 4
+
+/**
+ * @brief Default number of empty pages kept in the pool shared by all page
+ * families, per NUMA node.
+ *
+ * @see mm_set_page_pool_limits()
+ */
+#define MM_GLOBAL_PAGE_POOL_DEFAULT 64
+
+/**
+ * @brief Largest large object span, in system pages, kept for reuse once its
+ * object is freed.
+ */
+#define MM_LARGE_SPAN_POOL_MAX_UNITS 64
+
+/**
+ * @brief Number of system pages the large span pool of a NUMA node may keep
+ * per page of the global pool limit.
+ *
+ * @see mm_set_page_pool_limits()
+ */
+#define MM_LARGE_SPAN_POOL_SCALE 16
+
+/**
+ * @brief Number of NUMA nodes the memory manager keeps apart. Memory of
+ * higher nodes is managed as if it belonged to node 0.
+ */
+#define MM_NUMA_MAX_NODES 8
+
+/**
+ * @brief Number of allocations a thread makes between two lookups of the
+ * NUMA node it runs on.
+ */
+#define MM_NUMA_REFRESH_OPS 1024
+
+/**
+ * @brief `mbind()` policy that allocates from the given node while it has
+ * free memory, from `<numaif.h>`.
+ */
+#define MM_MPOL_PREFERRED 1
+
+/**
+ * @brief Checks of the debug mode enabled at startup, a combination of the
+ * `MM_DEBUG_*` flags. Build with e.g. `-DMM_DEBUG_DEFAULT_FLAGS=MM_DEBUG_ALL`
+ * to run a program with every check without changing it.
+ */
+#ifndef MM_DEBUG_DEFAULT_FLAGS
+#define MM_DEBUG_DEFAULT_FLAGS 0
+#endif
+
+/**
+ * @brief Values written by the debug mode.
+ *
+ * `MM_DEBUG_CANARY_BYTE` fills the bytes between the end of an object and
+ * the end of its block, `MM_DEBUG_ALLOC_BYTE` the objects allocated without
+ * clearing and `MM_DEBUG_FREE_BYTE` the freed blocks. `MM_DEBUG_MAGIC`,
+ * combined with the object size, marks the trailer of a block.
+ */
+#define MM_DEBUG_CANARY_BYTE 0xCB
+#define MM_DEBUG_ALLOC_BYTE 0xAA
+#define MM_DEBUG_FREE_BYTE 0xDD
+#define MM_DEBUG_MAGIC 0x484D4D43u
+
+/**
+ * @brief Alignment of the objects handed out by `arena_alloc()`, matching
+ * `MM_PAGE_DATA_ALIGNMENT` so that arenas can hold any fundamental type.
+ */
+#define MM_ARENA_ALIGNMENT 16
+
+/**
+ * @brief Alignment of the data blocks of page families.
+ *
+ * Block sizes are rounded up to this alignment so that the metadata of the
+ * next block, and the application data after it, stay aligned.
+ */
+#define MM_BLOCK_ALIGNMENT 8
+
+/**
+ * @brief Alignment of the first data block of a page.
+ *
+ * Families whose block sizes are multiples of this alignment hand out
+ * pointers aligned like `malloc()`'s, which the preload library relies on.
+ */
+#define MM_PAGE_DATA_ALIGNMENT 16
+
+/**
+ * @brief Smallest data block, large enough to hold the free list links that
+ * a free block stores in its data area.
+ */
+#define MM_MIN_BLOCK_SIZE ((uint32_t)sizeof(glthread_t))
+
+/**
+ * @brief Largest data block, bounded by the width of `block_size`.
+ */
+#define MM_MAX_BLOCK_SIZE 0x7FFFFFF8u
+
 //-----------------< user defined data type section -----------------/
 /**
  * @brief Represents a boolean value.
@@ -46,50 +267,92 @@ typedef enum {
  *
  * The `block_meta_data_t` structure represents metadata for a memory block.
  * It includes information such as whether the block is free or allocated,
- * its size, pointers to the previous and next blocks (if applicable), and
- * the offset within the memory region.
+ * its size, and the offsets of the block and of its previous and next blocks
+ * within the hosting virtual memory page.
+ *
+ * The header is kept to 16 bytes: neighbours are located through 32-bit page
+ * offsets instead of pointers (an offset of 0 means there is no neighbour,
+ * since no block starts at the beginning of a page), the free flag shares a
+ * word with the size, and the links of the free block lists are stored in
+ * the data area of free blocks only.
+ *
+ * `prev_offset` and `prev_free` form the boundary tag of the previous block,
+ * kept in this header rather than in a footer of that block: freeing a block
+ * learns from its own header whether it can merge backwards, and only reads
+ * the previous block's header when it is free.
  */
 typedef struct block_meta_data_ {
-  vm_bool_t is_free;   /**< Flag indicating whether the block is free. */
-  uint32_t block_size; /**< Size of the memory block. */
-  uint32_t offset;     /**< Offset within the memory region. */
-  struct block_meta_data_
-      *prev_block; /**< Pointer to the previous memory block. */
-  struct block_meta_data_ *next_block; /**< Pointer to the next memory block. */
-  glthread_t priority_thread_glue; /**< Priority thread glue for managing block
-                                      priority. */
+  uint32_t block_size : 31; /**< Size of the memory block. */
+  uint32_t is_free : 1;     /**< Flag indicating whether the block is free. */
+  uint32_t offset;          /**< Offset of the block within its virtual
+                               memory page. */
+  uint32_t prev_offset : 31; /**< Offset of the previous memory block, or 0. */
+  uint32_t prev_free : 1;    /**< Whether the previous memory block is free. */
+  uint32_t next_offset;      /**< Offset of the next memory block, or 0. */
 } block_meta_data_t;
 
 /**
- * @brief Macro to declare a conversion function for converting a glthread_t
- * structure to a user-defined structure pointer.
+ * @brief Trailer ending the blocks allocated in the debug mode.
  *
- * This macro simplifies the process of declaring a conversion function that
- * takes a glthread_t pointer and returns a pointer to a user-defined structure.
- * It is particularly useful when you have a glthread_t structure embedded
- * within a user-defined structure and need to access the user-defined data.
+ * The bytes between the end of the object and the trailer are filled with
+ * `MM_DEBUG_CANARY_BYTE`.
+ */
+typedef struct mm_debug_trailer_ {
+  uint32_t req_size; /**< Size requested for the object. */
+  uint32_t magic;    /**< `MM_DEBUG_MAGIC ^ req_size`. */
+  uint64_t canary;   /**< Eight `MM_DEBUG_CANARY_BYTE`. */
+} mm_debug_trailer_t;
+
+/**
+ * @brief Returns the free list links of a free block.
  *
- * @param fn_name The name of the conversion function to be declared.
- * @param struct_type The type of the user-defined structure.
- * @param glthread_member The name of the glthread_t member within the
- * user-defined structure.
- * @param glthread_ptr The name of the glthread_t pointer variable.
+ * A free block keeps its `glthread_t` links in the first bytes of its data
+ * area, which the application no longer uses.
  *
- * Example usage:
- * Suppose we have a user-defined structure named block_meta_data_t that
- * contains a glthread_t member named priority_thread_glue. To declare a
- * conversion function named glthread_to_block_meta_data to convert a glthread_t
- * pointer to a block_meta_data_t pointer, we use the following declaration:
+ * @param block_meta_data_ptr Pointer to the metadata of a free block.
+ * @return Pointer to the links of the block.
+ */
+#define MM_FREE_BLOCK_GLUE(block_meta_data_ptr)                                \
+  ((glthread_t *)((block_meta_data_ptr) + 1))
+
+/**
+ * @brief Converts free list links back to the metadata of their free block.
  *
- * GLTHREAD_TO_STRUCT(glthread_to_block_meta_data, block_meta_data_t,
- *                    priority_thread_glue, glthread_ptr);
+ * This is the inverse of `MM_FREE_BLOCK_GLUE`, used when walking the free
+ * block bins of a page family.
  *
- * Now, we can use glthread_to_block_meta_data to convert glthread_t pointers to
- * block_meta_data_t pointers and access the metadata associated with memory
- * blocks.
+ * @param glthread_ptr Pointer to the links stored in a free block.
+ * @return Pointer to the metadata of the free block.
+ */
+static inline block_meta_data_t *
+glthread_to_block_meta_data(glthread_t *glthread_ptr) {
+  return (block_meta_data_t *)glthread_ptr - 1;
+}
+
+/**
+ * @brief Kind of memory hosted by a virtual memory page.
+ */
+typedef enum {
+  MM_PAGE_BLOCKS = 0, /**< Single system page carved into data blocks. */
+  MM_PAGE_LARGE = 1,  /**< Multi-page span hosting a single large object. */
+  MM_PAGE_ARENA = 2,  /**< Single system page bump-allocated by an arena. */
+  MM_PAGE_SLAB = 3,   /**< Single system page carved into equal slots. */
+  MM_PAGE_GUARDED = 4 /**< Span hosting a single object that ends at a
+                         `PROT_NONE` guard page, in the debug mode. */
+} vm_page_kind_t;
+
+/**
+ * @brief Slot bookkeeping of a slab page.
+ *
+ * Slots are handed out in address order the first time (`carved_slots`
+ * counts them), after which freed slots are recycled through an intrusive
+ * list whose links are stored in the free slots themselves.
  */
-GLTHREAD_TO_STRUCT(glthread_to_block_meta_data, block_meta_data_t,
-                   priority_thread_glue, glthread_ptr);
+typedef struct mm_slab_meta_data_ {
+  void *free_list;       /**< Most recently freed slot, or NULL. */
+  uint32_t used_slots;   /**< Number of slots currently allocated. */
+  uint32_t carved_slots; /**< Number of slots handed out at least once. */
+} mm_slab_meta_data_t;
 
 /**
  * @brief Structure representing a virtual memory page.
@@ -103,8 +366,19 @@ typedef struct vm_page_ {
   struct vm_page_ *prev; /**< Pointer to the previous virtual memory page. */
   struct vm_page_family_
       *pg_family; /**< Pointer to the page family associated with the page. */
-  block_meta_data_t block_meta_data; /**< Metadata for managing memory blocks
-                                        within the page. */
+  vm_page_kind_t page_kind; /**< What the page hosts. */
+  uint32_t units;           /**< Number of system pages mapped for the page. */
+  vm_bool_t is_hugetlb;     /**< Whether the page is backed by huge pages. */
+  uint32_t zero_watermark;  /**< Offset from which the page is known to hold
+                               zeros only, as mapped by the kernel. */
+  vm_bool_t is_evacuating;  /**< Whether the compactor is moving the blocks
+                               of the page out, so none may be moved in. */
+  uint32_t numa_node;       /**< NUMA node the page was bound to. */
+  union {
+    block_meta_data_t block_meta_data; /**< Metadata for managing memory
+                                          blocks within the page. */
+    mm_slab_meta_data_t slab_meta_data; /**< Slots of a `MM_PAGE_SLAB`. */
+  } __attribute__((aligned(MM_PAGE_DATA_ALIGNMENT)));
   char page_memory[0]; /**< Memory region allocated for storing data blocks. */
 } vm_page_t;
 
@@ -113,14 +387,52 @@ typedef struct vm_page_ {
  *
  * This structure maintains information about a page family in virtual memory,
  * including the name of the structure, its size, a pointer to the most recent
- * virtual memory page in use, and a priority list of free memory blocks.
+ * virtual memory page in use, and the size-segregated lists of free memory
+ * blocks.
  */
 typedef struct vm_page_family_ {
   char struct_name[MM_MAX_STRUCT_NAME]; /**< Name of the structure. */
   uint32_t struct_size;                 /**< Size of the structure. */
+  uint32_t alignment; /**< Alignment of every block's application data. */
+  uint32_t family_id; /**< Registration index, selects the thread cache bin. */
   vm_page_t *first_page; /**< Pointer to the most recent vm page in use. */
-  glthread_t free_block_priority_list_head; /**< Priority list of free memory
-                                               blocks. */
+  vm_page_t *first_large_page; /**< List of the large object spans in use. */
+  glthread_t *free_bins; /**< `MM_FREE_BINS` segregated lists of free memory
+                            blocks, one per size class, set up with the
+                            first data page of the family. */
+  uint64_t free_bins_bitmap; /**< Bit i is set when free_bins[i] is not
+                                empty. */
+  uint32_t placement;        /**< `mm_placement_policy_t` choosing the free
+                                block of a request. */
+  uintptr_t next_fit_cursor; /**< Address past the last block placed by
+                                `MM_PLACEMENT_NEXT_FIT`. */
+  vm_bool_t is_slab;         /**< Whether single units come from slab pages. */
+  vm_bool_t is_movable; /**< Whether objects are reached through handles and
+                           may be moved by the compactor. */
+  uint32_t numa_node;   /**< NUMA node the pages of the family come from. */
+  struct vm_page_family_ *numa_parent; /**< Family registered by the
+                                          application, for the families of
+                                          other nodes; NULL otherwise. */
+  struct vm_page_family_
+      *numa_families[MM_NUMA_MAX_NODES]; /**< Families serving the threads
+                                            of each node, created on their
+                                            first allocation; node 0 is
+                                            served by the family itself. */
+  uint32_t slab_slot_size;   /**< Size of a slot of the slab pages. */
+  uint32_t slab_slots_per_page; /**< Number of slots of a slab page. */
+  vm_page_t *slab_partial_pages; /**< Slab pages with at least a free slot. */
+  vm_page_t *slab_full_pages;    /**< Slab pages with no free slot. */
+  vm_page_t *retained_pages; /**< Empty pages kept for reuse by the family. */
+  uint32_t retained_count;   /**< Number of pages in retained_pages. */
+  uint32_t data_pages;       /**< Number of pages carved into blocks. */
+  uint32_t slab_used_slots;  /**< Number of slab slots handed out. */
+  uint64_t free_block_count; /**< Number of blocks in the free bins. */
+  uint64_t free_bytes;       /**< Sum of the sizes of the blocks in the free
+                                bins. */
+  pthread_mutex_t family_lock; /**< Serializes access to the pages and the free
+                                  block list of the family. */
+  struct vm_page_family_ *hash_next; /**< Next page family in the same bucket
+                                        of the name hash index. */
 } vm_page_family_t;
 
 /**
@@ -134,6 +446,129 @@ typedef struct vm_page_for_families_ {
                                          structure families. */
 } vm_page_for_families_t;
 
+/**
+ * @brief Bump-pointer arena.
+ *
+ * The arena lives at the start of its home page, which is the last page of
+ * `first_page`'s list. Objects carry no metadata: each allocation only moves
+ * `bump_offset` forward in the current page, and pages are handed back in
+ * bulk by `arena_reset()` and `arena_destroy()`.
+ */
+typedef struct mm_arena_ {
+  vm_page_t *first_page;       /**< Arena pages, the current one first. */
+  vm_page_t *first_large_page; /**< Spans of objects larger than a page. */
+  uint32_t bump_offset;        /**< Offset of the next free byte within
+                                  first_page. */
+} mm_arena_t;
+
+/**
+ * @brief Per-thread cache of single-unit objects of one page family.
+ *
+ * Objects held in a bin are still marked as allocated inside their hosting
+ * page; they are only handed back to the page family when the bin overflows,
+ * when the thread exits or when `mm_thread_cache_flush()` is called.
+ */
+typedef struct mm_thread_cache_bin_ {
+  vm_page_family_t *family; /**< Page family the cached objects belong to. */
+  uint32_t count;           /**< Number of objects currently cached. */
+  uint32_t zeroed_mask;     /**< Bit i is set when objects[i] is known to
+                               hold zeros only. */
+  void *objects[MM_TCACHE_CAPACITY]; /**< Cached application pointers. */
+} mm_thread_cache_bin_t;
+
+/**
+ * @brief Thread cache of a single thread, one bin per page family.
+ */
+typedef struct mm_thread_cache_ {
+  mm_thread_cache_bin_t bins[MM_TCACHE_MAX_FAMILIES]; /**< Bins indexed by
+                                                         family_id. */
+  uint64_t zeroing_bytes_saved; /**< Bytes not zeroed by this thread, not yet
+                                   added to the global counter. */
+  uint32_t alloc_count; /**< Allocations not yet added to the global
+                           counter. */
+  uint32_t free_count;  /**< Frees not yet added to the global counter. */
+  uint32_t has_allocated; /**< Whether the thread allocated anything, which
+                             it reports in `mm_allocations_started`. */
+  int64_t profile_countdown; /**< Bytes left to allocate before the next heap
+                                profile sample. */
+  uint32_t profile_rng; /**< State of the sample interval generator, 0 until
+                           the first sample. */
+  uint32_t numa_node;   /**< NUMA node the thread last ran on. */
+  uint32_t numa_countdown; /**< Allocations left before numa_node is looked
+                              up again. */
+} mm_thread_cache_t;
+
+/**
+ * @brief Allocation site of the heap profiler: a distinct call stack and the
+ * sampled objects allocated from it.
+ */
+typedef struct mm_profile_site_ {
+  void *stack[MM_PROFILE_MAX_DEPTH]; /**< Return addresses, innermost
+                                        first. */
+  uint32_t depth;     /**< Number of valid entries of stack. */
+  uint32_t hash_next; /**< Index + 1 of the next site of the same bucket. */
+  uint64_t live_count;     /**< Sampled objects still allocated. */
+  uint64_t live_bytes;     /**< Their requested sizes. */
+  uint64_t live_estimate;  /**< Estimated bytes they stand for. */
+  uint64_t alloc_count;    /**< Sampled objects ever allocated. */
+  uint64_t alloc_bytes;    /**< Their requested sizes. */
+  uint64_t alloc_estimate; /**< Estimated bytes they stand for. */
+} mm_profile_site_t;
+
+/**
+ * @brief Live sampled object, in an open-addressing table keyed by address.
+ */
+typedef struct mm_profile_sample_ {
+  void *app_data;    /**< Object address, NULL for an empty slot. */
+  uint32_t site;     /**< Index of its allocation site. */
+  uint32_t size;     /**< Size it was allocated with. */
+  uint64_t estimate; /**< Bytes it stands for. */
+} mm_profile_sample_t;
+
+/**
+ * @brief State of the heap profiler, mapped on the first
+ * `mm_heap_profile_start()` and protected by `mm_profile_lock`.
+ *
+ * `filter` counts the live samples per hash of their address; a free whose
+ * counter is zero cannot concern a sample and skips the lock.
+ */
+typedef struct mm_heap_profile_ {
+  uint32_t sample_interval; /**< Average bytes between two samples. */
+  uint32_t site_count;      /**< Number of used entries of sites. */
+  uint32_t live_samples;    /**< Number of used slots of samples. */
+  uint64_t dropped_samples; /**< Samples lost to full tables. */
+  uint32_t site_buckets[MM_PROFILE_SITE_BUCKETS]; /**< Index + 1 of the first
+                                                     site of each bucket. */
+  uint16_t filter[MM_PROFILE_FILTER_SIZE];
+  mm_profile_site_t sites[MM_PROFILE_MAX_SITES];
+  mm_profile_sample_t samples[MM_PROFILE_MAX_SAMPLES];
+} mm_heap_profile_t;
+
+/**
+ * @brief Handle of a movable object, allocated from a slab family of its
+ * own.
+ *
+ * `pins` counts the callers using the object's address. The compactor only
+ * moves objects it can switch from 0 to `MM_HANDLE_MOVING` pins, and a pin
+ * taken while that bit is set waits for the move to complete.
+ */
+typedef struct mm_handle_slot_ {
+  void *app_data; /**< Current address of the object. */
+  uint32_t pins;  /**< Number of pins, with `MM_HANDLE_MOVING` or'ed in
+                     during a move. */
+} mm_handle_slot_t;
+
+/**
+ * @brief Buffered output of `mm_heap_profile_write()`, which must not
+ * allocate.
+ */
+typedef struct mm_profile_writer_ {
+  int fd;           /**< Destination file. */
+  uint32_t len;     /**< Number of bytes pending in buf. */
+  vm_bool_t failed; /**< Whether a write to fd failed. */
+  char buf[4096];
+} mm_profile_writer_t;
+
 /**
  * @brief Allocates a new virtual memory page for a given page family.
  *
@@ -152,8 +587,9 @@ vm_page_t *allocate_vm_page(vm_page_family_t *vm_page_family);
  * @brief Deletes and frees a virtual memory page.
  *
  * This function deletes and frees a virtual memory page. It removes the page
- * from the linked list of pages belonging to its page family and deallocates
- * the memory associated with the page.
+ * from the linked list of pages belonging to its page family and hands it to
+ * the page retention pool, which either keeps it for reuse or returns it to
+ * the kernel.
  *
  * @param vm_page Pointer to the virtual memory page to be deleted and freed.
  */
@@ -163,9 +599,9 @@ void mm_vm_page_delete_and_free(vm_page_t *vm_page);
 /**
  * @brief Looks up a page family by its name.
  *
- * This function iterates over all virtual memory pages hosting page families
- * and returns a pointer to the page family object identified by the given
- * struct_name. If no such page family object is found, it returns NULL.
+ * This function looks the given struct_name up in the hash index of the
+ * registered page families and returns a pointer to the page family object
+ * it identifies. If no such page family object is found, it returns NULL.
  *
  * @param struct_name The name of the page family to look up.
  *
@@ -197,10 +633,9 @@ vm_page_family_t *lookup_page_family_by_name(char *struct_name);
  * @note
  * A virtual memory page is considered empty if all the following conditions are
  * met:
- * - The 'next_block' pointer in the block metadata is NULL, indicating no next
+ * - The 'next_offset' in the block metadata is 0, indicating no next block.
+ * - The 'prev_offset' in the block metadata is 0, indicating no previous
  * block.
- * - The 'prev_block' pointer in the block metadata is NULL, indicating no
- * previous block.
  * - The 'is_free' flag in the block metadata is set to MM_TRUE, indicating the
  * page is free.
  *
@@ -216,9 +651,9 @@ vm_bool_t mm_is_vm_page_empty(vm_page_t *vm_page);
  * page family.
  *
  * This function adds the metadata of a free block to the free block list of a
- * virtual memory page family. The block metadata is inserted into the free
- * block list in descending order of block size, based on the comparison
- * function `free_blocks_comparison_function`.
+ * virtual memory page family. The block is pushed onto the bin matching its
+ * size and the bin is flagged as non-empty in `free_bins_bitmap`, which takes
+ * constant time.
  *
  * @param vm_page_family Pointer to the virtual memory page family to which the
  * free block metadata will be added.
@@ -233,6 +668,20 @@ static void
 mm_add_free_block_meta_data_to_free_block_list(vm_page_family_t *vm_page_family,
                                                block_meta_data_t *free_block);
 
+/**
+ * @brief Remove a free block's metadata from the free block list of a virtual
+ * memory page family.
+ *
+ * The block must still have the size it had when it was added, since that
+ * size selects the bin whose bit is cleared once the bin becomes empty.
+ *
+ * @param vm_page_family Pointer to the virtual memory page family holding the
+ * free block.
+ * @param free_block Pointer to the metadata of the free block to remove.
+ */
+static void mm_remove_free_block_meta_data_from_free_block_list(
+    vm_page_family_t *vm_page_family, block_meta_data_t *free_block);
+
 /**
  * @brief Prints details of a virtual memory page.
  *
@@ -279,7 +728,8 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
  * @note This macro is typically used in conjunction with
  * `ITERATE_PAGE_FAMILIES_END` to iterate over page families stored within a
  * virtual memory page. The loop continues until all page families have been
- * iterated or the maximum number of families per page is reached.
+ * iterated or the maximum number of families per page is reached. Slots are
+ * published with a release store of their size, so the walk needs no lock.
  *
  * @warning This macro assumes that `vm_page_for_families_ptr` points to a valid
  * virtual memory page structure containing page families, and `curr` is a valid
@@ -293,7 +743,8 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
     uint32_t _count = 0;                                                       \
     for (curr =                                                                \
              (vm_page_family_t *)&vm_page_for_families_ptr->vm_page_family[0]; \
-         curr->struct_size && _count < MAX_FAMILIES_PER_VM_PAGE;               \
+         _count < MAX_FAMILIES_PER_VM_PAGE &&                                  \
+         __atomic_load_n(&curr->struct_size, __ATOMIC_ACQUIRE);                \
          curr++, _count++) {
 
 /**
@@ -376,7 +827,31 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
     curr = &(vm_page_ptr->block_meta_data);                                    \
     block_meta_data_t *next = NULL;                                            \
     for (; curr != NULL; curr = next) {                                        \
-      next = NEXT_META_BLOCK(curr);
+      next = NEXT_META_BLOCK(curr);                                            \
+      MM_DEBUG_VALIDATE_BLOCK(vm_page_ptr, curr);
+
+/**
+ * @brief Reads the checks of the debug mode.
+ *
+ * Any thread may read them while another one sets them, so the read is
+ * atomic; relaxed order is enough since they only change before the first
+ * allocation.
+ */
+#define MM_DEBUG_FLAGS() __atomic_load_n(&mm_debug_flags, __ATOMIC_RELAXED)
+
+/**
+ * @brief Verifies a block of a page walk when the debug mode validates block
+ * chains, before the walk follows its links.
+ *
+ * @param vm_page_ptr Pointer to the virtual memory page.
+ * @param curr Pointer to the block.
+ */
+#define MM_DEBUG_VALIDATE_BLOCK(vm_page_ptr, curr)                             \
+  do {                                                                         \
+    if (__builtin_expect(MM_DEBUG_FLAGS() & MM_DEBUG_VALIDATE, 0)) {           \
+      mm_debug_check_block(vm_page_ptr, curr);                                 \
+    }                                                                          \
+  } while (0)
 
 /**
  * @brief Macro to end iteration over all memory blocks within a virtual memory
@@ -417,14 +892,30 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
 /**
  * @brief Macro to retrieve the virtual memory page from a block's metadata.
  *
- * This macro retrieves the virtual memory page associated with a given block's
- * metadata.
+ * Every metadata block lies in the first system page of its virtual memory
+ * page, be it a page family page, a large object span, huge pages included,
+ * or the header page of a guarded span, so the page is found by masking the
+ * address, without loading the header.
  *
  * @param block_meta_data_ptr Pointer to the block's metadata.
  * @return Pointer to the virtual memory page.
  */
 #define MM_GET_PAGE_FROM_META_BLOCK(block_meta_data_ptr)                       \
-  ((void *)((char *)(block_meta_data_ptr) - (block_meta_data_ptr)->offset))
+  ((void *)((uintptr_t)(block_meta_data_ptr) & ~(SYSTEM_PAGE_SIZE - 1)))
+
+/**
+ * @brief Macro to retrieve the virtual memory page hosting application data.
+ *
+ * Every page family page, slab page and large object span starts on a system
+ * page boundary and application data never starts at that boundary, so the
+ * hosting page is found by masking the address, without touching the memory
+ * right before the data (slab slots have no metadata there).
+ *
+ * @param app_data Pointer to the application data.
+ * @return Pointer to the virtual memory page.
+ */
+#define MM_GET_PAGE_FROM_APP_DATA(app_data)                                    \
+  ((vm_page_t *)(((uintptr_t)(app_data) - 1) & ~(SYSTEM_PAGE_SIZE - 1)))
 
 /**
  * @brief Macro to retrieve the metadata of the next block based on the current
@@ -450,6 +941,21 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
   ((block_meta_data_t *)((char *)(block_meta_data_ptr + 1) +                   \
                          (block_meta_data_ptr)->block_size))
 
+/**
+ * @brief Macro to get the metadata block at a given offset of the page
+ * hosting another metadata block.
+ *
+ * @param block_meta_data_ptr Pointer to a metadata block of the page.
+ * @param block_offset Offset of the wanted metadata block, or 0.
+ *
+ * @return Pointer to the metadata block, or NULL if `block_offset` is 0.
+ */
+#define MM_META_BLOCK_AT(block_meta_data_ptr, block_offset)                    \
+  ((block_offset) ? (block_meta_data_t *)((char *)MM_GET_PAGE_FROM_META_BLOCK( \
+                                              block_meta_data_ptr) +           \
+                                          (block_offset))                      \
+                  : NULL)
+
 /**
  * @brief Macro to get the pointer to the next metadata block.
  *
@@ -466,7 +972,8 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
  * coalescing adjacent free memory blocks or iterating over allocated memory
  * blocks.
  */
-#define NEXT_META_BLOCK(block_meta_data_ptr) ((block_meta_data_ptr)->next_block)
+#define NEXT_META_BLOCK(block_meta_data_ptr)                                   \
+  MM_META_BLOCK_AT(block_meta_data_ptr, (block_meta_data_ptr)->next_offset)
 
 /**
  * @brief Macro to get the pointer to the previous metadata block.
@@ -483,7 +990,26 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
  * traversal of the metadata blocks linked list, allowing operations such as
  * merging adjacent free memory blocks or finding neighboring blocks.
  */
-#define PREV_META_BLOCK(block_meta_data_ptr) ((block_meta_data_ptr)->prev_block)
+#define PREV_META_BLOCK(block_meta_data_ptr)                                   \
+  MM_META_BLOCK_AT(block_meta_data_ptr, (block_meta_data_ptr)->prev_offset)
+
+/**
+ * @brief Writes the boundary tag of a block into the header of the block
+ * that follows it, if any.
+ *
+ * Must be used whenever the block changes its free state or becomes the
+ * previous block of another one.
+ *
+ * @param block_meta_data_ptr Pointer to the metadata block.
+ */
+#define MM_BLOCK_TAG_NEXT(block_meta_data_ptr)                                 \
+  do {                                                                         \
+    if ((block_meta_data_ptr)->next_offset) {                                  \
+      block_meta_data_t *_next = NEXT_META_BLOCK(block_meta_data_ptr);         \
+      _next->prev_offset = (block_meta_data_ptr)->offset;                      \
+      _next->prev_free = (block_meta_data_ptr)->is_free;                       \
+    }                                                                          \
+  } while (0)
 
 /**
  * @brief Macro to mark a virtual memory page as empty.
@@ -504,8 +1030,8 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
  * - @p vm_page_t_ptr: Pointer to the virtual memory page to be marked as empty.
  *
  * The macro does the following:
- * - Sets the 'next_block' and 'prev_block' pointers of the block metadata to
- * NULL, indicating that the page does not have any neighboring blocks.
+ * - Sets the 'next_offset' and 'prev_offset' of the block metadata to 0,
+ * indicating that the page does not have any neighboring blocks.
  * - Sets the 'is_free' flag of the block metadata to MM_TRUE, indicating that
  * the page is free and available for allocation.
  *
@@ -526,8 +1052,9 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
  */
 #define MARK_VM_PAGE_EMPTY(vm_page_t_ptr)                                      \
   do {                                                                         \
-    (vm_page_t_ptr)->block_meta_data.next_block = NULL;                        \
-    (vm_page_t_ptr)->block_meta_data.prev_block = NULL;                        \
+    (vm_page_t_ptr)->block_meta_data.next_offset = 0;                          \
+    (vm_page_t_ptr)->block_meta_data.prev_offset = 0;                          \
+    (vm_page_t_ptr)->block_meta_data.prev_free = MM_FALSE;                     \
     (vm_page_t_ptr)->block_meta_data.is_free = MM_TRUE;                        \
   } while (0)
 
@@ -548,11 +1075,11 @@ void mm_print_vm_page_details(vm_page_t *vm_page);
  * allocation process.
  */
 #define mm_bind_blocks_for_allocation(allocated_meta_block, free_meta_block)   \
-  free_meta_block->prev_block = allocated_meta_block;                          \
-  free_meta_block->next_block = allocated_meta_block->next_block;              \
-  allocated_meta_block->next_block = free_meta_block;                          \
-  if (free_meta_block->next_block)                                             \
-  free_meta_block->next_block->prev_block = free_meta_block
+  free_meta_block->prev_offset = allocated_meta_block->offset;                 \
+  free_meta_block->prev_free = allocated_meta_block->is_free;                  \
+  free_meta_block->next_offset = allocated_meta_block->next_offset;            \
+  allocated_meta_block->next_offset = free_meta_block->offset;                 \
+  MM_BLOCK_TAG_NEXT(free_meta_block)
 
 /**
  * @brief Macro to calculate the maximum allocatable memory for a given number
@@ -652,45 +1179,154 @@ static void mm_union_free_blocks(block_meta_data_t *first,
 static inline uint32_t mm_max_page_allocatable_memory(int units);
 
 /**
- * @brief Comparison function for sorting free blocks by block size.
+ * @brief Rounds a request size up to the size of the data block serving it.
  *
- * This function compares two block_meta_data_t objects based on their block
- * sizes. It is intended to be used as a comparison function for sorting free
- * blocks in descending order of block size.
+ * Blocks are at least `MM_MIN_BLOCK_SIZE` bytes, and a block plus the
+ * metadata block after it spans a multiple of the family's alignment, so
+ * that the application data of the next block stays aligned too.
  *
- * @param _block_meta_data1 Pointer to the first block_meta_data_t object.
- * @param _block_meta_data2 Pointer to the second block_meta_data_t object.
- * @return An integer value representing the result of the comparison:
- *         - If the block size of _block_meta_data1 is greater than that of
- * _block_meta_data2, the function returns -1.
- *         - If the block size of _block_meta_data1 is less than that of
- * _block_meta_data2, the function returns 1.
- *         - If the block sizes are equal, the function returns 0.
+ * @param vm_page_family Pointer to the page family of the block.
+ * @param size Size of the request in bytes, at most `MM_MAX_BLOCK_SIZE`.
+ * @return Size of the data block.
  */
-static int free_blocks_comparison_function(void *_block_meta_data1,
-                                           void *_block_meta_data2);
+static inline uint32_t mm_block_size_round(vm_page_family_t *vm_page_family,
+                                           uint32_t size);
 
 /**
- * @brief Retrieves the metadata of the biggest free memory block within a given
- * virtual memory page family.
+ * @brief Allocates an object whose address is a multiple of `alignment`.
+ *
+ * Alignments the family already guarantees take the regular allocation
+ * path. Otherwise a block with `alignment` bytes of slack is allocated, the
+ * part in front of the aligned address is split off and freed, and so is
+ * the tail past the object.
+ *
+ * @param vm_page_family Pointer to the page family.
+ * @param units Number of structures to allocate.
+ * @param alignment Requested alignment, a power of two.
+ * @param zero Whether the returned object must be zeroed.
+ * @return Pointer to the application data, or NULL on failure.
+ */
+static void *mm_xalloc_aligned(vm_page_family_t *vm_page_family, int units,
+                               uint32_t alignment, vm_bool_t zero);
+
+/**
+ * @brief Takes the next free page family slot for a new structure.
+ *
+ * Must be called with `mm_registry_lock` held. The slot is initialized but
+ * stays invisible to lookups and walks until `mm_publish_page_family()`, so
+ * the caller can finish setting the page family up first.
  *
- * This function retrieves the metadata of the biggest free memory block within
- * a specified virtual memory page family. It utilizes a priority list to
- * maintain the biggest free block at the head of the list.
+ * @param struct_name The name of the memory structure.
+ * @return Pointer to the initialized page family, or NULL if no families page
+ * could be allocated.
+ */
+static vm_page_family_t *mm_reserve_page_family(char *struct_name);
+
+/**
+ * @brief Initializes a page family slot, except for its size.
  *
- * @param vm_page_family Pointer to the virtual memory page family for which the
- * biggest free block is to be retrieved.
+ * @param vm_page_family Pointer to the unused page family slot.
+ * @param struct_name The name of the memory structure.
+ * @return Pointer to the initialized page family.
+ */
+static vm_page_family_t *mm_init_page_family(vm_page_family_t *vm_page_family,
+                                             char *struct_name);
+
+/**
+ * @brief Sets the size of a reserved page family and indexes it by name.
  *
- * @return Pointer to the metadata of the biggest free memory block within the
- * page family. If no such block exists (i.e., the priority list is empty), it
- * returns NULL.
+ * Must be called with `mm_registry_lock` held, once the page family is fully
+ * set up: the release stores let lock-free readers use it as soon as they
+ * find it.
  *
- * @note This function is typically used in memory management systems to
- * efficiently locate the largest available free block within a page family,
- * which can then be used for memory allocation.
+ * @param vm_page_family Pointer to the reserved page family.
+ * @param struct_size The size of the memory structure.
+ */
+static void mm_publish_page_family(vm_page_family_t *vm_page_family,
+                                   uint32_t struct_size);
+
+/**
+ * @brief Returns the first families page, for walks of the registry.
+ *
+ * @return The most recently added families page, or NULL.
+ */
+static inline vm_page_for_families_t *mm_first_families_page(void);
+
+/**
+ * @brief Hashes a struct name for the page family hash index.
+ *
+ * Only the first `MM_MAX_STRUCT_NAME` characters are significant, matching
+ * the length stored in `vm_page_family_t`.
+ *
+ * @param struct_name The name of the memory structure.
+ * @return 32-bit FNV-1a hash of the name.
+ */
+static inline uint32_t mm_family_name_hash(const char *struct_name);
+
+/**
+ * @brief Maps a block size to the index of its free block bin.
+ *
+ * @param size Size of the data region of a block.
+ * @return Index of the bin, in the range [0, MM_FREE_BINS).
+ */
+static inline uint32_t mm_free_bin_index(uint32_t size);
+
+/**
+ * @brief Initializes the free block bins of a page family.
+ *
+ * @param vm_page_family Pointer to the page family.
+ */
+static void mm_init_free_bins(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Gives a page family its free block bins.
+ *
+ * The bins are carved out of shared pages rather than embedded in the page
+ * family, which keeps the families pages dense. Slab and large object only
+ * families never get any.
+ *
+ * @param vm_page_family Pointer to the page family, whose lock is held.
+ * @return MM_TRUE if the family has bins, MM_FALSE if no page could be
+ * mapped for them.
+ */
+static vm_bool_t mm_allocate_free_bins(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Finds a free block able to hold a request within a page family.
+ *
+ * The head of the request's own bin is taken if it is large enough;
+ * otherwise the bitmap yields the first non-empty bin holding larger sizes,
+ * whose head is guaranteed to fit. Only the last, open-ended bin has to be
+ * walked. Families with another placement policy are served by
+ * `mm_get_free_block_by_policy()`.
+ *
+ * @param vm_page_family Pointer to the virtual memory page family to search.
+ * @param req_size Size of the request in bytes.
+ *
+ * @return Pointer to the metadata of a free block of at least `req_size`
+ * bytes, or NULL if the page family has none.
  */
 static inline block_meta_data_t *
-mm_get_biggest_free_block_page_family(vm_page_family_t *vm_page_family);
+mm_get_free_block_for_size(vm_page_family_t *vm_page_family,
+                           uint32_t req_size);
+
+/**
+ * @brief Finds a free block for a request by walking the free bins, for the
+ * placement policies other than `MM_PLACEMENT_SEGREGATED`.
+ *
+ * Only the bins that may hold a large enough block are walked: all of them
+ * for first and next fit, up to the first one with a fitting block for best
+ * fit, and the highest one for worst fit. The caller must hold the family
+ * lock.
+ *
+ * @param vm_page_family Pointer to the virtual memory page family to search.
+ * @param req_size Size of the request in bytes.
+ * @return Pointer to the metadata of the chosen free block, or NULL if the
+ * page family has none large enough.
+ */
+static block_meta_data_t *
+mm_get_free_block_by_policy(vm_page_family_t *vm_page_family,
+                            uint32_t req_size);
 
 /**
  * @brief Splits a free data block to allocate a portion of it for memory
@@ -734,6 +1370,8 @@ mm_split_free_data_block_for_allocation(vm_page_family_t *vm_page_family,
  * @param vm_page_family Pointer to the page family from which to allocate the
  * data block.
  * @param req_size The size of the data block to allocate.
+ * @param dirty_size Receives the number of bytes at the start of the block
+ * that may hold stale data; the rest of the block is known to be zero.
  *
  * @return A pointer to the allocated block's metadata if successful, or NULL if
  * the allocation fails.
@@ -746,7 +1384,7 @@ mm_split_free_data_block_for_allocation(vm_page_family_t *vm_page_family,
  */
 static block_meta_data_t *
 mm_allocate_free_data_block(vm_page_family_t *vm_page_family,
-                            uint32_t req_size);
+                            uint32_t req_size, uint32_t *dirty_size);
 /**
  * @brief Adds a new virtual memory page to the specified page family.
  *
@@ -803,4 +1441,827 @@ static int mm_get_hard_internal_memory_frag_size(block_meta_data_t *first,
  */
 static block_meta_data_t *mm_free_blocks(block_meta_data_t *to_be_free_block);
 
+/**
+ * @brief Maps a multi-page span hosting a single large object.
+ *
+ * Requests that do not fit in a single virtual memory page get their own span
+ * of contiguous system pages, laid out as a `vm_page_t` whose only block
+ * covers the whole span. The span is linked into the family's
+ * `first_large_page` list. A span of the same size retained by the large
+ * span pool is reused first. When huge pages are enabled and the span is at
+ * least `MM_HUGE_PAGE_SIZE` bytes, `MAP_HUGETLB` is tried first.
+ *
+ * @param vm_page_family Pointer to the page family the object belongs to.
+ * @param req_size Size of the request in bytes.
+ * @param dirty_size Receives the number of bytes at the start of the data
+ * that may not be zero, 0 for a freshly mapped span.
+ * @return Pointer to the metadata of the allocated block, or NULL if the
+ * mapping fails.
+ */
+static block_meta_data_t *
+mm_allocate_large_block(vm_page_family_t *vm_page_family, uint32_t req_size,
+                        uint32_t *dirty_size);
+
+/**
+ * @brief Unlinks a large object span from its family and gives it to the
+ * large span pool, or unmaps it.
+ *
+ * @param vm_page Pointer to the span, whose `page_kind` is `MM_PAGE_LARGE`.
+ */
+static void mm_free_large_block(vm_page_t *vm_page);
+
+/**
+ * @brief Shrinks an allocated block, returning its tail to the free blocks.
+ *
+ * A tail too small to hold a free block is left behind the block as hard
+ * internal fragmentation. The caller must hold the family lock.
+ *
+ * @param block_meta_data Pointer to the metadata of the allocated block.
+ * @param size New size of the block, at most its current size.
+ */
+static void mm_block_shrink_locked(block_meta_data_t *block_meta_data,
+                                   uint32_t size);
+
+/**
+ * @brief Resizes an allocated block without moving it.
+ *
+ * Growing absorbs the hard internal fragmentation behind the block and the
+ * free block that follows it, if any. The caller must hold the family lock.
+ *
+ * @param vm_page_family Pointer to the page family of the block.
+ * @param block_meta_data Pointer to the metadata of the allocated block.
+ * @param size New size of the block, rounded with `mm_block_size_round()`.
+ * @return MM_TRUE if the block was resized, MM_FALSE if there is not enough
+ * room behind it.
+ */
+static vm_bool_t mm_block_resize_locked(vm_page_family_t *vm_page_family,
+                                        block_meta_data_t *block_meta_data,
+                                        uint32_t size);
+
+/**
+ * @brief Resizes a large object span.
+ *
+ * The span keeps its pages when the object shrinks or still fits, so that
+ * the object can grow back into them until it is freed or `mm_trim()` runs.
+ * Growing past the span takes at least half as many pages again, rounded
+ * with `mm_large_span_units()`: a span of that size retained by the large
+ * span pool receives a copy of the object, otherwise the span is remapped
+ * with `mremap()`, which may move it. The family's span list is updated
+ * either way.
+ *
+ * @param vm_page Pointer to the span, whose `page_kind` is `MM_PAGE_LARGE`.
+ * @param req_size New size of the object, larger than a single page holds.
+ * @return Pointer to the application data, or NULL if the span could not
+ * be resized.
+ */
+static void *mm_large_block_resize(vm_page_t *vm_page, uint32_t req_size);
+
+/**
+ * @brief Allocates up to `count` blocks of the same size.
+ *
+ * Each free block found is taken off its bin once and carved into as many
+ * blocks as it holds, back to back; only the final remainder goes back to a
+ * bin. The caller must hold the family lock.
+ *
+ * @param vm_page_family Pointer to the page family.
+ * @param size Size of each block, rounded with `mm_block_size_round()`.
+ * @param objects Receives the application data of the blocks.
+ * @param dirty_sizes Receives the number of bytes of each block that may be
+ * dirty, as returned by `mm_block_claim_dirty_size()`.
+ * @param count Number of blocks wanted.
+ * @return Number of blocks allocated, less than `count` only when the
+ * kernel refused to map a page.
+ */
+static uint32_t mm_allocate_blocks_locked(vm_page_family_t *vm_page_family,
+                                          uint32_t size, void **objects,
+                                          uint32_t *dirty_sizes,
+                                          uint32_t count);
+
+/**
+ * @brief Orders two object pointers by address, for `qsort()`.
+ *
+ * @param a Pointer to the first object pointer.
+ * @param b Pointer to the second object pointer.
+ * @return Negative, zero or positive as the first object lies below, at or
+ * above the second.
+ */
+static int mm_compare_addresses(const void *a, const void *b);
+
+/**
+ * @brief Frees a chunk of objects sorted by address.
+ *
+ * Objects whose blocks are next to each other in a page are merged into a
+ * single block first, so that the whole run is freed, coalesced and
+ * inserted into a bin once. Family locks are only switched when the family
+ * changes from one object to the next.
+ *
+ * @param objects Application data of the objects, in increasing address
+ * order.
+ * @param count Number of objects.
+ */
+static void mm_free_sorted_chunk(void **objects, uint32_t count);
+
+/**
+ * @brief Counts allocations and frees made by the calling thread.
+ *
+ * The counts are kept in the thread's cache and added to the global counters
+ * every `MM_STATS_PUBLISH_BATCH` operations, so the hot paths do not share a
+ * cache line between threads.
+ *
+ * @param allocs Number of objects allocated.
+ * @param frees Number of objects freed.
+ */
+static inline void mm_stats_count_ops(uint32_t allocs, uint32_t frees);
+
+/**
+ * @brief Adds the calling thread's pending allocation and free counts to the
+ * global counters.
+ */
+static void mm_stats_publish_ops(void);
+
+/**
+ * @brief Returns the size of the largest free block of a page family.
+ *
+ * Only the highest non-empty free bin is walked. The caller must hold the
+ * family lock.
+ *
+ * @param vm_page_family Pointer to the page family.
+ * @return Size of the largest free block, or 0 if there is none.
+ */
+static uint32_t mm_largest_free_block_locked(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Opens the destination of the statistics dump.
+ *
+ * @param path File to append to, or `unix:` followed by the path of a Unix
+ * stream socket to connect to.
+ * @return File descriptor, or -1 on failure.
+ */
+static int mm_stats_dump_open(const char *path);
+
+/**
+ * @brief Body of the statistics dump thread.
+ *
+ * Writes one JSON line of `mm_get_stats()` counters per interval until
+ * `mm_stats_dump_stop()` is called. A socket whose peer went away is
+ * reconnected on the next interval.
+ *
+ * @param arg Unused.
+ * @return Always NULL.
+ */
+static void *mm_stats_dump_thread(void *arg);
+
+/**
+ * @brief Hashes an object address for the heap profiler tables.
+ *
+ * @param app_data The object address.
+ * @return The hash.
+ */
+static inline uint32_t mm_profile_address_hash(void *app_data);
+
+/**
+ * @brief Accounts an allocation to the heap profiler.
+ *
+ * Costs a load and a branch while profiling is off. Otherwise the object's
+ * size is taken off the calling thread's countdown, and the object is
+ * sampled once it runs out.
+ *
+ * @param app_data The allocated object.
+ * @param size Its size.
+ */
+static inline void mm_profile_alloc_hook(void *app_data, uint32_t size);
+
+/**
+ * @brief Tells the heap profiler that an object is being freed.
+ *
+ * Only objects whose address hashes to a non-zero `filter` counter are
+ * looked up under the profiler lock.
+ *
+ * @param app_data The object being freed.
+ */
+static inline void mm_profile_free_hook(void *app_data);
+
+/**
+ * @brief Records a sampled object and its call stack, then draws the
+ * calling thread's next countdown.
+ *
+ * Must be called after every allocator lock is released, since capturing
+ * the stack may allocate the first time. The frames of the functions placed
+ * in the `MM_ALLOC_TEXT` section, its own included, are left out of the
+ * recorded stack.
+ *
+ * @param app_data The sampled object.
+ * @param size Its size.
+ */
+static void mm_profile_record(void *app_data, uint32_t size)
+    __attribute__((noinline));
+
+/**
+ * @brief Removes a freed object from the live samples, if it is one.
+ *
+ * @param app_data The object being freed.
+ */
+static void mm_profile_forget(void *app_data);
+
+/**
+ * @brief Inserts a live sample. The caller must hold `mm_profile_lock`.
+ *
+ * @param app_data The sampled object.
+ * @param site Index of the site that allocated it.
+ * @param size Its size.
+ * @param estimate Bytes it stands for.
+ */
+static void mm_profile_insert_locked(void *app_data, uint32_t site,
+                                     uint32_t size, uint64_t estimate);
+
+/**
+ * @brief Moves the live sample of an object relocated by the compactor, if
+ * it is one.
+ *
+ * @param old_app_data Previous address of the object.
+ * @param new_app_data Its new address.
+ */
+static void mm_profile_move(void *old_app_data, void *new_app_data);
+
+/**
+ * @brief Returns the site recording a call stack, creating it if needed.
+ *
+ * The caller must hold `mm_profile_lock`.
+ *
+ * @param stack Return addresses, innermost first.
+ * @param depth Number of return addresses.
+ * @return Index of the site, or -1 if the site table is full.
+ */
+static int mm_profile_site_get_locked(void **stack, uint32_t depth);
+
+/**
+ * @brief Writes out the bytes pending in a profile writer.
+ *
+ * @param writer The profile writer.
+ */
+static void mm_profile_flush(mm_profile_writer_t *writer);
+
+/**
+ * @brief Appends formatted text to a profile writer, flushing it as it
+ * fills up.
+ *
+ * @param writer The profile writer.
+ * @param format printf() format of the text.
+ */
+static void mm_profile_printf(mm_profile_writer_t *writer, const char *format,
+                              ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Writes the name of the function holding a return address.
+ *
+ * Exported symbols are written by name, anything else as the object file
+ * name and the offset within it.
+ *
+ * @param writer The profile writer.
+ * @param address The return address.
+ */
+static void mm_profile_print_frame(mm_profile_writer_t *writer, void *address);
+
+/**
+ * @brief Counts the NUMA nodes of the machine from sysfs.
+ *
+ * Reads `/sys/devices/system/node/online` without going through stdio, which
+ * may allocate. Machines without that file, or with a single node, leave
+ * NUMA support disabled.
+ */
+static void mm_numa_init(void);
+
+/**
+ * @brief Returns the NUMA node the calling thread runs on.
+ *
+ * The node is looked up with `getcpu()` every `MM_NUMA_REFRESH_OPS` calls and
+ * cached in the thread cache in between.
+ *
+ * @return Node number, below `MM_NUMA_MAX_NODES`.
+ */
+static inline uint32_t mm_numa_current_node(void);
+
+/**
+ * @brief Returns the family serving a page family on the calling thread's
+ * NUMA node.
+ *
+ * @param vm_page_family Pointer to a page family, as registered or as found
+ * from an object.
+ * @return The family of the current node, or `vm_page_family` itself when
+ * NUMA support is disabled.
+ */
+static inline vm_page_family_t *
+mm_numa_family(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Registers the family serving a page family on another NUMA node.
+ *
+ * The new family copies the layout settings of its parent and is named
+ * after it with a `@<node>` suffix.
+ *
+ * @param vm_page_family Pointer to the parent page family.
+ * @param node NUMA node, not 0.
+ * @return The family of the node, or NULL if it could not be registered.
+ */
+static vm_page_family_t *mm_numa_family_create(vm_page_family_t *vm_page_family,
+                                               uint32_t node);
+
+/**
+ * @brief Asks the kernel to back a new mapping with memory of a NUMA node,
+ * and counts its pages for the node.
+ *
+ * Must be called before the mapping is first touched. Failures, e.g. from a
+ * kernel built without NUMA support, leave the default first-touch policy.
+ *
+ * @param addr Start of the mapping.
+ * @param size Length of the mapping.
+ * @param node NUMA node.
+ */
+static void mm_numa_bind(void *addr, size_t size, uint32_t node);
+
+/**
+ * @brief Returns the bytes of a page family's pages taken by live objects.
+ *
+ * The caller must hold the family lock.
+ *
+ * @param vm_page_family Pointer to the page family.
+ * @return Bytes of the data pages outside the free blocks, plus the slab
+ * slots handed out.
+ */
+static inline uint64_t
+mm_family_bytes_in_use_locked(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Computes the absolute deadline of a timed wait.
+ *
+ * @param deadline Receives the `CLOCK_REALTIME` time `interval_ms` from now.
+ * @param interval_ms Delay in milliseconds.
+ */
+static void mm_deadline_after_ms(struct timespec *deadline,
+                                 uint32_t interval_ms);
+
+/**
+ * @brief Registers the slab family holding the handles of movable objects.
+ */
+static void mm_handle_family_create(void);
+
+/**
+ * @brief Allocates a block for an object moved by the compactor.
+ *
+ * Unlike `mm_allocate_free_data_block()`, this never maps a new page and
+ * skips the free blocks of pages being evacuated. The caller must hold the
+ * family lock.
+ *
+ * @param vm_page_family Pointer to the movable page family.
+ * @param req_size Block size of the object.
+ * @return Metadata of the allocated block, or NULL if no other page has room.
+ */
+static block_meta_data_t *
+mm_compact_alloc_locked(vm_page_family_t *vm_page_family, uint32_t req_size);
+
+/**
+ * @brief Moves one movable object out of its page.
+ *
+ * The caller must hold the family lock. The old block is freed, which may
+ * release its page.
+ *
+ * @param vm_page_family Pointer to the movable page family.
+ * @param block_meta_data Metadata of the object's block.
+ * @return 1 if the object was moved, 0 if it is pinned, -1 if no other page
+ * has room for it.
+ */
+static int mm_movable_block_move_locked(vm_page_family_t *vm_page_family,
+                                        block_meta_data_t *block_meta_data);
+
+/**
+ * @brief Returns the share of a movable family's page memory that is free.
+ *
+ * @param vm_page_family Pointer to the movable page family.
+ * @return Percentage of the family's data page memory in free blocks.
+ */
+static uint32_t mm_family_free_percent(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Body of the compactor thread.
+ *
+ * Every interval, compacts each movable page family whose free share
+ * reached the threshold, a few pages at a time, until
+ * `mm_compactor_stop()` is called.
+ *
+ * @param arg Unused.
+ * @return Always NULL.
+ */
+static void *mm_compactor_thread(void *arg);
+
+/**
+ * @brief Reads the checks of the debug mode from the `HMM_DEBUG` environment
+ * variable, a comma separated list of `canary`, `poison`, `guard`,
+ * `validate` or `all`.
+ */
+static void mm_debug_init(void);
+
+/**
+ * @brief Allocates an object in the debug mode.
+ *
+ * The object gets a block of its own followed by a trailer, or a guarded
+ * span, and bypasses the thread cache and slab pages.
+ *
+ * @param vm_page_family Pointer to the page family serving the thread.
+ * @param req_size Size of the object.
+ * @param zero Whether the object must be cleared.
+ * @param alignment Alignment of the object, 0 for the family's.
+ * @return Pointer to the object, or NULL on failure.
+ */
+static void *mm_debug_alloc(vm_page_family_t *vm_page_family,
+                            uint32_t req_size, vm_bool_t zero,
+                            uint32_t alignment);
+
+/**
+ * @brief Maps a span for one object that ends right before a `PROT_NONE`
+ * guard page.
+ *
+ * The page header lives in the system page holding the first byte of the
+ * object; its block's `block_size` is the object size and its `prev_offset`
+ * the number of system pages in front of the header.
+ *
+ * @param vm_page_family Pointer to the page family serving the thread.
+ * @param req_size Size of the object.
+ * @param alignment Alignment of the object, 0 for the family's.
+ * @return Pointer to the object, cleared, or NULL on failure.
+ */
+static void *mm_debug_alloc_guarded(vm_page_family_t *vm_page_family,
+                                    uint32_t req_size, uint32_t alignment);
+
+/**
+ * @brief Verifies and frees an object allocated in the debug mode.
+ *
+ * @param app_data Pointer to the object.
+ */
+static void mm_debug_free(void *app_data);
+
+/**
+ * @brief Moves an object allocated in the debug mode to a new block.
+ *
+ * Objects are never resized in place, so that each keeps a trailer right
+ * after its end.
+ *
+ * @param app_data Pointer to the object.
+ * @param req_size New size of the object.
+ * @return Pointer to the moved object, or NULL on failure.
+ */
+static void *mm_debug_realloc(void *app_data, uint32_t req_size);
+
+/**
+ * @brief Returns the size requested for an object allocated in the debug
+ * mode.
+ *
+ * @param app_data Pointer to the object.
+ * @return Size of the object in bytes.
+ */
+static uint32_t mm_debug_object_size(void *app_data);
+
+/**
+ * @brief Writes the trailer and canary bytes of a block allocated in the
+ * debug mode.
+ *
+ * @param block_meta_data Metadata of the block.
+ * @param req_size Size of the object.
+ */
+static void mm_debug_trailer_set(block_meta_data_t *block_meta_data,
+                                 uint32_t req_size);
+
+/**
+ * @brief Verifies the trailer and canary bytes of an allocated block.
+ *
+ * @param block_meta_data Metadata of the block.
+ */
+static void mm_debug_trailer_check(block_meta_data_t *block_meta_data);
+
+/**
+ * @brief Verifies a block met in a page walk: its offset, its bounds, the
+ * link back from the next block and, when allocated, its trailer.
+ *
+ * @param vm_page Pointer to the virtual memory page of the block.
+ * @param block_meta_data Metadata of the block.
+ */
+static void mm_debug_check_block(vm_page_t *vm_page,
+                                 block_meta_data_t *block_meta_data);
+
+/**
+ * @brief Walks the block chain of a page so that each block is verified.
+ *
+ * The caller must hold the family lock.
+ *
+ * @param vm_page Pointer to the virtual memory page.
+ */
+static void mm_debug_validate_page_locked(vm_page_t *vm_page);
+
+/**
+ * @brief Reports a corruption found by the debug mode and aborts.
+ *
+ * @param app_data Address of the corrupted object.
+ * @param what Description of the corruption.
+ */
+static void mm_debug_report(void *app_data, const char *what)
+    __attribute__((noreturn));
+
+/**
+ * @brief Takes an empty page from the page retention pool.
+ *
+ * The family's own pool is tried first, then the pool shared by all
+ * families; a new page is only mapped from the kernel when both are empty.
+ * The caller must hold the family lock.
+ *
+ * @param vm_page_family Pointer to the page family that needs a page, or NULL
+ * for a page that belongs to no family, which only uses the global pool.
+ * @return Pointer to the page, or NULL if the kernel refused to map one.
+ */
+static vm_page_t *mm_page_pool_acquire(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Gives an empty page back to the page retention pool.
+ *
+ * The page is kept by its family while the family pool is below its limit,
+ * then by the global pool; once both are at their high-water mark the page
+ * is unmapped. The caller must hold the family lock of the page, if any.
+ *
+ * @param vm_page Pointer to the empty page, already unlinked from its family.
+ */
+static void mm_page_pool_release(vm_page_t *vm_page);
+
+/**
+ * @brief Unmaps retained pages until the pools are down to the given sizes.
+ *
+ * @param family_keep Number of pages each family pool may keep.
+ * @param global_keep Number of pages the global pool may keep.
+ * @return Number of pages returned to the kernel.
+ */
+static uint32_t mm_page_pool_trim_to(uint32_t family_keep,
+                                     uint32_t global_keep);
+
+/**
+ * @brief Takes a retained large object span of at least the given size.
+ *
+ * Spans mapped for the same NUMA node from `units` pages up to the next size
+ * of `mm_large_span_units()` are reused; the span's `units` tells its actual
+ * size.
+ *
+ * @param node NUMA node the span must belong to.
+ * @param units Number of system pages the span needs.
+ * @param dirty_size Receives the number of bytes of the span's data, all of
+ * which the previous object may have written.
+ * @return Pointer to the span, or NULL if none is retained.
+ */
+static vm_page_t *mm_large_span_pool_acquire(uint32_t node, uint32_t units,
+                                             uint32_t *dirty_size);
+
+/**
+ * @brief Keeps a large object span for reuse instead of unmapping it.
+ *
+ * Spans backed by huge pages, spans above `MM_LARGE_SPAN_POOL_MAX_UNITS`
+ * pages and spans that would take the pool of their node past its limit are
+ * refused.
+ *
+ * @param vm_page Pointer to the span, already unlinked from its family.
+ * @return MM_TRUE if the span was retained, MM_FALSE if the caller must
+ * unmap it.
+ */
+static vm_bool_t mm_large_span_pool_release(vm_page_t *vm_page);
+
+/**
+ * @brief Rounds the size of a large object span up to the sizes the large
+ * span pool keeps.
+ *
+ * Spans of up to `MM_LARGE_SPAN_POOL_MAX_UNITS` pages come in four sizes per
+ * power of two above 4 pages, so that a freed span fits later requests of
+ * about the same size at the cost of at most a quarter of its pages, which
+ * are only touched if the object grows into them.
+ *
+ * @param units Number of system pages the object needs.
+ * @return Number of system pages to map.
+ */
+static uint32_t mm_large_span_units(uint32_t units);
+
+/**
+ * @brief Returns the pages past the end of every large object to the kernel.
+ *
+ * @return Number of pages unmapped.
+ */
+static uint32_t mm_large_span_trim_tails(void);
+
+/**
+ * @brief Advances the zero watermark of a page past a newly allocated block.
+ *
+ * Bytes of the block below the page's `zero_watermark` may have been used
+ * before; the others are still as the kernel mapped them. The watermark is
+ * moved past the block and the metadata that a split may have written right
+ * after it. The caller must hold the family lock.
+ *
+ * @param block_meta_data Pointer to the metadata of the allocated block.
+ * @return Number of bytes at the start of the block that may be dirty.
+ */
+static uint32_t mm_block_claim_dirty_size(block_meta_data_t *block_meta_data);
+
+/**
+ * @brief Advances the zero watermark of a page past a byte range.
+ *
+ * @param vm_page Pointer to the page.
+ * @param start Offset of the first byte of the range within the page.
+ * @param end Offset right past the range.
+ * @return Number of bytes at the start of the range that may be dirty.
+ */
+static uint32_t mm_vm_page_claim_range(vm_page_t *vm_page, uint32_t start,
+                                       uint32_t end);
+
+/**
+ * @brief Takes a page for an arena from the page retention pool.
+ *
+ * @return Pointer to the page, marked as `MM_PAGE_ARENA`, or NULL if no page
+ * could be mapped.
+ */
+static vm_page_t *mm_arena_page_acquire();
+
+/**
+ * @brief Maps a dedicated span for an arena object larger than a page.
+ *
+ * The span is linked into the arena's `first_large_page` list and unmapped
+ * when the arena is reset or destroyed.
+ *
+ * @param arena Pointer to the arena.
+ * @param size Size of the object in bytes.
+ * @return Pointer to the object, or NULL if the span could not be mapped.
+ */
+static void *mm_arena_alloc_large(mm_arena_t *arena, uint32_t size);
+
+/**
+ * @brief Takes a free slot from the slab pages of a page family.
+ *
+ * A slot is popped from the family's first partially used slab page; a new
+ * slab page is taken from the page retention pool when there is none. The
+ * caller must hold the family lock.
+ *
+ * @param vm_page_family Pointer to a page family in slab mode.
+ * @param dirty_size Receives the number of bytes at the start of the slot
+ * that may hold stale data.
+ * @return Pointer to the slot, or NULL if no page could be mapped.
+ */
+static void *mm_slab_alloc_locked(vm_page_family_t *vm_page_family,
+                                  uint32_t *dirty_size);
+
+/**
+ * @brief Gives a slot back to its slab page.
+ *
+ * A page that becomes empty goes back to the page retention pool. The caller
+ * must hold the family lock.
+ *
+ * @param vm_page Pointer to the slab page hosting the slot.
+ * @param app_data Pointer to the slot.
+ */
+static void mm_slab_free_locked(vm_page_t *vm_page, void *app_data);
+
+/**
+ * @brief Moves a slab page from one of its family's page lists to another.
+ *
+ * @param vm_page Pointer to the slab page.
+ * @param from Head of the list the page is on.
+ * @param to Head of the list the page goes to, or NULL to only unlink it.
+ */
+static void mm_slab_page_move(vm_page_t *vm_page, vm_page_t **from,
+                              vm_page_t **to);
+
+/**
+ * @brief Adds the slots of a list of slab pages to block usage counters.
+ *
+ * Every slot counts as a block; slots carry no metadata so the application
+ * memory usage of an occupied slot is the slot size.
+ *
+ * @param vm_page First slab page of the list.
+ * @param total_block_count Counter of all blocks.
+ * @param free_block_count Counter of free blocks.
+ * @param occupied_block_count Counter of occupied blocks.
+ * @param application_memory_usage Counter of the memory used by occupied
+ * blocks, in bytes.
+ */
+static void mm_slab_block_usage(vm_page_t *vm_page,
+                                uint32_t *total_block_count,
+                                uint32_t *free_block_count,
+                                uint32_t *occupied_block_count,
+                                uint32_t *application_memory_usage);
+
+/**
+ * @brief Allocates a data block of the given size from a page family.
+ *
+ * This function is the common back end of all allocation entry points once
+ * the page family and the request size are known. Requests of exactly one
+ * unit of the family are served from the calling thread's cache; everything
+ * else takes the family lock and goes through
+ * `mm_allocate_free_data_block()`. When zeroing is requested, only the bytes
+ * not known to be zero are cleared.
+ *
+ * @param vm_page_family Pointer to the page family to allocate from.
+ * @param req_size Size of the request in bytes.
+ * @param zero Whether the returned memory must be zeroed.
+ * @return Pointer to the application data, or NULL if the allocation fails.
+ */
+static void *mm_xcalloc_from_family(vm_page_family_t *vm_page_family,
+                                    uint32_t req_size, vm_bool_t zero);
+
+/**
+ * @brief Resolves a structure name and allocates memory for it.
+ *
+ * Shared by `xcalloc()` and `xmalloc()`: registered names are looked up
+ * directly, anything else is parsed as a datatype or a byte count and
+ * registered on first use.
+ *
+ * @param struct_name The name of the structure, datatype or size.
+ * @param units The number of structures to allocate.
+ * @param zero Whether the returned memory must be zeroed.
+ * @return Pointer to the application data, or NULL if the allocation fails.
+ */
+static void *mm_xalloc_by_name(char *struct_name, int units, vm_bool_t zero);
+
+/**
+ * @brief Checks a page family handle and allocates memory from it.
+ *
+ * Shared by `xcalloc_family()` and `xmalloc_family()`.
+ *
+ * @param vm_page_family Pointer to the page family, may be NULL.
+ * @param units The number of structures to allocate.
+ * @param zero Whether the returned memory must be zeroed.
+ * @return Pointer to the application data, or NULL if the allocation fails.
+ */
+static void *mm_xalloc_by_family(vm_page_family_t *vm_page_family, int units,
+                                 vm_bool_t zero);
+
+/**
+ * @brief Returns the calling thread's cache bin for a page family.
+ *
+ * The first call on a thread registers the thread cache with a
+ * `pthread_key_t` destructor so that cached objects are returned to their
+ * families when the thread exits.
+ *
+ * @param vm_page_family Pointer to the page family.
+ * @return Pointer to the bin, or NULL if the thread cache is disabled, the
+ * family has no bin or the calling thread is exiting and its cache was
+ * already flushed.
+ */
+static mm_thread_cache_bin_t *
+mm_thread_cache_get_bin(vm_page_family_t *vm_page_family);
+
+/**
+ * @brief Pops a single-unit object from the calling thread's cache.
+ *
+ * When the bin is empty it is refilled with up to `MM_TCACHE_BATCH` objects
+ * taken from the page family under a single acquisition of the family lock.
+ *
+ * @param bin Pointer to the thread cache bin.
+ * @param zero Whether the returned object must be zeroed.
+ * @return Pointer to the application data, or NULL if the family is out of
+ * memory.
+ */
+static void *mm_thread_cache_alloc(mm_thread_cache_bin_t *bin,
+                                   vm_bool_t zero);
+
+/**
+ * @brief Pushes a single-unit object into the calling thread's cache.
+ *
+ * When the bin is full, the `MM_TCACHE_BATCH` oldest objects are returned to
+ * the page family under a single acquisition of the family lock first. The
+ * object is tagged with `MM_TCACHE_KEY`; an object freed while it already
+ * carries the key is looked up in the bin, and found there, fails an
+ * assertion instead of being handed out twice.
+ *
+ * @param bin Pointer to the thread cache bin.
+ * @param app_data Pointer to the application data being freed.
+ */
+static void mm_thread_cache_free(mm_thread_cache_bin_t *bin, void *app_data);
+
+/**
+ * @brief Returns objects of a thread cache bin to the page family.
+ *
+ * The caller must hold the family lock of the bin's page family.
+ *
+ * @param bin Pointer to the thread cache bin.
+ * @param count Number of objects to return, taken from the bottom of the bin.
+ */
+static void mm_thread_cache_release_locked(mm_thread_cache_bin_t *bin,
+                                           uint32_t count);
+
+/**
+ * @brief Creates the key whose destructor flushes exiting threads' caches.
+ *
+ * Invoked exactly once through `pthread_once()`.
+ */
+static void mm_thread_cache_key_create(void);
+
+/**
+ * @brief Destructor of `mm_thread_cache_key`, run when a thread exits.
+ *
+ * Flushes the thread's cache and marks it torn down, so that the thread's
+ * remaining frees and allocations bypass it.
+ *
+ * @param arg Value bound to the key, unused.
+ */
+static void mm_thread_cache_destructor(void *arg);
+
 #endif /**< MM_H_ */
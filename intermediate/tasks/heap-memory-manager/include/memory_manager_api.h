@@ -21,6 +21,159 @@
 //-----------------< Includes section -----------------/
 #include <stdint.h>
 
+//-----------------< Macros section -----------------/
+/**
+ * @brief Largest alignment of a page family, which is the offset of the
+ * first application data within a page.
+ */
+#define MM_MAX_FAMILY_ALIGNMENT 64
+
+/**
+ * @brief Places a function on the allocation path in the section whose
+ * frames the heap profiler trims from the stacks it samples.
+ *
+ * Wrappers of the allocation functions, like the `malloc()` replacement,
+ * mark their own entry points with it so that samples are attributed to
+ * their callers rather than to the wrappers.
+ */
+#define MM_ALLOC_TEXT __attribute__((section("mm_alloc_text")))
+
+/**
+ * @brief Checks of the debug mode, combined into the flags of
+ * `mm_set_debug_flags()` or named in the `HMM_DEBUG` environment variable.
+ *
+ * - `MM_DEBUG_CANARY` ("canary"): bytes past the end of each object are
+ *   filled with a canary that is verified when the object is freed.
+ * - `MM_DEBUG_POISON` ("poison"): objects are filled with `0xAA` when
+ *   allocated uninitialized and with `0xDD` when freed.
+ * - `MM_DEBUG_GUARD` ("guard"): each object gets pages of its own and ends
+ *   right before a `PROT_NONE` guard page, so overruns fault at once.
+ * - `MM_DEBUG_VALIDATE` ("validate"): the block chain of a page is verified
+ *   whenever it is walked, and on each allocation and free in the page.
+ */
+#define MM_DEBUG_CANARY 0x1
+#define MM_DEBUG_POISON 0x2
+#define MM_DEBUG_GUARD 0x4
+#define MM_DEBUG_VALIDATE 0x8
+#define MM_DEBUG_ALL                                                           \
+  (MM_DEBUG_CANARY | MM_DEBUG_POISON | MM_DEBUG_GUARD | MM_DEBUG_VALIDATE)
+
+//-----------------< user defined data type section -----------------/
+/**
+ * @brief Handle of a registered page family.
+ *
+ * Returned by `MM_REG_STRUCT` and accepted by `XCALLOC_H`. The handle stays
+ * valid for the lifetime of the program since page families are never
+ * unregistered.
+ */
+typedef struct vm_page_family_ *mm_family_handle_t;
+
+/**
+ * @brief Handle of a movable object.
+ *
+ * Returned by `xcalloc_movable()`. The handle stays valid until the object
+ * is freed with `xfree_movable()`, while the object itself may be moved by
+ * the compactor whenever it is not pinned.
+ */
+typedef struct mm_handle_slot_ *mm_handle_t;
+
+/**
+ * @brief Bump-pointer arena for objects that are freed together.
+ *
+ * @see arena_create()
+ */
+typedef struct mm_arena_ mm_arena_t;
+
+/**
+ * @brief Counters of the page retention pool.
+ *
+ * @see mm_get_page_pool_stats()
+ */
+typedef struct mm_page_pool_stats_ {
+  uint64_t hits;     /**< Pages served from a pool instead of the kernel. */
+  uint64_t misses;   /**< Pages that had to be mapped from the kernel. */
+  uint64_t released; /**< Empty pages returned to the kernel. */
+  uint32_t retained; /**< Empty pages currently held by all pools. */
+} mm_page_pool_stats_t;
+
+/**
+ * @brief Counters of `xrealloc()`.
+ *
+ * @see mm_get_realloc_stats()
+ */
+typedef struct mm_realloc_stats_ {
+  uint64_t in_place; /**< Resizes that kept the object where it was. */
+  uint64_t moved;    /**< Resizes that had to allocate, copy and free. */
+} mm_realloc_stats_t;
+
+/**
+ * @brief Allocator-wide counters, maintained as the allocator runs.
+ *
+ * @see mm_get_stats()
+ */
+typedef struct mm_stats_ {
+  uint64_t bytes_in_use; /**< Bytes of pages and spans taken by live objects,
+                            including their block headers and padding and the
+                            objects held in thread caches; arena pages count
+                            in full. */
+  uint64_t pages_mapped; /**< System pages currently mapped from the kernel,
+                            retained and arena pages included. */
+  uint64_t free_blocks;  /**< Number of free blocks of all page families. */
+  uint64_t free_bytes;   /**< Total size of those free blocks. */
+  uint32_t largest_free_block; /**< Size of the largest free block. */
+  double fragmentation; /**< Share of the free bytes outside the largest free
+                           block, from 0 to 1. */
+  uint64_t allocs;      /**< Objects allocated so far. */
+  uint64_t frees;       /**< Objects freed so far. */
+  double alloc_rate;    /**< Allocations per second since the previous call
+                           to `mm_get_stats()`. */
+  double free_rate;     /**< Frees per second since the previous call to
+                           `mm_get_stats()`. */
+  uint64_t moved_objects;  /**< Movable objects relocated by the compactor. */
+  uint64_t compacted_pages; /**< Pages the compactor emptied. */
+} mm_stats_t;
+
+/**
+ * @brief Counters of one NUMA node.
+ *
+ * @see mm_get_numa_stats()
+ */
+typedef struct mm_numa_stats_ {
+  uint64_t data_pages;     /**< Pages carved into blocks or slabs for the
+                              threads of the node. */
+  uint64_t retained_pages; /**< Empty pages of the node kept for reuse. */
+  uint64_t bytes_in_use;   /**< Bytes of those pages taken by live objects,
+                              as in `mm_get_stats()`; large objects are not
+                              included. */
+  uint64_t pool_hits;      /**< Pages reused from the node's pools. */
+  uint64_t pages_mapped_total; /**< System pages mapped for the node so
+                                  far, large object spans included. */
+} mm_numa_stats_t;
+
+/**
+ * @brief Output formats of `mm_heap_profile_write()`.
+ */
+typedef enum {
+  MM_HEAP_PROFILE_PPROF,  /**< Legacy heap profile text, read by `pprof`. */
+  MM_HEAP_PROFILE_FOLDED, /**< One `frame;frame;... bytes` line per stack,
+                             read by flame graph tools. */
+} mm_heap_profile_format_t;
+
+/**
+ * @brief How a page family chooses the free block serving a request.
+ *
+ * @see mm_set_placement_policy()
+ */
+typedef enum {
+  MM_PLACEMENT_SEGREGATED, /**< Head of the smallest size class that surely
+                              fits, in constant time (default). */
+  MM_PLACEMENT_BEST_FIT,   /**< Smallest free block that fits. */
+  MM_PLACEMENT_FIRST_FIT,  /**< Lowest addressed free block that fits. */
+  MM_PLACEMENT_NEXT_FIT,   /**< First free block that fits from the end of
+                              the previous allocation on, wrapping around. */
+  MM_PLACEMENT_WORST_FIT,  /**< Largest free block. */
+} mm_placement_policy_t;
+
 //-----------------< Public functions interface section -----------------/
 /**
  * @brief Initializes the memory manager.
@@ -55,10 +208,10 @@ void mm_init();
  *
  * @param struct_name The name of the memory structure.
  * @param struct_size The size of the memory structure.
+ * @return Handle of the new page family, or NULL if it could not be created.
  *
- * @note If the size of the memory structure exceeds the system page size, an
- * error message is printed, and the function returns without creating the page
- * family.
+ * @note Structures larger than the system page size are accepted; every
+ * allocation of such a page family is served from a large object span.
  *
  * @note This function maintains a linked list of virtual memory pages
  * (`first_vm_page_for_families`) to store the page families. If there are no
@@ -75,7 +228,94 @@ void mm_init();
  *
  * @see mm_get_new_vm_page_from_kernel()
  */
-void mm_instantiate_new_page_family(char *struct_name, uint32_t struct_size);
+mm_family_handle_t mm_instantiate_new_page_family(char *struct_name,
+                                                  uint32_t struct_size);
+
+/**
+ * @brief Instantiates a new page family whose objects are all aligned.
+ *
+ * Same as `mm_instantiate_new_page_family()`, except that the application
+ * data of every block of the family, including thread-cached and large
+ * objects, starts at a multiple of `alignment`. Blocks are padded so that
+ * the metadata block in front of the next block keeps it aligned, e.g. a
+ * 64-byte aligned family of 36-byte structures uses 64 bytes per object.
+ *
+ * @param struct_name The name of the memory structure.
+ * @param struct_size The size of the memory structure.
+ * @param alignment Alignment of the objects, a power of two of at most
+ * `MM_MAX_FAMILY_ALIGNMENT` bytes.
+ * @return Handle of the new page family, or NULL if the alignment is not
+ * supported.
+ */
+mm_family_handle_t mm_instantiate_new_aligned_page_family(char *struct_name,
+                                                          uint32_t struct_size,
+                                                          uint32_t alignment);
+
+/**
+ * @brief Instantiates a new page family whose single units live in slabs.
+ *
+ * Same as `mm_instantiate_new_page_family()`, except that one-unit objects of
+ * the family are packed into equal slots of dedicated slab pages instead of
+ * being carved out with a metadata block each. Allocation and free of a slot
+ * take constant time and never split or coalesce. Multi-unit requests still
+ * go through the regular data blocks.
+ *
+ * @param struct_name The name of the memory structure.
+ * @param struct_size The size of the memory structure.
+ * @return Handle of the new page family, or NULL if it could not be created.
+ *
+ * @note Structures too large for two slots to fit in a page are registered as
+ * regular page families.
+ */
+mm_family_handle_t mm_instantiate_new_slab_family(char *struct_name,
+                                                  uint32_t struct_size);
+
+/**
+ * @brief Instantiates a new page family whose objects may be relocated.
+ *
+ * Objects of a movable family are allocated with `xcalloc_movable()` and
+ * reached through a handle, so that `mm_compact()` can move them out of
+ * sparsely used pages and give those pages back. Each object carries
+ * `MM_MOVABLE_PREFIX` extra bytes pointing back to its handle.
+ *
+ * @param struct_name The name of the memory structure.
+ * @param struct_size The size of the memory structure.
+ * @return Handle of the new page family, or NULL if it could not be created.
+ *
+ * @note Objects of a movable family bypass the thread cache, and can only be
+ * allocated and freed through the movable calls.
+ */
+mm_family_handle_t mm_instantiate_new_movable_page_family(char *struct_name,
+                                                          uint32_t struct_size);
+
+/**
+ * @brief Returns the page family of a structure, registering it on first use.
+ *
+ * Backs `XCALLOC_T`/`XMALLOC_T`, which call it once per call site and cache
+ * the handle. A structure already registered by `MM_REG_STRUCT` or its
+ * variants, or by `xcalloc()`, keeps its page family.
+ *
+ * @param struct_name The name of the memory structure.
+ * @param struct_size The size of the memory structure.
+ * @return Handle of the page family, or NULL if a page family of that name
+ * has another structure size or could not be created.
+ */
+mm_family_handle_t mm_get_page_family(char *struct_name, uint32_t struct_size);
+
+/**
+ * @brief Selects how a page family places objects in its free blocks.
+ *
+ * Every policy but `MM_PLACEMENT_SEGREGATED` walks the free blocks of the
+ * size classes that may fit the request, so it trades allocation speed for
+ * the fragmentation behavior of the classic policy. Single units held by the
+ * thread caches are placed by the policy when the caches refill.
+ *
+ * @param family Handle of the page family.
+ * @param policy Placement policy of the family's future allocations.
+ * @return 0 on success, -1 if the policy is unknown.
+ */
+int mm_set_placement_policy(mm_family_handle_t family,
+                            mm_placement_policy_t policy);
 
 /**
  * @brief Allocates and initializes memory for an array of structures.
@@ -83,9 +323,10 @@ void mm_instantiate_new_page_family(char *struct_name, uint32_t struct_size);
  * This function allocates memory for an array of structures of the specified
  * type and initializes the memory to zero. It first looks up the page family
  * associated with the specified structure name to determine the size of the
- * structure. Then, it checks if the requested memory size exceeds the maximum
- * allocatable memory per page. If the allocation is successful, it initializes
- * the allocated memory to zero and returns a pointer to the allocated memory.
+ * structure. Requests that fit in a virtual memory page are carved out of the
+ * family's pages; larger requests get a dedicated span of contiguous pages.
+ * If the allocation is successful, it initializes the allocated memory to
+ * zero and returns a pointer to the allocated memory.
  *
  * @param struct_name The name of the structure type for which memory is to be
  * allocated.
@@ -98,9 +339,89 @@ void mm_instantiate_new_page_family(char *struct_name, uint32_t struct_size);
  * registered with the Memory Manager using the mm_register_structure function.
  *       It also assumes that the specified structure type has a corresponding
  * page family registered with the Memory Manager.
+ *
+ * @note This function may be called concurrently from several threads once
+ * the page families they use are registered. Single-unit requests are served
+ * from the calling thread's cache without taking any lock.
+ *
+ * @note Memory that is known to still hold the zeros the kernel mapped it
+ * with is not cleared again; only previously used bytes are.
  */
 void *xcalloc(char *struct_name, int units);
 
+/**
+ * @brief Allocates memory for an array of structures without zeroing it.
+ *
+ * Behaves like `xcalloc()` except that the returned memory may hold data left
+ * by a previous allocation. Use it for objects the caller overwrites entirely
+ * anyway.
+ *
+ * @param struct_name The name of the structure type for which memory is to be
+ * allocated.
+ * @param units The number of structures to allocate.
+ *
+ * @return A pointer to the allocated memory if successful, or NULL if the
+ * allocation fails.
+ *
+ * @see XMALLOC
+ */
+void *xmalloc(char *struct_name, int units);
+
+/**
+ * @brief Allocates and initializes memory for an array of structures of a
+ * registered page family.
+ *
+ * Unlike `xcalloc()`, the page family is identified by the handle returned at
+ * registration time, so no string parsing or family lookup happens on the
+ * allocation path.
+ *
+ * @param family Handle of the page family, as returned by `MM_REG_STRUCT`.
+ * @param units The number of structures to allocate.
+ *
+ * @return A pointer to the allocated memory if successful, or NULL if the
+ * allocation fails.
+ *
+ * @see XCALLOC_H
+ */
+void *xcalloc_family(mm_family_handle_t family, int units);
+
+/**
+ * @brief Allocates memory for an array of structures of a registered page
+ * family without zeroing it.
+ *
+ * @param family Handle of the page family, as returned by `MM_REG_STRUCT`.
+ * @param units The number of structures to allocate.
+ *
+ * @return A pointer to the allocated memory if successful, or NULL if the
+ * allocation fails.
+ *
+ * @see XMALLOC_H
+ */
+void *xmalloc_family(mm_family_handle_t family, int units);
+
+/**
+ * @brief Allocates zeroed memory aligned on a given boundary.
+ *
+ * Unlike the family-wide alignment of
+ * `mm_instantiate_new_aligned_page_family()`, this only aligns the returned
+ * object, at the cost of `alignment` bytes of slack while it is carved out.
+ * `xrealloc()` only keeps the alignment when it resizes in place.
+ *
+ * @param family Handle of the page family.
+ * @param units The number of structures to allocate.
+ * @param alignment Alignment of the object, a power of two. Objects that
+ * need a large object span cannot be aligned beyond
+ * `MM_MAX_FAMILY_ALIGNMENT` bytes.
+ * @return A pointer to the allocated memory if successful, or NULL if the
+ * allocation fails or the alignment is not supported.
+ */
+void *xcalloc_aligned(mm_family_handle_t family, int units, uint32_t alignment);
+
+/**
+ * @brief Same as `xcalloc_aligned()`, without zeroing the memory.
+ */
+void *xmalloc_aligned(mm_family_handle_t family, int units, uint32_t alignment);
+
 /**
  * @brief Frees memory allocated by the memory manager.
  *
@@ -110,9 +431,408 @@ void *xcalloc(char *struct_name, int units);
  * to the memory manager's free blocks function.
  *
  * @param app_data Pointer to the memory to be freed.
+ *
+ * @note Single-unit objects are parked in the calling thread's cache rather
+ * than returned to their page family right away.
+ *
+ * @see mm_thread_cache_flush()
  */
 void xfree(void *app_data);
 
+/**
+ * @brief Returns the number of bytes usable at an allocated object.
+ *
+ * This is the size of the data block or slab slot serving the object, which
+ * may be larger than the size requested from `xcalloc()`.
+ *
+ * @param app_data Pointer returned by the memory manager.
+ * @return The usable size in bytes.
+ */
+uint32_t mm_usable_size(void *app_data);
+
+/**
+ * @brief Resizes an object allocated by the memory manager.
+ *
+ * The object keeps its page family and is resized to `units` structures of
+ * that family. Whenever possible the object stays where it is: a block grows
+ * into the free block that follows it and shrinks by splitting its tail off
+ * as a free block, a slab slot is kept while the new size fits in it, and a
+ * large object span keeps its pages when the object shrinks and grows by at
+ * least half, into a retained span or with `mremap()`. Otherwise a new object
+ * is allocated, the contents are copied and the old object is freed.
+ *
+ * Bytes past the old size are not initialized.
+ *
+ * @param app_data Pointer to the object, or NULL.
+ * @param units New number of structures.
+ * @return Pointer to the resized object, NULL if `app_data` is NULL, `units`
+ * is zero or the allocation fails, in which case the object is left as is
+ * (except for `units` zero, which frees it).
+ */
+void *xrealloc(void *app_data, int units);
+
+/**
+ * @brief Reads the counters of `xrealloc()`.
+ *
+ * @param stats Pointer to the structure receiving the counters.
+ */
+void mm_get_realloc_stats(mm_realloc_stats_t *stats);
+
+/**
+ * @brief Allocates a burst of zeroed single-unit objects.
+ *
+ * Objects already cached by the calling thread are handed out first, and
+ * the rest are carved from the family's free blocks with one acquisition of
+ * the family lock per `MM_BULK_CHUNK` objects.
+ *
+ * @param family Handle of the page family.
+ * @param count Number of objects to allocate.
+ * @param objects Array receiving the `count` objects.
+ * @return Number of objects allocated, less than `count` only if memory ran
+ * out; the objects allocated so far stay valid.
+ */
+int xcalloc_bulk(mm_family_handle_t family, int count, void **objects);
+
+/**
+ * @brief Frees a burst of objects allocated by the memory manager.
+ *
+ * The objects may belong to different page families. Objects that are next
+ * to each other in memory, as a burst allocated by `xcalloc_bulk()` usually
+ * is, are freed as one block. The objects bypass the thread cache.
+ *
+ * @param objects Array of the objects to free; the array itself is left
+ * untouched.
+ * @param count Number of objects.
+ */
+void xfree_bulk(void **objects, int count);
+
+/**
+ * @brief Allocates zeroed movable memory for an array of structures.
+ *
+ * @param family Handle of a page family registered with
+ * `MM_REG_STRUCT_MOVABLE`.
+ * @param units The number of structures to allocate.
+ * @return Handle of the object, or NULL if the allocation fails.
+ */
+mm_handle_t xcalloc_movable(mm_family_handle_t family, int units);
+
+/**
+ * @brief Frees a movable object and its handle.
+ *
+ * @param handle Handle of the object, which must not be pinned.
+ */
+void xfree_movable(mm_handle_t handle);
+
+/**
+ * @brief Pins a movable object and returns its current address.
+ *
+ * The object stays at that address until the matching `mm_handle_unpin()`.
+ * Pins nest and may be taken by several threads at once; a pin taken while
+ * the compactor moves the object waits for the move to complete.
+ *
+ * @param handle Handle of the object.
+ * @return Address of the object.
+ */
+void *mm_handle_pin(mm_handle_t handle);
+
+/**
+ * @brief Releases a pin taken by `mm_handle_pin()`. The address it returned
+ * must not be used afterwards.
+ *
+ * @param handle Handle of the object.
+ */
+void mm_handle_unpin(mm_handle_t handle);
+
+/**
+ * @brief Moves movable objects out of the sparsest pages of a family.
+ *
+ * Pages whose live objects take less than `MM_COMPACT_SPARSE_PERCENT` of
+ * their memory are evacuated, sparsest first, into the free blocks of the
+ * family's other pages; pages left empty go back to the page retention
+ * pool. No page is mapped for the move, and pinned objects stay where they
+ * are. The family lock is held throughout, so `max_pages` bounds the pause
+ * of other threads using the family.
+ *
+ * @param family Handle of a movable page family.
+ * @param max_pages Most pages to evacuate, up to `MM_COMPACT_MAX_PAGES`.
+ * @return Number of pages emptied.
+ */
+uint32_t mm_compact(mm_family_handle_t family, uint32_t max_pages);
+
+/**
+ * @brief Starts a thread that compacts movable page families in the
+ * background.
+ *
+ * Every interval, each movable family whose free blocks make up at least
+ * `threshold_percent` of its page memory is compacted by up to
+ * `MM_COMPACT_STEP_PAGES` pages, so the work is spread over time.
+ *
+ * @param interval_ms Time between two rounds, in milliseconds.
+ * @param threshold_percent Free share of a family's pages, from 1 to 100,
+ * above which it is compacted.
+ * @return 0 on success, -1 if the compactor is already running or the
+ * arguments are invalid.
+ */
+int mm_compactor_start(uint32_t interval_ms, uint32_t threshold_percent);
+
+/**
+ * @brief Stops the thread started by `mm_compactor_start()`, if any.
+ */
+void mm_compactor_stop();
+
+/**
+ * @brief Returns all objects cached by the calling thread to their page
+ * families.
+ *
+ * Single-unit allocations and frees are served from a per-thread cache so
+ * that the common path takes no lock. Cached objects still occupy their
+ * hosting pages, so a thread that goes idle after freeing many objects
+ * should call this function to let empty pages go back to the kernel. The
+ * cache of a thread is flushed automatically when the thread exits.
+ */
+void mm_thread_cache_flush();
+
+/**
+ * @brief Enables or disables the per-thread allocation cache.
+ *
+ * The cache is enabled by default. Disabling it makes every allocation and
+ * free take the family lock, which is mainly useful for benchmarking and
+ * debugging. Objects already cached by other threads stay in their caches
+ * until those threads flush or exit.
+ *
+ * @param enable Non-zero to enable the cache, zero to disable it.
+ */
+void mm_set_thread_cache(int enable);
+
+/**
+ * @brief Enables or disables huge pages for large object spans.
+ *
+ * Allocations that do not fit in a single virtual memory page are served from
+ * a dedicated span of contiguous pages. When this option is enabled (it is
+ * disabled by default), spans of at least 2 MiB are first requested with
+ * `MAP_HUGETLB`; if the kernel has no huge pages reserved the span silently
+ * falls back to regular pages.
+ *
+ * @param enable Non-zero to try huge pages, zero to always use regular pages.
+ */
+void mm_set_large_object_hugepages(int enable);
+
+/**
+ * @brief Sets the high-water marks of the page retention pool.
+ *
+ * A page that becomes empty is not unmapped right away: it is kept by its
+ * page family, up to `family_pages` pages per family, then by a pool shared
+ * by all families, up to `global_pages` pages. Allocations that need a new
+ * page take one from these pools before mapping one from the kernel. Freed
+ * large object spans of up to `MM_LARGE_SPAN_POOL_MAX_UNITS` pages are kept
+ * as well, up to `MM_LARGE_SPAN_POOL_SCALE` times `global_pages` pages per
+ * NUMA node, and reused by requests needing a span of about the same size,
+ * which may be up to a quarter larger than needed. Pages above the new limits
+ * are unmapped immediately.
+ *
+ * @param family_pages Number of empty pages each page family may keep
+ * (`MM_FAMILY_PAGE_POOL_DEFAULT` by default).
+ * @param global_pages Number of empty pages the shared pool may keep per
+ * NUMA node (`MM_GLOBAL_PAGE_POOL_DEFAULT` by default).
+ *
+ * @note Setting both limits to zero restores the historical behavior of
+ * unmapping every page as soon as it becomes empty.
+ */
+void mm_set_page_pool_limits(uint32_t family_pages, uint32_t global_pages);
+
+/**
+ * @brief Returns every retained empty page and large object span to the
+ * kernel, along with the pages past the end of live large objects, which
+ * their spans keep when the objects shrink.
+ *
+ * @return Number of pages unmapped.
+ */
+uint32_t mm_trim();
+
+/**
+ * @brief Takes every lock of the memory manager before `fork()`.
+ *
+ * Meant to be registered with `pthread_atfork()` along with
+ * `mm_fork_parent()` and `mm_fork_child()`, so that the child of a
+ * multi-threaded process never inherits a lock held by a thread that does not
+ * exist in the child. The locks are taken in a fixed order: the compactor
+ * and statistics dump locks, the NUMA lock, the registry lock, the lock of
+ * every page family in registration order, then the page pool, profiler and
+ * statistics locks.
+ */
+void mm_fork_prepare(void);
+
+/**
+ * @brief Releases the locks taken by `mm_fork_prepare()` in the parent.
+ */
+void mm_fork_parent(void);
+
+/**
+ * @brief Reinitializes the locks taken by `mm_fork_prepare()` in the child.
+ *
+ * The compactor and statistics dump threads are not running in the child;
+ * they are recorded as stopped so that they can be started again.
+ */
+void mm_fork_child(void);
+
+/**
+ * @brief Reads the counters of the page retention pool.
+ *
+ * @param stats Pointer to the structure receiving the counters.
+ */
+void mm_get_page_pool_stats(mm_page_pool_stats_t *stats);
+
+/**
+ * @brief Returns the number of NUMA nodes the memory manager keeps apart.
+ *
+ * On machines with several nodes, each page family serves the threads of a
+ * node from pages bound to that node, and empty pages are retained per node,
+ * so that a thread's allocations come from local memory. Single-node
+ * machines and kernels without NUMA support report 1.
+ *
+ * @return Number of nodes, at most `MM_NUMA_MAX_NODES`.
+ */
+uint32_t mm_numa_node_count();
+
+/**
+ * @brief Reads the counters of a NUMA node.
+ *
+ * @param node Node number, below `mm_numa_node_count()`.
+ * @param stats Pointer to the structure receiving the counters.
+ * @return 0 on success, -1 if the node does not exist.
+ */
+int mm_get_numa_stats(uint32_t node, mm_numa_stats_t *stats);
+
+/**
+ * @brief Selects the checks of the debug mode.
+ *
+ * The mode starts with the flags of the `MM_DEBUG_DEFAULT_FLAGS` build
+ * option, or those listed in the `HMM_DEBUG` environment variable read by
+ * `mm_init()`, e.g. `HMM_DEBUG=canary,poison` or `HMM_DEBUG=all`. While any
+ * check is enabled, objects bypass the thread cache and slab pages, and a
+ * detected corruption prints the object's address and aborts the program.
+ * Movable objects and arenas are not checked.
+ *
+ * @param flags Combination of the `MM_DEBUG_*` flags, 0 to disable.
+ * @return 0 on success, -1 if any thread already allocated objects, even
+ * ones it freed since or keeps in its thread cache, as they lack the
+ * canaries the checks rely on.
+ */
+int mm_set_debug_flags(uint32_t flags);
+
+/**
+ * @brief Reads the allocator statistics.
+ *
+ * The counters are kept up to date by the allocation and free paths, so this
+ * does not walk the heap: it only takes each page family's lock briefly. The
+ * allocation and free counts of other threads may lag by up to
+ * `MM_STATS_PUBLISH_BATCH` operations each.
+ *
+ * @param stats Pointer to the structure receiving the counters.
+ */
+void mm_get_stats(mm_stats_t *stats);
+
+/**
+ * @brief Starts a thread that writes `mm_get_stats()` periodically.
+ *
+ * Each interval one JSON object is written on a line of its own, for
+ * monitoring agents to tail or read from a socket.
+ *
+ * @param path File to append to, or `unix:` followed by the path of a Unix
+ * stream socket to connect to, e.g. `unix:/run/hmm.sock`.
+ * @param interval_ms Time between two dumps, in milliseconds.
+ * @return 0 on success, -1 if a dump is already running or `path` cannot be
+ * opened.
+ */
+int mm_stats_dump_start(const char *path, uint32_t interval_ms);
+
+/**
+ * @brief Stops the thread started by `mm_stats_dump_start()`, if any.
+ */
+void mm_stats_dump_stop();
+
+/**
+ * @brief Starts sampling allocations for the heap profile.
+ *
+ * On average one object is sampled every `sample_interval` allocated bytes,
+ * with the call stack it was allocated from. Sampled objects are tracked
+ * until they are freed, so the profile shows which call sites own the live
+ * memory. Starting again discards the samples recorded so far.
+ *
+ * @param sample_interval Average bytes between two samples, 0 for
+ * `MM_PROFILE_DEFAULT_INTERVAL`.
+ * @return 0 on success, -1 if the profiler tables cannot be mapped.
+ */
+int mm_heap_profile_start(uint32_t sample_interval);
+
+/**
+ * @brief Stops sampling allocations. Samples still live are kept, and
+ * forgotten as their objects are freed.
+ */
+void mm_heap_profile_stop();
+
+/**
+ * @brief Writes the live heap profile.
+ *
+ * Folded profiles carry the estimated live bytes of each stack, outermost
+ * frame first. Pprof profiles carry the raw samples with the sampling
+ * interval, which `pprof` scales itself, and the process memory map for
+ * symbolization, e.g. `go tool pprof ./app heap.prof`.
+ *
+ * @param path File to write.
+ * @param format `MM_HEAP_PROFILE_PPROF` or `MM_HEAP_PROFILE_FOLDED`.
+ * @return 0 on success, -1 if profiling never started or `path` cannot be
+ * written.
+ */
+int mm_heap_profile_write(const char *path, mm_heap_profile_format_t format);
+
+/**
+ * @brief Creates an empty arena.
+ *
+ * An arena hands out objects by bumping a pointer through its pages: the
+ * objects carry no metadata and cannot be freed one by one. All of them are
+ * released at once by `arena_reset()` or `arena_destroy()`, which makes arenas
+ * a good fit for request-scoped objects. Arena pages are taken from, and
+ * returned to, the page retention pool.
+ *
+ * @return Pointer to the new arena, or NULL if no page could be mapped.
+ *
+ * @note An arena is not thread safe; each arena should be used by a single
+ * thread at a time.
+ */
+mm_arena_t *arena_create();
+
+/**
+ * @brief Allocates zeroed memory from an arena.
+ *
+ * @param arena Pointer to the arena.
+ * @param size Size of the object in bytes. Objects larger than a page get a
+ * dedicated span.
+ *
+ * @return Pointer to the memory, aligned on `MM_ARENA_ALIGNMENT` bytes, or
+ * NULL if the allocation fails.
+ *
+ * @warning Memory returned by this function must not be passed to `xfree()`.
+ */
+void *arena_alloc(mm_arena_t *arena, uint32_t size);
+
+/**
+ * @brief Releases every object of an arena, keeping the arena usable.
+ *
+ * All pages but the one hosting the arena itself go back to the page
+ * retention pool; spans of large objects are unmapped.
+ *
+ * @param arena Pointer to the arena.
+ */
+void arena_reset(mm_arena_t *arena);
+
+/**
+ * @brief Releases every object of an arena and the arena itself.
+ *
+ * @param arena Pointer to the arena, which must not be used afterwards.
+ */
+void arena_destroy(mm_arena_t *arena);
+
 /**
  * @brief Prints all registered page families.
  *
@@ -164,6 +884,8 @@ void mm_print_block_usage();
  * with the size of the structure.
  *
  * @param struct_name The name of the memory structure to be registered.
+ * @return Handle of the new page family, which can be cached and passed to
+ * `XCALLOC_H`.
  *
  * @note This macro should be used to register each memory structure before it
  * is instantiated as a page family within the memory manager. It ensures proper
@@ -175,6 +897,45 @@ void mm_print_block_usage();
 #define MM_REG_STRUCT(struct_name)                                             \
   (mm_instantiate_new_page_family(#struct_name, sizeof(struct_name)))
 
+/**
+ * @brief Registers a memory structure whose single units are served from
+ * slab pages.
+ *
+ * @param struct_name The name of the memory structure to be registered.
+ * @return Handle of the new page family.
+ *
+ * @see mm_instantiate_new_slab_family()
+ */
+#define MM_REG_STRUCT_SLAB(struct_name)                                        \
+  (mm_instantiate_new_slab_family(#struct_name, sizeof(struct_name)))
+
+/**
+ * @brief Registers a memory structure whose objects are all aligned, e.g. on
+ * a cache line.
+ *
+ * @param struct_name The name of the memory structure to be registered.
+ * @param alignment Alignment of the objects, a power of two of at most
+ * `MM_MAX_FAMILY_ALIGNMENT` bytes.
+ * @return Handle of the new page family.
+ *
+ * @see mm_instantiate_new_aligned_page_family()
+ */
+#define MM_REG_STRUCT_ALIGNED(struct_name, alignment)                          \
+  (mm_instantiate_new_aligned_page_family(#struct_name, sizeof(struct_name),   \
+                                          alignment))
+
+/**
+ * @brief Registers a memory structure whose objects are reached through
+ * handles and may be moved by the compactor.
+ *
+ * @param struct_name The name of the memory structure to be registered.
+ * @return Handle of the new page family, to pass to `xcalloc_movable()`.
+ *
+ * @see mm_instantiate_new_movable_page_family()
+ */
+#define MM_REG_STRUCT_MOVABLE(struct_name)                                     \
+  (mm_instantiate_new_movable_page_family(#struct_name, sizeof(struct_name)))
+
 /**
  * @brief Macro for allocating memory for multiple instances of a structure and
  * initializing them to zero.
@@ -192,6 +953,121 @@ void mm_print_block_usage();
  */
 #define XCALLOC(units, struct_name) (xcalloc(#struct_name, units))
 
+/**
+ * @brief Macro for allocating zeroed memory from a page family handle.
+ *
+ * This macro is the fast path counterpart of `XCALLOC`: it takes the handle
+ * returned by `MM_REG_STRUCT` instead of a structure name, which skips all
+ * string work on the allocation path.
+ *
+ * @param handle Handle of the page family, as returned by `MM_REG_STRUCT`.
+ * @param units The number of instances of the structure to allocate memory
+ * for.
+ *
+ * @return A pointer to the allocated memory, initialized to zero, or NULL if
+ * allocation fails.
+ *
+ * Example usage:
+ *
+ *     mm_family_handle_t emp_family = MM_REG_STRUCT(emp_t);
+ *     emp_t *emp = XCALLOC_H(emp_family, 1);
+ */
+#define XCALLOC_H(handle, units) (xcalloc_family(handle, units))
+
+/**
+ * @brief Resolves the page family of a type once per call site.
+ *
+ * Expands to a GNU statement expression whose static variable caches the
+ * handle returned by `mm_get_page_family()` for the type, so only the first
+ * call at a site looks the family up.
+ *
+ * @param type The type, e.g. `emp_t`, `struct node` or `uint64_t`.
+ * @return Handle of the page family of the type.
+ */
+#define MM_TYPED_FAMILY(type)                                                  \
+  (__extension__({                                                             \
+    static mm_family_handle_t mm_typed_family_;                                \
+    mm_family_handle_t mm_family_ =                                            \
+        __atomic_load_n(&mm_typed_family_, __ATOMIC_ACQUIRE);                  \
+    if (!mm_family_) {                                                         \
+      mm_family_ = mm_get_page_family(#type, sizeof(type));                    \
+      __atomic_store_n(&mm_typed_family_, mm_family_, __ATOMIC_RELEASE);       \
+    }                                                                          \
+    mm_family_;                                                                \
+  }))
+
+/**
+ * @brief Macro for allocating zeroed memory for multiple instances of a type
+ * resolved at compile time.
+ *
+ * Unlike `XCALLOC`, the size comes from `sizeof(type)` and the page family is
+ * cached at the call site, so allocations never parse the type name. The
+ * first call registers the type if needed, under the same name as
+ * `MM_REG_STRUCT(type)`.
+ *
+ * @param units The number of instances of the type to allocate memory for.
+ * @param type The type for which memory is to be allocated.
+ *
+ * @return A `type *` to the allocated memory, initialized to zero, or NULL if
+ * allocation fails.
+ *
+ * Example usage:
+ *
+ *     emp_t *emp = XCALLOC_T(1, emp_t);
+ */
+#define XCALLOC_T(units, type)                                                 \
+  ((type *)xcalloc_family(MM_TYPED_FAMILY(type), units))
+
+/**
+ * @brief Macro for allocating memory for multiple instances of a structure
+ * without initializing it.
+ *
+ * @param units The number of instances of the structure to allocate memory for.
+ * @param struct_name The name of the structure for which memory is to be
+ * allocated.
+ *
+ * @return A pointer to the allocated memory, or NULL if allocation fails.
+ */
+#define XMALLOC(units, struct_name) (xmalloc(#struct_name, units))
+
+/**
+ * @brief Macro for allocating uninitialized memory from a page family handle.
+ *
+ * @param handle Handle of the page family, as returned by `MM_REG_STRUCT`.
+ * @param units The number of instances of the structure to allocate memory
+ * for.
+ *
+ * @return A pointer to the allocated memory, or NULL if allocation fails.
+ */
+#define XMALLOC_H(handle, units) (xmalloc_family(handle, units))
+
+/**
+ * @brief Same as `XCALLOC_T`, without zeroing the memory.
+ *
+ * @param units The number of instances of the type to allocate memory for.
+ * @param type The type for which memory is to be allocated.
+ *
+ * @return A `type *` to the allocated memory, or NULL if allocation fails.
+ */
+#define XMALLOC_T(units, type)                                                 \
+  ((type *)xmalloc_family(MM_TYPED_FAMILY(type), units))
+
+/**
+ * @brief Macro for allocating zeroed memory for multiple instances of a
+ * structure from an arena.
+ *
+ * @param arena Pointer to the arena.
+ * @param units The number of instances of the structure to allocate memory
+ * for.
+ * @param struct_name The name of the structure for which memory is to be
+ * allocated.
+ *
+ * @return A pointer to the allocated memory, initialized to zero, or NULL if
+ * allocation fails.
+ */
+#define ARENA_ALLOC(arena, units, struct_name)                                 \
+  ((struct_name *)arena_alloc(arena, (units) * sizeof(struct_name)))
+
 /**
  * @brief Macro for freeing memory using a custom deallocation function.
  *
@@ -203,4 +1079,17 @@ void mm_print_block_usage();
  */
 #define XFREE(ptr) (xfree(ptr))
 
+/**
+ * @brief Macro for resizing an array of structures allocated by the memory
+ * manager.
+ *
+ * @param ptr Pointer to the array.
+ * @param units The new number of instances of the structure.
+ * @param struct_name The name of the structure.
+ *
+ * @return A pointer to the resized array, or NULL if resizing fails.
+ */
+#define XREALLOC(ptr, units, struct_name)                                      \
+  ((struct_name *)xrealloc(ptr, units))
+
 #endif /**< UAPI_MM_H_ */
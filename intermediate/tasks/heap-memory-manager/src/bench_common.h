@@ -0,0 +1,59 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : bench_common.h             *****************/
+/****************************************************************/
+
+/**
+ * @file bench_common.h
+ * @brief Helpers shared by the benchmark programs.
+ *
+ * Every benchmark includes its own copy of these static functions, so that
+ * each one still builds from a single source file plus the library sources.
+ */
+
+#ifndef BENCH_COMMON_H_
+#define BENCH_COMMON_H_
+
+//-----------------< Includes section -----------------/
+/**< System includes */
+#include <stdint.h>
+#include <time.h>
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Returns the current monotonic time in seconds.
+ */
+static inline double bench_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Returns the current monotonic time in nanoseconds.
+ */
+static inline uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/**
+ * @brief xorshift64 generator.
+ *
+ * The same seed yields the same sequence, so that every allocator, policy or
+ * structure compared by a benchmark gets the exact same workload.
+ *
+ * @param rng State of the generator, which must not be 0.
+ * @return The next pseudo-random number.
+ */
+static inline uint64_t bench_rand(uint64_t *rng) {
+  *rng ^= *rng << 13;
+  *rng ^= *rng >> 7;
+  *rng ^= *rng << 17;
+  return *rng;
+}
+
+#endif /**< BENCH_COMMON_H_ */
@@ -0,0 +1,107 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : datatype_size_hash_gen.c   *****************/
+/****************************************************************/
+
+/**
+ * @file datatype_size_hash_gen.c
+ * @brief Generator of the perfect hash table of the data type names.
+ *
+ * This program searches, for the smallest power-of-two table first, the seed
+ * of `datatype_hash()` under which every name of `DATATYPE_SIZE_LIST` lands
+ * in its own slot, and prints `datatype_size_hash.h` on stdout. It is not part
+ * of the library; `make datatype_hash` builds and runs it.
+ */
+
+#include "datatype_size_lookup.h"
+#include <stdlib.h>
+
+//-----------------< Macros section -----------------/
+#define HASH_GEN_MIN_SLOTS 64
+#define HASH_GEN_MAX_SLOTS 1024
+#define HASH_GEN_MAX_SEEDS (1u << 24)
+#define HASH_GEN_FIRST_SEED 2166136261u
+#define HASH_GEN_NAME(name, type) name,
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Checks whether a seed maps every name to a distinct slot.
+ *
+ * @param names The data type names.
+ * @param count Number of names.
+ * @param seed The seed to try.
+ * @param slots Table size, a power of two.
+ * @param table Receives 1 + the index of the name in each slot, 0 if empty.
+ * @return 1 if the seed is collision free, 0 otherwise.
+ */
+static int hash_gen_try(const char *const *names, unsigned count,
+                        uint32_t seed, unsigned slots, uint8_t *table) {
+  unsigned i;
+  size_t len;
+
+  memset(table, 0, slots);
+  for (i = 0; i < count; i++) {
+    uint32_t slot = datatype_hash(names[i], seed, &len) & (slots - 1);
+    if (table[slot]) {
+      return 0;
+    }
+    table[slot] = (uint8_t)(i + 1);
+  }
+  return 1;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @return 0 once the header is printed, 1 if no seed was found.
+ */
+int main(void) {
+  static const char *const names[] = {DATATYPE_SIZE_LIST(HASH_GEN_NAME)};
+  static uint8_t table[HASH_GEN_MAX_SLOTS];
+  unsigned count = sizeof(names) / sizeof(names[0]);
+  unsigned slots, i;
+  uint32_t seed;
+
+  if (count >= UINT8_MAX) {
+    fprintf(stderr, "Error: Too many data types for an 8-bit table\n");
+    return 1;
+  }
+
+  for (slots = HASH_GEN_MIN_SLOTS; slots <= HASH_GEN_MAX_SLOTS; slots *= 2) {
+    if (slots < 2 * count) {
+      continue;
+    }
+    for (seed = HASH_GEN_FIRST_SEED;
+         seed != HASH_GEN_FIRST_SEED + HASH_GEN_MAX_SEEDS; seed++) {
+      if (hash_gen_try(names, count, seed, slots, table)) {
+        goto found;
+      }
+    }
+  }
+  fprintf(stderr, "Error: No collision free seed found\n");
+  return 1;
+
+found:
+  printf("/**\n"
+         " * @file datatype_size_hash.h\n"
+         " * @brief Perfect hash table of the data type names.\n"
+         " *\n"
+         " * Generated by `make datatype_hash` from DATATYPE_SIZE_LIST, do "
+         "not edit.\n"
+         " * Each slot holds 1 + the index of its name in the list, or 0.\n"
+         " */\n\n"
+         "#ifndef DATATYPE_SIZE_HASH_H_\n"
+         "#define DATATYPE_SIZE_HASH_H_\n\n"
+         "#include <stdint.h>\n\n"
+         "#define DATATYPE_HASH_SEED 0x%08xu\n"
+         "#define DATATYPE_HASH_SLOTS %u\n\n"
+         "static const uint8_t datatype_hash_table[DATATYPE_HASH_SLOTS] = {",
+         seed, slots);
+  for (i = 0; i < slots; i++) {
+    printf("%s%3u,", i % 12 ? " " : "\n   ", table[i]);
+  }
+  printf("\n};\n\n#endif /**< DATATYPE_SIZE_HASH_H_ */\n");
+  return 0;
+}
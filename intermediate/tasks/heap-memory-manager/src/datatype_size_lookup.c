@@ -7,6 +7,7 @@
  */
 
 #include "datatype_size_lookup.h"
+#include "datatype_size_hash.h"
 
 //-----------------< DatatypeMappings Datatype Mappings -----------------*/
 /**
@@ -17,42 +18,32 @@
  */
 typedef struct datatype_mapping_ {
   const char *name; /**< The name of the data type. */
+  size_t len;       /**< The length of the name. */
   size_t size;      /**< The size of the data type in bytes. */
 } datatype_mapping_t;
 
+#define DATATYPE_MAPPING(name, type) {name, sizeof(name) - 1, sizeof(type)},
+
 /**
  * @brief Array of data type mappings.
  *
  * This array contains mappings between data type names and their corresponding
- * sizes.
+ * sizes, in the order of `DATATYPE_SIZE_LIST` that the slots of
+ * `datatype_hash_table` refer to.
  */
-datatype_mapping_t type_mappings[] = {
-    {"int", sizeof(int)},
-    {"char", sizeof(char)},
-    {"float", sizeof(float)},
-    {"double", sizeof(double)},
-    {"short", sizeof(short)},
-    {"long", sizeof(long)},
-    {"long long", sizeof(long long)},
-    {"unsigned int", sizeof(unsigned int)},
-    {"unsigned char", sizeof(unsigned char)},
-    {"unsigned short", sizeof(unsigned short)},
-    {"unsigned long", sizeof(unsigned long)},
-    {"unsigned long long", sizeof(unsigned long long)},
-};
-
-// TODO: Implement an efficient data type mapping lookup using a hash table.
-//       Consider using a perfect hash function generator like gperf for optimal
-//       performance.
-// REFER_TO: gperf.md
+static const datatype_mapping_t type_mappings[] = {
+    DATATYPE_SIZE_LIST(DATATYPE_MAPPING)};
 
 size_t get_size_of_datatype(const char *data_type) {
-  // Iterate over the mappings and find the matching data type
-  for (size_t i = 0; i < sizeof(type_mappings) / sizeof(type_mappings[0]);
-       ++i) {
-    if (strcmp(data_type, type_mappings[i].name) == 0) {
-      return type_mappings[i].size;
-    }
+  size_t len;
+  uint32_t slot = datatype_hash(data_type, DATATYPE_HASH_SEED, &len) &
+                  (DATATYPE_HASH_SLOTS - 1);
+  uint8_t entry = datatype_hash_table[slot];
+
+  // The name of a slot only has to be confirmed, no other name hashes there
+  if (entry && type_mappings[entry - 1].len == len &&
+      memcmp(data_type, type_mappings[entry - 1].name, len) == 0) {
+    return type_mappings[entry - 1].size;
   }
   return 0; // Return 0 if data type is not found
 }
@@ -20,6 +20,44 @@
 /**< Project includes */
 #include "glthread.h"
 
+//-----------------< Private functions declaration -----------------/
+/**
+ * @brief Checks if a heap node comes before another one.
+ *
+ * @param heap Pointer to the heap.
+ * @param first Pointer to the first node.
+ * @param second Pointer to the second node.
+ * @return Non-zero if `first` has a higher priority than `second`.
+ */
+static inline int glthread_heap_before(glthread_heap_t *heap,
+                                       glthread_heap_node_t *first,
+                                       glthread_heap_node_t *second);
+
+/**
+ * @brief Melds two detached heap trees into one.
+ *
+ * @param heap Pointer to the heap.
+ * @param first Root of the first tree, with no siblings or parent.
+ * @param second Root of the second tree, with no siblings or parent.
+ * @return glthread_heap_node_t* Root of the melded tree.
+ */
+static glthread_heap_node_t *glthread_heap_meld(glthread_heap_t *heap,
+                                                glthread_heap_node_t *first,
+                                                glthread_heap_node_t *second);
+
+/**
+ * @brief Melds a list of sibling trees into one, in two passes.
+ *
+ * The siblings are first melded two by two from left to right, then the
+ * results from right to left, which keeps the removals O(log n) amortized.
+ *
+ * @param heap Pointer to the heap.
+ * @param first First tree of the sibling list, or NULL.
+ * @return glthread_heap_node_t* Root of the melded tree, or NULL.
+ */
+static glthread_heap_node_t *
+glthread_heap_merge_pairs(glthread_heap_t *heap, glthread_heap_node_t *first);
+
 //-----------------< Functions implementation section -----------------/
 void init_glthread(glthread_t *glthread) {
   glthread->left = NULL;  // Set the left pointer of the glthread to NULL
@@ -179,8 +217,8 @@ void glthread_priority_insert(glthread_t *base_glthread, glthread_t *glthread,
       continue;    // Continue to the next iteration
     }
 
-    glthread_add_next(curr,
-                      glthread); // Add the glthread before the current one
+    glthread_add_before(curr,
+                        glthread); // Add the glthread before the current one
     return;
   }
   ITERATE_GLTHREAD_END(base_glthread, curr);
@@ -207,3 +245,127 @@ void *glthread_search(glthread_t *base_glthread,
 
   return NULL; // Return NULL if the key is not found in the linked list
 }
+
+void init_glthread_heap(glthread_heap_t *heap, int (*comp_fn)(void *, void *),
+                        int offset) {
+  heap->root = NULL;
+  heap->count = 0;
+  heap->comp_fn = comp_fn;
+  heap->offset = offset;
+}
+
+void glthread_heap_insert(glthread_heap_t *heap, glthread_heap_node_t *node) {
+  node->child = NULL;
+  node->next = NULL;
+  node->prev = NULL;
+
+  heap->root = heap->root ? glthread_heap_meld(heap, heap->root, node) : node;
+  heap->count++;
+}
+
+glthread_heap_node_t *glthread_heap_pop(glthread_heap_t *heap) {
+  glthread_heap_node_t *root = heap->root;
+
+  if (!root) {
+    return NULL;
+  }
+
+  // The children of the root become the new heap
+  heap->root = glthread_heap_merge_pairs(heap, root->child);
+  heap->count--;
+  root->child = NULL;
+  return root;
+}
+
+void glthread_heap_remove(glthread_heap_t *heap, glthread_heap_node_t *node) {
+  glthread_heap_node_t *subtree = NULL;
+
+  if (node == heap->root) {
+    glthread_heap_pop(heap);
+    return;
+  }
+
+  // Unlink the node from its siblings, or from its parent if it is the first
+  // child
+  if (node->prev->child == node) {
+    node->prev->child = node->next;
+  } else {
+    node->prev->next = node->next;
+  }
+  if (node->next) {
+    node->next->prev = node->prev;
+  }
+  node->next = NULL;
+  node->prev = NULL;
+
+  // Its children stay in the heap
+  subtree = glthread_heap_merge_pairs(heap, node->child);
+  node->child = NULL;
+  if (subtree) {
+    heap->root = glthread_heap_meld(heap, heap->root, subtree);
+  }
+  heap->count--;
+}
+
+static inline int glthread_heap_before(glthread_heap_t *heap,
+                                       glthread_heap_node_t *first,
+                                       glthread_heap_node_t *second) {
+  return heap->comp_fn(GLTHREAD_GET_USER_DATA_FROM_OFFSET(first, heap->offset),
+                       GLTHREAD_GET_USER_DATA_FROM_OFFSET(second,
+                                                          heap->offset)) == -1;
+}
+
+static glthread_heap_node_t *glthread_heap_meld(glthread_heap_t *heap,
+                                                glthread_heap_node_t *first,
+                                                glthread_heap_node_t *second) {
+  glthread_heap_node_t *temp = NULL;
+
+  // Equal priorities keep the first tree on top
+  if (glthread_heap_before(heap, second, first)) {
+    temp = first;
+    first = second;
+    second = temp;
+  }
+
+  // The losing tree becomes the first child of the winning one
+  second->prev = first;
+  second->next = first->child;
+  if (first->child) {
+    first->child->prev = second;
+  }
+  first->child = second;
+  return first;
+}
+
+static glthread_heap_node_t *
+glthread_heap_merge_pairs(glthread_heap_t *heap, glthread_heap_node_t *first) {
+  glthread_heap_node_t *pairs = NULL, *tree = NULL, *next = NULL;
+  glthread_heap_node_t *second = NULL;
+
+  // First pass: meld the siblings two by two, stacking the results
+  while (first) {
+    tree = first;
+    second = first->next;
+    next = second ? second->next : NULL;
+    tree->prev = NULL;
+    tree->next = NULL;
+    if (second) {
+      second->prev = NULL;
+      second->next = NULL;
+      tree = glthread_heap_meld(heap, tree, second);
+    }
+    tree->next = pairs;
+    pairs = tree;
+    first = next;
+  }
+
+  // Second pass: meld the stacked results, from the last pair back
+  tree = NULL;
+  while (pairs) {
+    next = pairs->next;
+    pairs->next = NULL;
+    tree = tree ? glthread_heap_meld(heap, tree, pairs) : pairs;
+    pairs = next;
+  }
+  return tree;
+}
@@ -17,12 +17,25 @@
 
 //-----------------< Includes section -----------------*/
 //---< System includes ---/
+#define _GNU_SOURCE /**< For mremap(). */
 #include <assert.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <memory.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 //---< Project includes ---/
 #include "colors.h"
@@ -61,8 +74,258 @@ static size_t SYSTEM_PAGE_SIZE = 0;
  */
 static vm_page_for_families_t *first_vm_page_for_families = NULL;
 
+/**
+ * @brief Serializes the registration of page families.
+ *
+ * Lookups and walks of the registry take no lock. A page family is fully
+ * initialized before its slot and its hash chain are published with release
+ * stores, and page families are never unregistered, so readers see either
+ * nothing or the complete family.
+ */
+static pthread_mutex_t mm_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Number of page families registered so far.
+ *
+ * Used to hand out `family_id`s, which index the per-thread cache bins.
+ */
+static uint32_t mm_registered_families_count = 0;
+
+/**
+ * @brief Hash index of the registered page families, keyed by struct name.
+ *
+ * Each bucket heads a chain of page families linked through `hash_next`.
+ * Page families are never unregistered, so chains only grow at their head.
+ */
+static vm_page_family_t *mm_family_hash_table[MM_FAMILY_HASH_BUCKETS];
+
+/**
+ * @brief Unused part of the page the free block bins of page families are
+ * carved from, and the lock serializing the families that take bins from it.
+ */
+static char *mm_free_bins_next = NULL;
+static size_t mm_free_bins_left = 0;
+static pthread_mutex_t mm_free_bins_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Global switch for the per-thread allocation cache.
+ *
+ * @see mm_set_thread_cache()
+ */
+static int mm_thread_cache_enabled = 1;
+
+/**
+ * @brief Whether large object spans may be backed by huge pages.
+ *
+ * @see mm_set_large_object_hugepages()
+ */
+static int mm_large_object_hugepages = 0;
+
+/**
+ * @brief Per-thread allocation cache.
+ *
+ * Each thread owns one bin per page family; the bins are accessed without
+ * any locking since no other thread can reach them.
+ */
+static __thread mm_thread_cache_t mm_thread_cache;
+
+/**
+ * @brief Whether the calling thread registered its cache destructor.
+ */
+static __thread int mm_thread_cache_registered = 0;
+
+/**
+ * @brief Whether the calling thread's cache destructor already ran. Objects
+ * freed by later thread-specific data destructors go straight back to their
+ * families, since nothing would flush the cache again.
+ */
+static __thread int mm_thread_cache_torn_down = 0;
+
+/**
+ * @brief Key whose destructor flushes a thread's cache when the thread exits.
+ */
+static pthread_key_t mm_thread_cache_key;
+
+/**
+ * @brief Guards the one-time creation of `mm_thread_cache_key`.
+ */
+static pthread_once_t mm_thread_cache_key_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief High-water marks of the per-family and global page pools.
+ *
+ * @see mm_set_page_pool_limits()
+ */
+static uint32_t mm_family_page_pool_limit = MM_FAMILY_PAGE_POOL_DEFAULT;
+static uint32_t mm_global_page_pool_limit = MM_GLOBAL_PAGE_POOL_DEFAULT;
+
+/**
+ * @brief Empty pages shared by all page families, one pool per NUMA node,
+ * linked through `next`.
+ */
+static vm_page_t *mm_global_page_pool[MM_NUMA_MAX_NODES];
+static uint32_t mm_global_page_pool_count[MM_NUMA_MAX_NODES];
+
+/**
+ * @brief Freed large object spans, one list per NUMA node and span size in
+ * pages, linked through `next`, and the number of pages each node keeps.
+ */
+static vm_page_t *mm_large_span_pool[MM_NUMA_MAX_NODES]
+                                    [MM_LARGE_SPAN_POOL_MAX_UNITS + 1];
+static uint32_t mm_large_span_pool_pages[MM_NUMA_MAX_NODES];
+
+/**
+ * @brief Protects `mm_global_page_pool` and `mm_large_span_pool`. Always
+ * taken after a family lock.
+ */
+static pthread_mutex_t mm_global_page_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Counters of the page retention pool, updated atomically since the
+ * family pools are guarded by different locks.
+ */
+static mm_page_pool_stats_t mm_page_pool_stats;
+
+/**
+ * @brief Bytes handed out without being cleared, either because they were
+ * known to be zero already or because the caller asked for `xmalloc()`.
+ */
+static uint64_t mm_zeroing_bytes_saved = 0;
+
+/**
+ * @brief Counters of `xrealloc()`, updated atomically.
+ */
+static mm_realloc_stats_t mm_realloc_stats;
+
+_Static_assert(offsetof(vm_page_t, page_memory) % MM_MAX_FAMILY_ALIGNMENT == 0,
+               "aligned families need page data aligned on "
+               "MM_MAX_FAMILY_ALIGNMENT");
+
+/**
+ * @brief Number of system pages currently held by all arenas.
+ */
+static uint32_t mm_arena_pages_in_use = 0;
+
+/**
+ * @brief Number of system pages currently mapped from the kernel.
+ */
+static uint64_t mm_pages_mapped = 0;
+
+/**
+ * @brief Sum of the block sizes of all large object spans.
+ */
+static uint64_t mm_large_bytes_in_use = 0;
+
+/**
+ * @brief Allocations and frees published by all threads so far.
+ */
+static uint64_t mm_alloc_count = 0;
+static uint64_t mm_free_count = 0;
+
+/**
+ * @brief Counters as of the previous `mm_get_stats()` call, from which the
+ * allocation and free rates are computed. Protected by `mm_stats_lock`.
+ */
+static struct {
+  double time;
+  uint64_t allocs;
+  uint64_t frees;
+} mm_stats_last;
+static pthread_mutex_t mm_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief State of the statistics dump thread, protected by
+ * `mm_stats_dump_lock`; `mm_stats_dump_cond` wakes the thread up early when
+ * it has to stop.
+ */
+static pthread_t mm_stats_dump_tid;
+static int mm_stats_dump_running = 0;
+static int mm_stats_dump_stopping = 0;
+static int mm_stats_dump_fd = -1;
+static char mm_stats_dump_path[108 + sizeof("unix:")];
+static uint32_t mm_stats_dump_interval_ms = 0;
+static pthread_mutex_t mm_stats_dump_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mm_stats_dump_cond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * @brief Whether allocations are sampled for the heap profile.
+ *
+ * @see mm_heap_profile_start()
+ */
+static int mm_profile_enabled = 0;
+
+/**
+ * @brief Heap profiler state, mapped on the first `mm_heap_profile_start()`
+ * and never unmapped, since frees keep consulting it.
+ */
+static mm_heap_profile_t *mm_heap_profile = NULL;
+static pthread_mutex_t mm_profile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Bounds of the `MM_ALLOC_TEXT` section, set by the linker. Hidden,
+ * so that each library sees its own section.
+ */
+extern char __start_mm_alloc_text[] __attribute__((visibility("hidden")));
+extern char __stop_mm_alloc_text[] __attribute__((visibility("hidden")));
+
+/**
+ * @brief Slab family of the handles of movable objects, registered with the
+ * first movable family.
+ */
+static vm_page_family_t *mm_handle_family = NULL;
+static pthread_once_t mm_handle_family_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Counters of the compactor, updated atomically.
+ */
+static uint64_t mm_moved_objects = 0;
+static uint64_t mm_compacted_pages = 0;
+
+/**
+ * @brief State of the compactor thread, protected by `mm_compactor_lock`;
+ * `mm_compactor_cond` wakes the thread up early when it has to stop.
+ */
+static pthread_t mm_compactor_tid;
+static int mm_compactor_running = 0;
+static int mm_compactor_stopping = 0;
+static uint32_t mm_compactor_interval_ms = 0;
+static uint32_t mm_compactor_threshold = 0;
+static pthread_mutex_t mm_compactor_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mm_compactor_cond = PTHREAD_COND_INITIALIZER;
+
+/**
+ * @brief Number of NUMA nodes kept apart, 1 when NUMA support is disabled.
+ */
+static uint32_t mm_numa_nodes = 1;
+
+/**
+ * @brief Per-node counters, updated atomically.
+ */
+static uint64_t mm_numa_pool_hits[MM_NUMA_MAX_NODES];
+static uint64_t mm_numa_pages_mapped[MM_NUMA_MAX_NODES];
+
+/**
+ * @brief Serializes the creation of the page families of other NUMA nodes.
+ */
+static pthread_mutex_t mm_numa_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Checks of the debug mode, a combination of the `MM_DEBUG_*` flags.
+ */
+static uint32_t mm_debug_flags = MM_DEBUG_DEFAULT_FLAGS;
+
+/**
+ * @brief Set by the first allocation of any thread. Unlike `mm_alloc_count`,
+ * it does not lag behind the counts other threads have not published yet.
+ */
+static int mm_allocations_started = 0;
+
 //-----------------< MemoryManagement Memory Management -----------------*/
-void mm_init() { SYSTEM_PAGE_SIZE = getpagesize(); }
+void mm_init() {
+  SYSTEM_PAGE_SIZE = getpagesize();
+  mm_numa_init();
+  mm_debug_init();
+}
 
 static void *mm_get_new_vm_page_from_kernel(int units) {
   // Use the mmap() system call to allocate memory from the kernel
@@ -76,8 +339,8 @@ static void *mm_get_new_vm_page_from_kernel(int units) {
     return NULL;
   }
 
-  // Initialize the allocated memory block with zeros
-  memset(vm_page, 0, units * SYSTEM_PAGE_SIZE);
+  // Anonymous mappings are zero-filled by the kernel, no need to clear them
+  __atomic_fetch_add(&mm_pages_mapped, units, __ATOMIC_RELAXED);
 
   // Return a pointer to the allocated memory block
   return (void *)vm_page;
@@ -88,107 +351,228 @@ static void mm_return_vm_page_to_kernel(void *vm_page, int units) {
   if (munmap(vm_page, units * SYSTEM_PAGE_SIZE) != 0) {
     // Print an error message if unmapping fails
     printf("Error: Could not munmap VM page to kernel\n");
+    return;
   }
+  __atomic_fetch_sub(&mm_pages_mapped, units, __ATOMIC_RELAXED);
 }
 
-void mm_instantiate_new_page_family(char *struct_name, uint32_t struct_size) {
-  vm_page_family_t *vm_page_family_curr = NULL;
-  vm_page_for_families_t *new_vm_page_for_families = NULL;
-
-  // Check if the size of the memory structure exceeds the system page size
-  if (struct_size > SYSTEM_PAGE_SIZE) {
-    printf("Error: %s() structure %s size exceeds system page size\n",
-           __FUNCTION__, struct_name);
-    return;
+vm_page_family_t *mm_instantiate_new_page_family(char *struct_name,
+                                                 uint32_t struct_size) {
+  pthread_mutex_lock(&mm_registry_lock);
+  vm_page_family_t *vm_page_family = mm_reserve_page_family(struct_name);
+  if (vm_page_family) {
+    mm_publish_page_family(vm_page_family, struct_size);
   }
+  pthread_mutex_unlock(&mm_registry_lock);
 
-  // If there are no existing virtual memory pages, allocate a new page and
-  // initialize it with the first page family
-  if (!first_vm_page_for_families) {
-    first_vm_page_for_families =
-        (vm_page_for_families_t *)mm_get_new_vm_page_from_kernel(1);
-    first_vm_page_for_families->next = NULL;
-    strncpy(first_vm_page_for_families->vm_page_family[0].struct_name,
-            struct_name, MM_MAX_STRUCT_NAME);
-    first_vm_page_for_families->vm_page_family[0].struct_size = struct_size;
-    init_glthread(&first_vm_page_for_families->vm_page_family[0]
-                       .free_block_priority_list_head);
-    return;
-  }
+  return vm_page_family;
+}
 
-  vm_page_family_curr = lookup_page_family_by_name(struct_name);
+static vm_page_family_t *mm_reserve_page_family(char *struct_name) {
+  vm_page_for_families_t *families_page = mm_first_families_page();
+  vm_page_family_t *vm_page_family_curr = NULL;
+  uint32_t count = 0;
 
   // Trigger an assertion error if a page family with the same name already
   // exists
-  if (vm_page_family_curr) {
+  if (lookup_page_family_by_name(struct_name)) {
     assert(0);
   }
 
-  uint32_t count = 0;
-
-  // Iterate over existing page families to check if a page family with the same
-  // name already exists
-  ITERATE_PAGE_FAMILIES_BEGIN(first_vm_page_for_families, vm_page_family_curr) {
-    if (strncmp(vm_page_family_curr->struct_name, struct_name,
-                MM_MAX_STRUCT_NAME) != 0) {
+  // Families fill the slots of the first families page in order
+  if (families_page) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
       count++;
     }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
+  }
+
+  // If there is no families page or the first one is full, allocate a new
+  // page and add it to the beginning of the linked list. Its slots are all
+  // empty, so readers may see it right away.
+  if (!families_page || count == (uint32_t)MAX_FAMILIES_PER_VM_PAGE) {
+    families_page = (vm_page_for_families_t *)mm_get_new_vm_page_from_kernel(1);
+    if (!families_page) {
+      return NULL;
+    }
+    families_page->next = first_vm_page_for_families;
+    __atomic_store_n(&first_vm_page_for_families, families_page,
+                     __ATOMIC_RELEASE);
+    count = 0;
+  }
+
+  return mm_init_page_family(&families_page->vm_page_family[count],
+                             struct_name);
+}
+
+vm_page_family_t *mm_instantiate_new_slab_family(char *struct_name,
+                                                 uint32_t struct_size) {
+  uint32_t slot_size, slots_per_page;
+
+  pthread_mutex_lock(&mm_registry_lock);
+  vm_page_family_t *vm_page_family = mm_reserve_page_family(struct_name);
+  if (!vm_page_family) {
+    pthread_mutex_unlock(&mm_registry_lock);
+    return NULL;
+  }
+
+  // Free slots store the freelist link, and slots keep the block alignment
+  slot_size = struct_size < sizeof(void *) ? sizeof(void *) : struct_size;
+  slot_size = (slot_size + MM_BLOCK_ALIGNMENT - 1) & ~(MM_BLOCK_ALIGNMENT - 1);
+  slots_per_page = mm_max_page_allocatable_memory(1) / slot_size;
+
+  // Slabs only pay off when several objects share a page
+  if (slots_per_page < 2) {
+    printf("Warning: %s is too large for slab mode, using regular pages\n",
+           struct_name);
+  } else {
+    vm_page_family->slab_slot_size = slot_size;
+    vm_page_family->slab_slots_per_page = slots_per_page;
+    vm_page_family->is_slab = MM_TRUE;
+  }
+
+  mm_publish_page_family(vm_page_family, struct_size);
+  pthread_mutex_unlock(&mm_registry_lock);
+  return vm_page_family;
+}
+
+vm_page_family_t *mm_instantiate_new_aligned_page_family(char *struct_name,
+                                                         uint32_t struct_size,
+                                                         uint32_t alignment) {
+  if (alignment & (alignment - 1) || alignment > MM_MAX_FAMILY_ALIGNMENT) {
+    printf("Error: Unsupported alignment %u for %s\n", alignment, struct_name);
+    return NULL;
   }
-  ITERATE_PAGE_FAMILIES_END(first_vm_page_for_families, vm_page_family_curr);
 
-  // If the existing page is full, allocate a new page and add it to the
-  // beginning of the linked list
-  if (count == (uint32_t)MAX_FAMILIES_PER_VM_PAGE) {
-    new_vm_page_for_families =
-        (vm_page_for_families_t *)mm_get_new_vm_page_from_kernel(1);
-    new_vm_page_for_families->next = first_vm_page_for_families;
-    first_vm_page_for_families = new_vm_page_for_families;
-    vm_page_family_curr = &first_vm_page_for_families->vm_page_family[0];
+  pthread_mutex_lock(&mm_registry_lock);
+  vm_page_family_t *vm_page_family = mm_reserve_page_family(struct_name);
+  if (vm_page_family) {
+    if (alignment > vm_page_family->alignment) {
+      vm_page_family->alignment = alignment;
+    }
+    mm_publish_page_family(vm_page_family, struct_size);
   }
+  pthread_mutex_unlock(&mm_registry_lock);
+  return vm_page_family;
+}
 
-  // Initialize the new page family with the specified name and size
-  strncpy(vm_page_family_curr->struct_name, struct_name, MM_MAX_STRUCT_NAME);
-  vm_page_family_curr->struct_size = struct_size;
+static vm_page_family_t *mm_init_page_family(vm_page_family_t *vm_page_family,
+                                             char *struct_name) {
+  // Initialize the new page family with the specified name, its size is only
+  // set when it is published
+  strncpy(vm_page_family->struct_name, struct_name, MM_MAX_STRUCT_NAME);
+  vm_page_family->alignment = MM_BLOCK_ALIGNMENT;
+  vm_page_family->family_id = mm_registered_families_count++;
+  pthread_mutex_init(&vm_page_family->family_lock, NULL);
 
   // Set the 'first_page' pointer of the current page family to NULL
   // This indicates that there are no associated virtual memory pages with this
   // page family yet
-  vm_page_family_curr->first_page = NULL;
+  vm_page_family->first_page = NULL;
+  vm_page_family->first_large_page = NULL;
+  vm_page_family->is_slab = MM_FALSE;
+  vm_page_family->slab_slot_size = 0;
+  vm_page_family->slab_slots_per_page = 0;
+  vm_page_family->slab_partial_pages = NULL;
+  vm_page_family->slab_full_pages = NULL;
+  vm_page_family->retained_pages = NULL;
+  vm_page_family->retained_count = 0;
+  vm_page_family->data_pages = 0;
+  vm_page_family->slab_used_slots = 0;
+  vm_page_family->free_block_count = 0;
+  vm_page_family->free_bytes = 0;
+  vm_page_family->placement = MM_PLACEMENT_SEGREGATED;
+  vm_page_family->next_fit_cursor = 0;
+  vm_page_family->is_movable = MM_FALSE;
+  vm_page_family->numa_node = 0;
+  vm_page_family->numa_parent = NULL;
+  memset(vm_page_family->numa_families, 0,
+         sizeof(vm_page_family->numa_families));
 
-  // Initialize the glthread_t structure within the first virtual memory page
-  init_glthread(&first_vm_page_for_families->vm_page_family[0]
-                     .free_block_priority_list_head);
+  // Initialize the free block bins of the new page family
+  mm_init_free_bins(vm_page_family);
+
+  return vm_page_family;
 }
 
-vm_page_family_t *lookup_page_family_by_name(char *struct_name) {
-  // Pointer to iterate over VM pages
-  vm_page_for_families_t *current_page = first_vm_page_for_families;
+static void mm_publish_page_family(vm_page_family_t *vm_page_family,
+                                   uint32_t struct_size) {
+  // A non-zero size marks the slot as used for the walks of the families
+  // pages
+  __atomic_store_n(&vm_page_family->struct_size, struct_size,
+                   __ATOMIC_RELEASE);
 
-  // Iterate over all VM pages containing page families
-  while (current_page != NULL) {
-    // Pointer to iterate over page families within the current VM page
-    vm_page_family_t *vm_page_family_curr = NULL;
+  // Make the page family reachable by name
+  uint32_t bucket =
+      mm_family_name_hash(vm_page_family->struct_name) % MM_FAMILY_HASH_BUCKETS;
+  vm_page_family->hash_next = mm_family_hash_table[bucket];
+  __atomic_store_n(&mm_family_hash_table[bucket], vm_page_family,
+                   __ATOMIC_RELEASE);
+}
 
-    // Iterate over page families within the current VM page
-    ITERATE_PAGE_FAMILIES_BEGIN(current_page, vm_page_family_curr) {
-      // Check if the name of the current page family matches the provided
-      // struct_name
-      if (strncmp(vm_page_family_curr->struct_name, struct_name,
-                  MM_MAX_STRUCT_NAME) == 0) {
-        // If a match is found, return the pointer to the page family object
-        return vm_page_family_curr;
-      }
-    }
-    ITERATE_PAGE_FAMILIES_END(current_page, vm_page_family_curr);
+static inline uint32_t mm_family_name_hash(const char *struct_name) {
+  // 32-bit FNV-1a over the significant part of the name
+  uint32_t hash = 2166136261u;
+  uint32_t i;
+
+  for (i = 0; i < MM_MAX_STRUCT_NAME && struct_name[i]; i++) {
+    hash ^= (uint8_t)struct_name[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
 
-    // Move to the next VM page
-    current_page = current_page->next;
+vm_page_family_t *lookup_page_family_by_name(char *struct_name) {
+  uint32_t bucket = mm_family_name_hash(struct_name) % MM_FAMILY_HASH_BUCKETS;
+  vm_page_family_t *vm_page_family_curr =
+      __atomic_load_n(&mm_family_hash_table[bucket], __ATOMIC_ACQUIRE);
+
+  // Walk the bucket's chain, usually a single page family. Chains only grow
+  // at their head, so the links behind a published family never change.
+  for (; vm_page_family_curr;
+       vm_page_family_curr = vm_page_family_curr->hash_next) {
+    if (strncmp(vm_page_family_curr->struct_name, struct_name,
+                MM_MAX_STRUCT_NAME) == 0) {
+      return vm_page_family_curr;
+    }
   }
 
   // If no matching page family is found, return NULL
   return NULL;
 }
 
+static inline vm_page_for_families_t *mm_first_families_page(void) {
+  return __atomic_load_n(&first_vm_page_for_families, __ATOMIC_ACQUIRE);
+}
+
+vm_page_family_t *mm_get_page_family(char *struct_name, uint32_t struct_size) {
+  vm_page_family_t *vm_page_family = lookup_page_family_by_name(struct_name);
+
+  // Threads racing to register the same structure agree on one page family
+  if (!vm_page_family) {
+    pthread_mutex_lock(&mm_registry_lock);
+    vm_page_family = lookup_page_family_by_name(struct_name);
+    if (!vm_page_family) {
+      vm_page_family = mm_reserve_page_family(struct_name);
+      if (vm_page_family) {
+        mm_publish_page_family(vm_page_family, struct_size);
+      }
+    }
+    pthread_mutex_unlock(&mm_registry_lock);
+    if (!vm_page_family || vm_page_family->struct_size == struct_size) {
+      return vm_page_family;
+    }
+  }
+
+  // Another structure registered under the same name would be overrun
+  if (vm_page_family->struct_size != struct_size) {
+    printf("Error: Structure %s registered with size %u, not %u\n",
+           struct_name, vm_page_family->struct_size, struct_size);
+    return NULL;
+  }
+  return vm_page_family;
+}
+
 static vm_page_t *mm_family_new_page_add(vm_page_family_t *vm_page_family) {
 
   // Allocate a new virtual memory page for the page family
@@ -210,8 +594,8 @@ static vm_page_t *mm_family_new_page_add(vm_page_family_t *vm_page_family) {
 vm_bool_t mm_is_vm_page_empty(vm_page_t *vm_page) {
   if (vm_page != NULL) {
     // Check if all conditions for an empty page are met
-    if (vm_page->block_meta_data.next_block == NULL &&
-        vm_page->block_meta_data.prev_block == NULL &&
+    if (vm_page->block_meta_data.next_offset == 0 &&
+        vm_page->block_meta_data.prev_offset == 0 &&
         vm_page->block_meta_data.is_free == MM_TRUE) {
       return MM_TRUE;
     }
@@ -219,14 +603,31 @@ vm_bool_t mm_is_vm_page_empty(vm_page_t *vm_page) {
   return MM_FALSE;
 }
 
+static inline uint32_t mm_block_size_round(vm_page_family_t *vm_page_family,
+                                           uint32_t size) {
+  uint32_t alignment = vm_page_family->alignment;
+
+  if (size < MM_MIN_BLOCK_SIZE) {
+    size = MM_MIN_BLOCK_SIZE;
+  }
+  return ((size + sizeof(block_meta_data_t) + alignment - 1) &
+          ~(alignment - 1)) -
+         sizeof(block_meta_data_t);
+}
+
 static inline uint32_t mm_max_page_allocatable_memory(int units) {
   return (uint32_t)((SYSTEM_PAGE_SIZE * units) -
                     offset_of(vm_page_t, page_memory));
 }
 
 vm_page_t *allocate_vm_page(vm_page_family_t *vm_page_family) {
-  // Allocate memory for the new virtual memory page
-  vm_page_t *vm_page = mm_get_new_vm_page_from_kernel(1);
+  // The blocks of the page need somewhere to be freed to
+  if (!mm_allocate_free_bins(vm_page_family)) {
+    return NULL;
+  }
+
+  // Reuse a retained empty page when possible
+  vm_page_t *vm_page = mm_page_pool_acquire(vm_page_family);
 
   // If the virtual memory page is NULL, return NULL
   if (!vm_page) {
@@ -240,15 +641,17 @@ vm_page_t *allocate_vm_page(vm_page_family_t *vm_page_family) {
   vm_page->block_meta_data.block_size = mm_max_page_allocatable_memory(1);
   vm_page->block_meta_data.offset = offset_of(vm_page_t, block_meta_data);
 
-  // Initialize the priority thread glue
-  init_glthread(&vm_page->block_meta_data.priority_thread_glue);
-
   // Initialize next and prev pointers of the page
   vm_page->next = NULL;
   vm_page->prev = NULL;
 
   // Set the back pointer to page family
   vm_page->pg_family = vm_page_family;
+  vm_page->page_kind = MM_PAGE_BLOCKS;
+  vm_page->units = 1;
+  vm_page->is_hugetlb = MM_FALSE;
+  vm_page->is_evacuating = MM_FALSE;
+  vm_page_family->data_pages++;
 
   // If it is the first VM data page for a given page family
   if (!vm_page_family->first_page) {
@@ -263,9 +666,113 @@ vm_page_t *allocate_vm_page(vm_page_family_t *vm_page_family) {
   return vm_page;
 }
 
+static block_meta_data_t *
+mm_allocate_large_block(vm_page_family_t *vm_page_family, uint32_t req_size,
+                        uint32_t *dirty_size) {
+  vm_page_t *vm_page = NULL;
+  size_t span_size = offset_of(vm_page_t, page_memory) + (size_t)req_size;
+  uint32_t units = (span_size + SYSTEM_PAGE_SIZE - 1) / SYSTEM_PAGE_SIZE;
+  vm_bool_t is_hugetlb = MM_FALSE;
+
+  *dirty_size = 0;
+  if (units <= MM_LARGE_SPAN_POOL_MAX_UNITS) {
+    units = mm_large_span_units(units);
+    vm_page = mm_large_span_pool_acquire(vm_page_family->numa_node, units,
+                                         dirty_size);
+    if (vm_page) {
+      units = vm_page->units;
+    }
+    if (*dirty_size > req_size) {
+      *dirty_size = req_size;
+    }
+  }
+
+#ifdef MAP_HUGETLB
+  // Spans worth at least one huge page try huge pages first, and silently
+  // fall back to regular pages when none are reserved
+  if (!vm_page &&
+      __atomic_load_n(&mm_large_object_hugepages, __ATOMIC_RELAXED) &&
+      span_size >= MM_HUGE_PAGE_SIZE) {
+    size_t huge_span_size =
+        (span_size + MM_HUGE_PAGE_SIZE - 1) & ~(MM_HUGE_PAGE_SIZE - 1);
+    void *span = mmap(NULL, huge_span_size, PROT_READ | PROT_WRITE,
+                      MAP_ANON | MAP_PRIVATE | MAP_HUGETLB, -1, 0);
+    if (span != MAP_FAILED) {
+      vm_page = (vm_page_t *)span;
+      units = huge_span_size / SYSTEM_PAGE_SIZE;
+      is_hugetlb = MM_TRUE;
+      __atomic_fetch_add(&mm_pages_mapped, units, __ATOMIC_RELAXED);
+    }
+  }
+#endif
+
+  if (!vm_page) {
+    vm_page = mm_get_new_vm_page_from_kernel(units);
+    if (!vm_page) {
+      return NULL;
+    }
+    mm_numa_bind(vm_page, (size_t)units * SYSTEM_PAGE_SIZE,
+                 vm_page_family->numa_node);
+  }
+
+  vm_page->pg_family = vm_page_family;
+  vm_page->page_kind = MM_PAGE_LARGE;
+  vm_page->units = units;
+  vm_page->is_hugetlb = is_hugetlb;
+  vm_page->numa_node = vm_page_family->numa_node;
+
+  // A single allocated block covers the whole span
+  vm_page->block_meta_data.is_free = MM_FALSE;
+  vm_page->block_meta_data.block_size = req_size;
+  vm_page->block_meta_data.offset = offset_of(vm_page_t, block_meta_data);
+  vm_page->block_meta_data.prev_offset = 0;
+  vm_page->block_meta_data.prev_free = MM_FALSE;
+  vm_page->block_meta_data.next_offset = 0;
+  __atomic_fetch_add(&mm_large_bytes_in_use, req_size, __ATOMIC_RELAXED);
+
+  // Insert the span at the head of the family's large object list
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  vm_page->prev = NULL;
+  vm_page->next = vm_page_family->first_large_page;
+  if (vm_page->next) {
+    vm_page->next->prev = vm_page;
+  }
+  vm_page_family->first_large_page = vm_page;
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  return &vm_page->block_meta_data;
+}
+
+static void mm_free_large_block(vm_page_t *vm_page) {
+  vm_page_family_t *vm_page_family = vm_page->pg_family;
+
+  // Unlink the span from the family's large object list
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  if (vm_page->prev) {
+    vm_page->prev->next = vm_page->next;
+  } else {
+    vm_page_family->first_large_page = vm_page->next;
+  }
+  if (vm_page->next) {
+    vm_page->next->prev = vm_page->prev;
+  }
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  __atomic_fetch_sub(&mm_large_bytes_in_use,
+                     vm_page->block_meta_data.block_size, __ATOMIC_RELAXED);
+  if (!mm_large_span_pool_release(vm_page)) {
+    mm_return_vm_page_to_kernel((void *)vm_page, vm_page->units);
+  }
+}
+
+void mm_set_large_object_hugepages(int enable) {
+  __atomic_store_n(&mm_large_object_hugepages, enable, __ATOMIC_RELAXED);
+}
+
 void mm_vm_page_delete_and_free(vm_page_t *vm_page) {
   // Retrieve the page family of the virtual memory page
   vm_page_family_t *vm_page_family = vm_page->pg_family;
+  vm_page_family->data_pages--;
 
   // If the page being deleted is the head of the linked list
   if (vm_page_family->first_page == vm_page) {
@@ -275,7 +782,7 @@ void mm_vm_page_delete_and_free(vm_page_t *vm_page) {
     }
     vm_page->next = NULL;
     vm_page->prev = NULL;
-    mm_return_vm_page_to_kernel((void *)vm_page, 1);
+    mm_page_pool_release(vm_page);
     return;
   }
 
@@ -283,328 +790,3629 @@ void mm_vm_page_delete_and_free(vm_page_t *vm_page) {
   if (vm_page->next)
     vm_page->next->prev = vm_page->prev;
   vm_page->prev->next = vm_page->next;
+  mm_page_pool_release(vm_page);
+}
+
+//-----------------< PagePool Page Retention Pool -----------------*/
+static vm_page_t *mm_page_pool_acquire(vm_page_family_t *vm_page_family) {
+  vm_page_t *vm_page = vm_page_family ? vm_page_family->retained_pages : NULL;
+  uint32_t node =
+      vm_page_family ? vm_page_family->numa_node : mm_numa_current_node();
+
+  // The family's own pool needs no extra locking
+  if (vm_page) {
+    vm_page_family->retained_pages = vm_page->next;
+    vm_page_family->retained_count--;
+  } else {
+    // Pages of other nodes are left alone, remote memory is what the
+    // per-node pools avoid
+    pthread_mutex_lock(&mm_global_page_pool_lock);
+    vm_page = mm_global_page_pool[node];
+    if (vm_page) {
+      mm_global_page_pool[node] = vm_page->next;
+      mm_global_page_pool_count[node]--;
+    }
+    pthread_mutex_unlock(&mm_global_page_pool_lock);
+  }
+
+  if (vm_page) {
+    __atomic_fetch_add(&mm_page_pool_stats.hits, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&mm_page_pool_stats.retained, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&mm_numa_pool_hits[node], 1, __ATOMIC_RELAXED);
+    // Nothing is known about the content of a reused page
+    vm_page->zero_watermark = SYSTEM_PAGE_SIZE;
+    return vm_page;
+  }
+
+  __atomic_fetch_add(&mm_page_pool_stats.misses, 1, __ATOMIC_RELAXED);
+  vm_page = mm_get_new_vm_page_from_kernel(1);
+  if (vm_page) {
+    mm_numa_bind(vm_page, SYSTEM_PAGE_SIZE, node);
+    vm_page->numa_node = node;
+    vm_page->zero_watermark = offset_of(vm_page_t, page_memory);
+  }
+  return vm_page;
+}
+
+static void mm_page_pool_release(vm_page_t *vm_page) {
+  vm_page_family_t *vm_page_family = vm_page->pg_family;
+  uint32_t node = vm_page->numa_node;
+
+  if (vm_page_family &&
+      vm_page_family->retained_count <
+          __atomic_load_n(&mm_family_page_pool_limit, __ATOMIC_RELAXED)) {
+    vm_page->next = vm_page_family->retained_pages;
+    vm_page_family->retained_pages = vm_page;
+    vm_page_family->retained_count++;
+    __atomic_fetch_add(&mm_page_pool_stats.retained, 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  if (mm_global_page_pool_count[node] < mm_global_page_pool_limit) {
+    vm_page->next = mm_global_page_pool[node];
+    mm_global_page_pool[node] = vm_page;
+    mm_global_page_pool_count[node]++;
+    pthread_mutex_unlock(&mm_global_page_pool_lock);
+    __atomic_fetch_add(&mm_page_pool_stats.retained, 1, __ATOMIC_RELAXED);
+    return;
+  }
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+
+  // Both pools are at their high-water mark
+  __atomic_fetch_add(&mm_page_pool_stats.released, 1, __ATOMIC_RELAXED);
   mm_return_vm_page_to_kernel((void *)vm_page, 1);
 }
 
-//-----------------< FreeVMPageBlock Free VM Page/Block -----------------/
-static void mm_union_free_blocks(block_meta_data_t *first,
-                                 block_meta_data_t *second) {
-  // Ensure that both blocks are free
-  assert(first->is_free == MM_TRUE && second->is_free == MM_TRUE);
+static uint32_t mm_page_pool_trim_to(uint32_t family_keep,
+                                     uint32_t global_keep) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
+  vm_page_t *victims = NULL;
+  vm_page_t *large_victims = NULL;
+  vm_page_t *vm_page;
+  uint32_t released = 0;
+  uint32_t node, units;
 
-  // Check if the two blocks are contiguous
-  if (first->next_block == second && second->prev_block == first) {
-    // Merge the blocks by updating the size and pointers
-    first->block_size += sizeof(block_meta_data_t) + second->block_size;
-    first->next_block = second->next_block;
+  // Detach the excess pages under the locks, unmap them afterwards
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      pthread_mutex_lock(&vm_page_family_curr->family_lock);
+      while (vm_page_family_curr->retained_count > family_keep) {
+        vm_page = vm_page_family_curr->retained_pages;
+        vm_page_family_curr->retained_pages = vm_page->next;
+        vm_page_family_curr->retained_count--;
+        vm_page->next = victims;
+        victims = vm_page;
+      }
+      pthread_mutex_unlock(&vm_page_family_curr->family_lock);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
+  }
 
-    // Update the previous block pointer of the next block if it exists
-    if (second->next_block != NULL) {
-      second->next_block->prev_block = first;
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  for (node = 0; node < MM_NUMA_MAX_NODES; node++) {
+    while (mm_global_page_pool_count[node] > global_keep) {
+      vm_page = mm_global_page_pool[node];
+      mm_global_page_pool[node] = vm_page->next;
+      mm_global_page_pool_count[node]--;
+      vm_page->next = victims;
+      victims = vm_page;
     }
-  } else {
-    // Error message if blocks are not contiguous
-    printf("Error: mm_union_free_blocks - Attempting to merge non-contiguous "
-           "free blocks\n");
+    // Large spans go largest first, they are the least likely to be reused
+    for (units = MM_LARGE_SPAN_POOL_MAX_UNITS;
+         units > 0 && mm_large_span_pool_pages[node] >
+                          global_keep * MM_LARGE_SPAN_POOL_SCALE;
+         units--) {
+      while (mm_large_span_pool[node][units] &&
+             mm_large_span_pool_pages[node] >
+                 global_keep * MM_LARGE_SPAN_POOL_SCALE) {
+        vm_page = mm_large_span_pool[node][units];
+        mm_large_span_pool[node][units] = vm_page->next;
+        mm_large_span_pool_pages[node] -= units;
+        vm_page->next = large_victims;
+        large_victims = vm_page;
+      }
+    }
+  }
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+
+  while (victims) {
+    vm_page = victims;
+    victims = vm_page->next;
+    mm_return_vm_page_to_kernel((void *)vm_page, 1);
+    released++;
+  }
+  // Large spans are not counted as retained, their pages are as released
+  __atomic_fetch_sub(&mm_page_pool_stats.retained, released, __ATOMIC_RELAXED);
+
+  while (large_victims) {
+    vm_page = large_victims;
+    large_victims = vm_page->next;
+    released += vm_page->units;
+    mm_return_vm_page_to_kernel((void *)vm_page, vm_page->units);
+  }
+  __atomic_fetch_add(&mm_page_pool_stats.released, released, __ATOMIC_RELAXED);
+  return released;
+}
+
+static vm_page_t *mm_large_span_pool_acquire(uint32_t node, uint32_t units,
+                                             uint32_t *dirty_size) {
+  uint32_t max_units = mm_large_span_units(units + 1);
+  vm_page_t *vm_page = NULL;
+
+  // A span up to the next pool size is close enough
+  if (max_units > MM_LARGE_SPAN_POOL_MAX_UNITS) {
+    max_units = MM_LARGE_SPAN_POOL_MAX_UNITS;
+  }
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  for (; !vm_page && units <= max_units; units++) {
+    vm_page = mm_large_span_pool[node][units];
+  }
+  if (vm_page) {
+    mm_large_span_pool[node][vm_page->units] = vm_page->next;
+    mm_large_span_pool_pages[node] -= vm_page->units;
+  }
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+
+  // Nothing is known about the content of a reused span
+  if (vm_page) {
+    *dirty_size =
+        vm_page->units * SYSTEM_PAGE_SIZE - offset_of(vm_page_t, page_memory);
+  }
+  return vm_page;
+}
+
+static vm_bool_t mm_large_span_pool_release(vm_page_t *vm_page) {
+  uint32_t node = vm_page->numa_node;
+  uint32_t units = vm_page->units;
+
+  if (vm_page->is_hugetlb || units > MM_LARGE_SPAN_POOL_MAX_UNITS) {
+    return MM_FALSE;
+  }
+
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  if (mm_large_span_pool_pages[node] + units >
+      mm_global_page_pool_limit * MM_LARGE_SPAN_POOL_SCALE) {
+    pthread_mutex_unlock(&mm_global_page_pool_lock);
+    return MM_FALSE;
+  }
+  vm_page->next = mm_large_span_pool[node][units];
+  mm_large_span_pool[node][units] = vm_page;
+  mm_large_span_pool_pages[node] += units;
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+  return MM_TRUE;
+}
+
+void mm_set_page_pool_limits(uint32_t family_pages, uint32_t global_pages) {
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  __atomic_store_n(&mm_family_page_pool_limit, family_pages, __ATOMIC_RELAXED);
+  mm_global_page_pool_limit = global_pages;
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+
+  mm_page_pool_trim_to(family_pages, global_pages);
+}
+
+static uint32_t mm_large_span_units(uint32_t units) {
+  uint32_t step, rounded;
+
+  if (units <= 4 || units > MM_LARGE_SPAN_POOL_MAX_UNITS) {
+    return units;
+  }
+  step = 1u << (29 - __builtin_clz(units));
+  rounded = (units + step - 1) & ~(step - 1);
+  return rounded <= MM_LARGE_SPAN_POOL_MAX_UNITS ? rounded : units;
+}
+
+static uint32_t mm_large_span_trim_tails(void) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
+  vm_page_t *vm_page;
+  uint32_t released = 0;
+  uint32_t units;
+
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      pthread_mutex_lock(&vm_page_family_curr->family_lock);
+      for (vm_page = vm_page_family_curr->first_large_page; vm_page;
+           vm_page = vm_page->next) {
+        units = (offset_of(vm_page_t, page_memory) +
+                 (size_t)vm_page->block_meta_data.block_size +
+                 SYSTEM_PAGE_SIZE - 1) /
+                SYSTEM_PAGE_SIZE;
+        // Huge page spans can only be unmapped as a whole
+        if (vm_page->is_hugetlb || units >= vm_page->units) {
+          continue;
+        }
+        mm_return_vm_page_to_kernel((char *)vm_page + units * SYSTEM_PAGE_SIZE,
+                                    vm_page->units - units);
+        released += vm_page->units - units;
+        vm_page->units = units;
+      }
+      pthread_mutex_unlock(&vm_page_family_curr->family_lock);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
+  }
+
+  __atomic_fetch_add(&mm_page_pool_stats.released, released, __ATOMIC_RELAXED);
+  return released;
+}
+
+uint32_t mm_trim() {
+  return mm_page_pool_trim_to(0, 0) + mm_large_span_trim_tails();
+}
+
+//-----------------< NUMA Per-node page families -----------------/
+static void mm_numa_init(void) {
+  char buf[256];
+  char *curr = buf;
+  uint32_t nodes = 1;
+  ssize_t len;
+
+  int fd = open("/sys/devices/system/node/online", O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  len = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if (len <= 0) {
+    return;
+  }
+  buf[len] = '\0';
+
+  // A list of node ranges such as "0-1,3"; the highest node sets the count
+  while (*curr >= '0' && *curr <= '9') {
+    uint32_t node = strtoul(curr, &curr, 10);
+    if (node + 1 > nodes) {
+      nodes = node + 1;
+    }
+    if (*curr == '-' || *curr == ',') {
+      curr++;
+    }
+  }
+  mm_numa_nodes = nodes < MM_NUMA_MAX_NODES ? nodes : MM_NUMA_MAX_NODES;
+}
+
+static inline uint32_t mm_numa_current_node(void) {
+  unsigned int cpu, node;
+
+  if (__builtin_expect(mm_numa_nodes == 1, 1)) {
+    return 0;
+  }
+  if (mm_thread_cache.numa_countdown) {
+    mm_thread_cache.numa_countdown--;
+    return mm_thread_cache.numa_node;
+  }
+
+  // Threads migrate rarely, the node is only looked up now and then
+  mm_thread_cache.numa_countdown = MM_NUMA_REFRESH_OPS - 1;
+  if (syscall(SYS_getcpu, &cpu, &node, NULL) != 0 || node >= mm_numa_nodes) {
+    node = 0;
+  }
+  mm_thread_cache.numa_node = node;
+  return node;
+}
+
+static inline vm_page_family_t *
+mm_numa_family(vm_page_family_t *vm_page_family) {
+  if (__builtin_expect(mm_numa_nodes == 1, 1)) {
+    return vm_page_family;
+  }
+
+  // Objects found through their page may belong to another node's family
+  if (vm_page_family->numa_parent) {
+    vm_page_family = vm_page_family->numa_parent;
+  }
+  uint32_t node = mm_numa_current_node();
+  if (!node) {
+    return vm_page_family;
+  }
+
+  vm_page_family_t *node_family = __atomic_load_n(
+      &vm_page_family->numa_families[node], __ATOMIC_ACQUIRE);
+  if (!node_family) {
+    node_family = mm_numa_family_create(vm_page_family, node);
+  }
+  return node_family ? node_family : vm_page_family;
+}
+
+static vm_page_family_t *mm_numa_family_create(vm_page_family_t *vm_page_family,
+                                               uint32_t node) {
+  char struct_name[MM_MAX_STRUCT_NAME];
+  vm_page_family_t *node_family;
+
+  pthread_mutex_lock(&mm_numa_lock);
+  node_family = vm_page_family->numa_families[node];
+  if (node_family) {
+    pthread_mutex_unlock(&mm_numa_lock);
+    return node_family;
+  }
+
+  // The name is shortened if needed to keep the node suffix
+  snprintf(struct_name, sizeof(struct_name), "%.*s@%c",
+           (int)(MM_MAX_STRUCT_NAME - 3), vm_page_family->struct_name,
+           '0' + node);
+  pthread_mutex_lock(&mm_registry_lock);
+  if (lookup_page_family_by_name(struct_name)) {
+    pthread_mutex_unlock(&mm_registry_lock);
+    pthread_mutex_unlock(&mm_numa_lock);
+    printf("Error: %s is already registered, %s stays on node 0\n",
+           struct_name, vm_page_family->struct_name);
+    return NULL;
+  }
+
+  node_family = mm_reserve_page_family(struct_name);
+  if (node_family) {
+    node_family->alignment = vm_page_family->alignment;
+    node_family->is_slab = vm_page_family->is_slab;
+    node_family->slab_slot_size = vm_page_family->slab_slot_size;
+    node_family->slab_slots_per_page = vm_page_family->slab_slots_per_page;
+    node_family->is_movable = vm_page_family->is_movable;
+    node_family->placement = vm_page_family->placement;
+    node_family->numa_node = node;
+    node_family->numa_parent = vm_page_family;
+    mm_publish_page_family(node_family, vm_page_family->struct_size);
+  }
+  pthread_mutex_unlock(&mm_registry_lock);
+  if (node_family) {
+    __atomic_store_n(&vm_page_family->numa_families[node], node_family,
+                     __ATOMIC_RELEASE);
+  }
+  pthread_mutex_unlock(&mm_numa_lock);
+
+  return node_family;
+}
+
+static void mm_numa_bind(void *addr, size_t size, uint32_t node) {
+  unsigned long nodemask = 1UL << node;
+
+  __atomic_fetch_add(&mm_numa_pages_mapped[node], size / SYSTEM_PAGE_SIZE,
+                     __ATOMIC_RELAXED);
+  if (mm_numa_nodes == 1) {
+    return;
+  }
+
+  // A policy the kernel refuses only loses the placement, the mapping itself
+  // stays usable
+  syscall(SYS_mbind, addr, size, MM_MPOL_PREFERRED, &nodemask,
+          sizeof(nodemask) * 8, 0);
+}
+
+uint32_t mm_numa_node_count() { return mm_numa_nodes; }
+
+int mm_get_numa_stats(uint32_t node, mm_numa_stats_t *stats) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
+
+  if (node >= mm_numa_nodes) {
+    printf("Error: %s() called with node %u of %u\n", __FUNCTION__, node,
+           mm_numa_nodes);
+    return -1;
+  }
+  memset(stats, 0, sizeof(*stats));
+
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      if (vm_page_family_curr->numa_node == node) {
+        pthread_mutex_lock(&vm_page_family_curr->family_lock);
+        stats->data_pages += vm_page_family_curr->data_pages;
+        stats->retained_pages += vm_page_family_curr->retained_count;
+        stats->bytes_in_use +=
+            mm_family_bytes_in_use_locked(vm_page_family_curr);
+        pthread_mutex_unlock(&vm_page_family_curr->family_lock);
+      }
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
+  }
+
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  stats->retained_pages +=
+      mm_global_page_pool_count[node] + mm_large_span_pool_pages[node];
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+  stats->pool_hits =
+      __atomic_load_n(&mm_numa_pool_hits[node], __ATOMIC_RELAXED);
+  stats->pages_mapped_total =
+      __atomic_load_n(&mm_numa_pages_mapped[node], __ATOMIC_RELAXED);
+
+  return 0;
+}
+
+//-----------------< Arena Bump-pointer arenas -----------------*/
+static vm_page_t *mm_arena_page_acquire() {
+  vm_page_t *vm_page = mm_page_pool_acquire(NULL);
+
+  if (!vm_page) {
+    return NULL;
+  }
+
+  vm_page->next = NULL;
+  vm_page->prev = NULL;
+  vm_page->pg_family = NULL;
+  vm_page->page_kind = MM_PAGE_ARENA;
+  vm_page->units = 1;
+  vm_page->is_hugetlb = MM_FALSE;
+  __atomic_fetch_add(&mm_arena_pages_in_use, 1, __ATOMIC_RELAXED);
+
+  return vm_page;
+}
+
+mm_arena_t *arena_create() {
+  vm_page_t *vm_page = mm_arena_page_acquire();
+  mm_arena_t *arena;
+
+  if (!vm_page) {
+    return NULL;
+  }
+
+  // The arena lives at the start of its home page
+  arena = (mm_arena_t *)vm_page->page_memory;
+  arena->first_page = vm_page;
+  arena->first_large_page = NULL;
+  arena->bump_offset = offset_of(vm_page_t, page_memory) + sizeof(mm_arena_t);
+  arena->bump_offset = (arena->bump_offset + MM_ARENA_ALIGNMENT - 1) &
+                       ~(MM_ARENA_ALIGNMENT - 1);
+  if (vm_page->zero_watermark < arena->bump_offset) {
+    vm_page->zero_watermark = arena->bump_offset;
+  }
+
+  return arena;
+}
+
+static void *mm_arena_alloc_large(mm_arena_t *arena, uint32_t size) {
+  size_t span_size = offset_of(vm_page_t, page_memory) + (size_t)size;
+  uint32_t units = (span_size + SYSTEM_PAGE_SIZE - 1) / SYSTEM_PAGE_SIZE;
+  uint32_t node = mm_numa_current_node();
+  vm_page_t *vm_page = mm_get_new_vm_page_from_kernel(units);
+
+  if (!vm_page) {
+    return NULL;
+  }
+
+  // Same node as the arena pages, which come from the caller's node pool
+  mm_numa_bind(vm_page, (size_t)units * SYSTEM_PAGE_SIZE, node);
+  vm_page->numa_node = node;
+  vm_page->pg_family = NULL;
+  vm_page->page_kind = MM_PAGE_LARGE;
+  vm_page->units = units;
+  vm_page->is_hugetlb = MM_FALSE;
+  vm_page->prev = NULL;
+  vm_page->next = arena->first_large_page;
+  arena->first_large_page = vm_page;
+  __atomic_fetch_add(&mm_arena_pages_in_use, units, __ATOMIC_RELAXED);
+
+  // The span was freshly mapped, so it holds zeros only
+  __atomic_fetch_add(&mm_zeroing_bytes_saved, size, __ATOMIC_RELAXED);
+  return (void *)vm_page->page_memory;
+}
+
+void *arena_alloc(mm_arena_t *arena, uint32_t size) {
+  vm_page_t *vm_page = arena->first_page;
+  uint32_t start, end, dirty_size = 0;
+
+  // Objects that would not fit in an empty arena page get a span of their own
+  if (size > SYSTEM_PAGE_SIZE - offset_of(vm_page_t, page_memory)) {
+    return mm_arena_alloc_large(arena, size);
+  }
+  size = (size + MM_ARENA_ALIGNMENT - 1) & ~(MM_ARENA_ALIGNMENT - 1);
+
+  // Move on to a new page when the current one is full
+  if (arena->bump_offset + size > SYSTEM_PAGE_SIZE) {
+    vm_page = mm_arena_page_acquire();
+    if (!vm_page) {
+      return NULL;
+    }
+    vm_page->next = arena->first_page;
+    arena->first_page = vm_page;
+    arena->bump_offset = offset_of(vm_page_t, page_memory);
+  }
+
+  start = arena->bump_offset;
+  end = start + size;
+  arena->bump_offset = end;
+
+  // Only clear the bytes the page used before it was handed to the arena
+  dirty_size = mm_vm_page_claim_range(vm_page, start, end);
+  if (dirty_size) {
+    memset((char *)vm_page + start, 0, dirty_size);
+  }
+  __atomic_fetch_add(&mm_zeroing_bytes_saved, size - dirty_size,
+                     __ATOMIC_RELAXED);
+
+  return (char *)vm_page + start;
+}
+
+void arena_reset(mm_arena_t *arena) {
+  vm_page_t *home_page =
+      (vm_page_t *)((char *)arena - offset_of(vm_page_t, page_memory));
+  vm_page_t *vm_page;
+
+  // Hand every page but the home page back in one sweep
+  while (arena->first_page != home_page) {
+    vm_page = arena->first_page;
+    arena->first_page = vm_page->next;
+    mm_page_pool_release(vm_page);
+    __atomic_fetch_sub(&mm_arena_pages_in_use, 1, __ATOMIC_RELAXED);
+  }
+
+  while (arena->first_large_page) {
+    vm_page = arena->first_large_page;
+    arena->first_large_page = vm_page->next;
+    __atomic_fetch_sub(&mm_arena_pages_in_use, vm_page->units,
+                       __ATOMIC_RELAXED);
+    mm_return_vm_page_to_kernel((void *)vm_page, vm_page->units);
+  }
+
+  // The home page keeps its zero watermark, so reused bytes get cleared
+  arena->bump_offset = offset_of(vm_page_t, page_memory) + sizeof(mm_arena_t);
+  arena->bump_offset = (arena->bump_offset + MM_ARENA_ALIGNMENT - 1) &
+                       ~(MM_ARENA_ALIGNMENT - 1);
+}
+
+void arena_destroy(mm_arena_t *arena) {
+  vm_page_t *home_page =
+      (vm_page_t *)((char *)arena - offset_of(vm_page_t, page_memory));
+
+  arena_reset(arena);
+  mm_page_pool_release(home_page);
+  __atomic_fetch_sub(&mm_arena_pages_in_use, 1, __ATOMIC_RELAXED);
+}
+
+void mm_get_page_pool_stats(mm_page_pool_stats_t *stats) {
+  stats->hits = __atomic_load_n(&mm_page_pool_stats.hits, __ATOMIC_RELAXED);
+  stats->misses =
+      __atomic_load_n(&mm_page_pool_stats.misses, __ATOMIC_RELAXED);
+  stats->released =
+      __atomic_load_n(&mm_page_pool_stats.released, __ATOMIC_RELAXED);
+  stats->retained =
+      __atomic_load_n(&mm_page_pool_stats.retained, __ATOMIC_RELAXED);
+}
+
+//-----------------< FreeVMPageBlock Free VM Page/Block -----------------/
+static void mm_union_free_blocks(block_meta_data_t *first,
+                                 block_meta_data_t *second) {
+  // Ensure that both blocks are free
+  assert(first->is_free == MM_TRUE && second->is_free == MM_TRUE);
+
+  // Check if the two blocks are contiguous
+  if (first->next_offset == second->offset &&
+      second->prev_offset == first->offset) {
+    // Merge the blocks by updating the size and offsets
+    first->block_size += sizeof(block_meta_data_t) + second->block_size;
+    first->next_offset = second->next_offset;
+
+    // The block after the merged one now follows the first block
+    MM_BLOCK_TAG_NEXT(first);
+  } else {
+    // Error message if blocks are not contiguous
+    printf("Error: mm_union_free_blocks - Attempting to merge non-contiguous "
+           "free blocks\n");
+  }
+}
+
+static inline uint32_t mm_free_bin_index(uint32_t size) {
+  // Small sizes: one bin per MM_FREE_BIN_SMALL_STEP bytes
+  if (size < MM_FREE_BINS_SMALL * MM_FREE_BIN_SMALL_STEP) {
+    return size / MM_FREE_BIN_SMALL_STEP;
+  }
+
+  // Larger sizes: MM_FREE_BIN_SUBDIVISIONS bins per power of two
+  uint32_t fl = 31 - __builtin_clz(size);
+  uint32_t sl = (size >> (fl - MM_FREE_BIN_SUBDIVISIONS_LOG2)) &
+                (MM_FREE_BIN_SUBDIVISIONS - 1);
+  uint32_t small_fl =
+      31 - __builtin_clz(MM_FREE_BINS_SMALL * MM_FREE_BIN_SMALL_STEP);
+  uint32_t index =
+      MM_FREE_BINS_SMALL + (fl - small_fl) * MM_FREE_BIN_SUBDIVISIONS + sl;
+
+  // The last bin is open-ended
+  return index < MM_FREE_BINS ? index : MM_FREE_BINS - 1;
+}
+
+static void mm_init_free_bins(vm_page_family_t *vm_page_family) {
+  vm_page_family->free_bins = NULL;
+  vm_page_family->free_bins_bitmap = 0;
+}
+
+static vm_bool_t mm_allocate_free_bins(vm_page_family_t *vm_page_family) {
+  size_t bins_size = MM_FREE_BINS * sizeof(glthread_t);
+  glthread_t *free_bins;
+  uint32_t i;
+
+  if (vm_page_family->free_bins) {
+    return MM_TRUE;
+  }
+
+  // Page families are never unregistered, so the bins are never given back
+  pthread_mutex_lock(&mm_free_bins_lock);
+  if (mm_free_bins_left < bins_size) {
+    mm_free_bins_next = (char *)mm_get_new_vm_page_from_kernel(1);
+    if (!mm_free_bins_next) {
+      mm_free_bins_left = 0;
+      pthread_mutex_unlock(&mm_free_bins_lock);
+      return MM_FALSE;
+    }
+    mm_free_bins_left = SYSTEM_PAGE_SIZE;
+  }
+  free_bins = (glthread_t *)mm_free_bins_next;
+  mm_free_bins_next += bins_size;
+  mm_free_bins_left -= bins_size;
+  pthread_mutex_unlock(&mm_free_bins_lock);
+
+  for (i = 0; i < MM_FREE_BINS; i++) {
+    init_glthread(&free_bins[i]);
+  }
+  vm_page_family->free_bins = free_bins;
+  return MM_TRUE;
+}
+
+static void
+mm_add_free_block_meta_data_to_free_block_list(vm_page_family_t *vm_page_family,
+                                               block_meta_data_t *free_block) {
+
+  // Assert that the free_block is indeed marked as free
+  assert(free_block->is_free == MM_TRUE);
+
+  uint32_t bin = mm_free_bin_index(free_block->block_size);
+
+  // Push the free block on its size class bin and flag the bin as non-empty;
+  // the links live in the block's own data area
+  init_glthread(MM_FREE_BLOCK_GLUE(free_block));
+  glthread_add_next(&vm_page_family->free_bins[bin],
+                    MM_FREE_BLOCK_GLUE(free_block));
+  vm_page_family->free_bins_bitmap |= (1ULL << bin);
+  vm_page_family->free_block_count++;
+  vm_page_family->free_bytes += free_block->block_size;
+}
+
+static void mm_remove_free_block_meta_data_from_free_block_list(
+    vm_page_family_t *vm_page_family, block_meta_data_t *free_block) {
+  uint32_t bin = mm_free_bin_index(free_block->block_size);
+
+  remove_glthread(MM_FREE_BLOCK_GLUE(free_block));
+  vm_page_family->free_block_count--;
+  vm_page_family->free_bytes -= free_block->block_size;
+
+  // Clear the bin's bit once its last block is gone
+  if (IS_GLTHREAD_LIST_EMPTY(&vm_page_family->free_bins[bin])) {
+    vm_page_family->free_bins_bitmap &= ~(1ULL << bin);
+  }
+}
+
+static int mm_get_hard_internal_memory_frag_size(block_meta_data_t *first,
+                                                 block_meta_data_t *second) {
+  // Get the next block after the first block
+  block_meta_data_t *next_block = NEXT_META_BLOCK_BY_SIZE(first);
+
+  // Calculate the size of hard internal memory fragmentation
+  return (int)((unsigned long)second - (unsigned long)(next_block));
+}
+
+static block_meta_data_t *mm_free_blocks(block_meta_data_t *to_be_free_block) {
+  block_meta_data_t *return_block = NULL; /// 1 Pointer to the freed block
+  assert(to_be_free_block->is_free == MM_FALSE);
+
+  // Retrieving hosting page and page family
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_META_BLOCK(to_be_free_block);
+
+  // Setting return_block to the block being freed
+  return_block = to_be_free_block;
+  to_be_free_block->is_free = MM_TRUE; /// 2 Marking the block as free
+
+  block_meta_data_t *next_block =
+      NEXT_META_BLOCK(to_be_free_block); /// 3 Next block pointer
+
+  // Handling Hard IF memory
+  if (next_block) {
+    // Scenario 1: When data block to be freed is not the last uppermost meta
+    // block in a VM data page
+    to_be_free_block->block_size +=
+        mm_get_hard_internal_memory_frag_size(to_be_free_block, next_block);
+  } else {
+    // Scenario 2: Page Boundary condition
+    // Block being freed is the uppermost free data block in a VM data page,
+    // checking for hard internal fragmented memory and merge
+    char *end_address_of_vm_page =
+        (char *)((char *)hosting_page + SYSTEM_PAGE_SIZE);
+    char *end_address_of_free_data_block =
+        (char *)(to_be_free_block + 1) + to_be_free_block->block_size;
+    int internal_mem_fragmentation =
+        (int)((unsigned long)end_address_of_vm_page -
+              (unsigned long)end_address_of_free_data_block);
+    to_be_free_block->block_size += internal_mem_fragmentation;
+  }
+
+  // Performing merging with next block if it's free
+  if (next_block && next_block->is_free == MM_TRUE) {
+    // The absorbed block must leave the free block list first
+    mm_remove_free_block_meta_data_from_free_block_list(hosting_page->pg_family,
+                                                        next_block);
+    mm_union_free_blocks(to_be_free_block,
+                         next_block); /// 4 Union two free blocks
+    return_block = to_be_free_block;
+  }
+
+  // The boundary tag tells whether the previous block is free, without
+  // reading its header
+  if (to_be_free_block->prev_free) {
+    block_meta_data_t *prev_block = PREV_META_BLOCK(to_be_free_block);
+    // The surviving block is re-inserted below with its new size
+    mm_remove_free_block_meta_data_from_free_block_list(hosting_page->pg_family,
+                                                        prev_block);
+    mm_union_free_blocks(prev_block, to_be_free_block);
+    return_block = prev_block;
+  }
+
+  // Checking if the hosting page becomes empty after freeing this block
+  if (mm_is_vm_page_empty(hosting_page)) {
+    mm_vm_page_delete_and_free(
+        hosting_page); /// 5 Delete and free the hosting page
+    return NULL;
+  }
+
+  // Adding the freed block metadata to the free block list
+  mm_add_free_block_meta_data_to_free_block_list(hosting_page->pg_family,
+                                                 return_block);
+  MM_BLOCK_TAG_NEXT(return_block);
+
+  return return_block;
+}
+
+void xfree(void *app_data) {
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+  vm_page_family_t *vm_page_family = hosting_page->pg_family;
+
+  if (__builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    mm_debug_free(app_data);
+    return;
+  }
+
+  mm_stats_count_ops(0, 1);
+  mm_profile_free_hook(app_data);
+
+  // Slab slots have no metadata block in front of them
+  if (hosting_page->page_kind == MM_PAGE_SLAB) {
+    mm_thread_cache_bin_t *bin = mm_thread_cache_get_bin(vm_page_family);
+    if (bin) {
+      mm_thread_cache_free(bin, app_data);
+      return;
+    }
+    pthread_mutex_lock(&vm_page_family->family_lock);
+    mm_slab_free_locked(hosting_page, app_data);
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+    return;
+  }
+
+  // Adjust the pointer to point to the block metadata
+  block_meta_data_t *block_meta_data =
+      (block_meta_data_t *)((char *)app_data - sizeof(block_meta_data_t));
+
+  // Ensure that the block is not already free
+  assert(block_meta_data->is_free == MM_FALSE);
+
+  // Large objects own their whole span
+  if (hosting_page->page_kind == MM_PAGE_LARGE) {
+    mm_free_large_block(hosting_page);
+    return;
+  }
+
+  // Single-unit objects go back to the calling thread's cache, lock free
+  if (block_meta_data->block_size ==
+      mm_block_size_round(vm_page_family, vm_page_family->struct_size)) {
+    mm_thread_cache_bin_t *bin = mm_thread_cache_get_bin(vm_page_family);
+    if (bin) {
+      mm_thread_cache_free(bin, app_data);
+      return;
+    }
+  }
+
+  // Call the memory manager's free blocks function
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  mm_free_blocks(block_meta_data);
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+}
+
+uint32_t mm_usable_size(void *app_data) {
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+
+  // The bytes past the requested size belong to the canary
+  if (__builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    return mm_debug_object_size(app_data);
+  }
+  if (hosting_page->page_kind == MM_PAGE_SLAB) {
+    return hosting_page->pg_family->slab_slot_size;
+  }
+  return ((block_meta_data_t *)app_data - 1)->block_size;
+}
+
+//-----------------<  Memory allocation section -----------------/
+int mm_set_placement_policy(vm_page_family_t *vm_page_family,
+                            mm_placement_policy_t policy) {
+  uint32_t node;
+
+  if (!vm_page_family || policy > MM_PLACEMENT_WORST_FIT) {
+    printf("Error: %s() called with an unregistered page family or an "
+           "unknown policy\n",
+           __FUNCTION__);
+    return -1;
+  }
+
+  // The families of the other NUMA nodes follow the one they stand for
+  for (node = 0; node < MM_NUMA_MAX_NODES; node++) {
+    vm_page_family_t *node_family =
+        node ? __atomic_load_n(&vm_page_family->numa_families[node],
+                               __ATOMIC_ACQUIRE)
+             : vm_page_family;
+    if (node_family) {
+      pthread_mutex_lock(&node_family->family_lock);
+      node_family->placement = policy;
+      pthread_mutex_unlock(&node_family->family_lock);
+    }
+  }
+  return 0;
+}
+
+static block_meta_data_t *
+mm_get_free_block_by_policy(vm_page_family_t *vm_page_family,
+                            uint32_t req_size) {
+  uint32_t policy = vm_page_family->placement;
+  uintptr_t cursor = vm_page_family->next_fit_cursor;
+  block_meta_data_t *chosen = NULL;
+  glthread_t *curr = NULL;
+
+  // Blocks of lower bins are all too small
+  uint64_t bins = vm_page_family->free_bins_bitmap &
+                  (~0ULL << mm_free_bin_index(req_size));
+  if (policy == MM_PLACEMENT_WORST_FIT && bins) {
+    bins = 1ULL << (63 - __builtin_clzll(bins));
+  }
+
+  while (bins) {
+    uint32_t bin = __builtin_ctzll(bins);
+    bins &= bins - 1;
+
+    ITERATE_GLTHREAD_BEGIN(&vm_page_family->free_bins[bin], curr) {
+      block_meta_data_t *block_meta_data = glthread_to_block_meta_data(curr);
+      if (block_meta_data->block_size < req_size) {
+        continue;
+      }
+      if (!chosen) {
+        chosen = block_meta_data;
+        continue;
+      }
+      switch (policy) {
+      case MM_PLACEMENT_BEST_FIT:
+        if (block_meta_data->block_size < chosen->block_size) {
+          chosen = block_meta_data;
+        }
+        break;
+      case MM_PLACEMENT_FIRST_FIT:
+        if (block_meta_data < chosen) {
+          chosen = block_meta_data;
+        }
+        break;
+      case MM_PLACEMENT_NEXT_FIT:
+        // Distances past the cursor wrap around the address space
+        if ((uintptr_t)block_meta_data - cursor <
+            (uintptr_t)chosen - cursor) {
+          chosen = block_meta_data;
+        }
+        break;
+      default:
+        if (block_meta_data->block_size > chosen->block_size) {
+          chosen = block_meta_data;
+        }
+        break;
+      }
+    }
+    ITERATE_GLTHREAD_END(&vm_page_family->free_bins[bin], curr);
+
+    // Blocks of higher bins are all larger than those of this one
+    if (policy == MM_PLACEMENT_BEST_FIT && chosen) {
+      break;
+    }
+  }
+
+  // The remainder of the split, if any, starts right after the request
+  if (policy == MM_PLACEMENT_NEXT_FIT && chosen) {
+    vm_page_family->next_fit_cursor = (uintptr_t)(chosen + 1) + req_size;
+  }
+  return chosen;
+}
+
+static block_meta_data_t *
+mm_allocate_free_data_block(vm_page_family_t *vm_page_family,
+                            uint32_t req_size, uint32_t *dirty_size) {
+
+  vm_bool_t status;
+  vm_page_t *vm_page = NULL;
+
+  // Get a free block large enough for the request in constant time
+  block_meta_data_t *free_block_meta_data =
+      mm_get_free_block_for_size(vm_page_family, req_size);
+
+  // Check if there is no available block large enough
+  if (!free_block_meta_data) {
+
+    // Add a new page to the page family
+    vm_page = mm_family_new_page_add(vm_page_family);
+    if (!vm_page) {
+      return NULL;
+    }
+    free_block_meta_data = &vm_page->block_meta_data;
+  }
+
+  // Attempt to split the free block to satisfy the allocation request
+  status = mm_split_free_data_block_for_allocation(
+      vm_page_family, free_block_meta_data, req_size);
+
+  // Return the allocated block's metadata if successful
+  if (status) {
+    *dirty_size = mm_block_claim_dirty_size(free_block_meta_data);
+    return free_block_meta_data;
+  }
+
+  return NULL;
+}
+
+static uint32_t mm_vm_page_claim_range(vm_page_t *vm_page, uint32_t start,
+                                       uint32_t end) {
+  uint32_t dirty_size = 0;
+
+  // Only the part of the range below the watermark may have been used
+  if (vm_page->zero_watermark > start) {
+    dirty_size =
+        (vm_page->zero_watermark < end ? vm_page->zero_watermark : end) - start;
+  }
+  if (vm_page->zero_watermark < end) {
+    vm_page->zero_watermark = end;
+  }
+
+  return dirty_size;
+}
+
+static uint32_t mm_block_claim_dirty_size(block_meta_data_t *block_meta_data) {
+  vm_page_t *vm_page = MM_GET_PAGE_FROM_META_BLOCK(block_meta_data);
+  uint32_t start = block_meta_data->offset + sizeof(block_meta_data_t);
+  uint32_t end = start + block_meta_data->block_size;
+  uint32_t dirty_size = mm_vm_page_claim_range(vm_page, start, end);
+
+  // The free list links were stored at the start of the block while it was
+  // free
+  if (dirty_size < MM_MIN_BLOCK_SIZE) {
+    dirty_size = block_meta_data->block_size < MM_MIN_BLOCK_SIZE
+                     ? block_meta_data->block_size
+                     : MM_MIN_BLOCK_SIZE;
+  }
+
+  // A split may have written the metadata of the next block right after it
+  end += sizeof(block_meta_data_t);
+  if (vm_page->zero_watermark < end) {
+    vm_page->zero_watermark = end;
+  }
+
+  return dirty_size;
+}
+
+//-----------------< Slab Fixed-size slab pages -----------------*/
+static void mm_slab_page_move(vm_page_t *vm_page, vm_page_t **from,
+                              vm_page_t **to) {
+  // Unlink the page
+  if (vm_page->prev) {
+    vm_page->prev->next = vm_page->next;
+  } else {
+    *from = vm_page->next;
+  }
+  if (vm_page->next) {
+    vm_page->next->prev = vm_page->prev;
+  }
+  vm_page->next = NULL;
+  vm_page->prev = NULL;
+
+  // Push it at the head of its new list
+  if (to) {
+    vm_page->next = *to;
+    if (*to) {
+      (*to)->prev = vm_page;
+    }
+    *to = vm_page;
+  }
+}
+
+static void *mm_slab_alloc_locked(vm_page_family_t *vm_page_family,
+                                  uint32_t *dirty_size) {
+  vm_page_t *vm_page = vm_page_family->slab_partial_pages;
+  mm_slab_meta_data_t *slab;
+  char *slot;
+
+  // Start a new slab page when every page is full
+  if (!vm_page) {
+    vm_page = mm_page_pool_acquire(vm_page_family);
+    if (!vm_page) {
+      return NULL;
+    }
+    vm_page->pg_family = vm_page_family;
+    vm_page->page_kind = MM_PAGE_SLAB;
+    vm_page->units = 1;
+    vm_page->is_hugetlb = MM_FALSE;
+    vm_page->slab_meta_data.free_list = NULL;
+    vm_page->slab_meta_data.used_slots = 0;
+    vm_page->slab_meta_data.carved_slots = 0;
+    vm_page->prev = NULL;
+    vm_page->next = NULL;
+    vm_page_family->slab_partial_pages = vm_page;
+  }
+  slab = &vm_page->slab_meta_data;
+
+  // Recycle a freed slot first, otherwise carve the next untouched one
+  if (slab->free_list) {
+    slot = slab->free_list;
+    slab->free_list = *(void **)slot;
+  } else {
+    slot = vm_page->page_memory +
+           (size_t)slab->carved_slots * vm_page_family->slab_slot_size;
+    slab->carved_slots++;
+  }
+
+  *dirty_size = mm_vm_page_claim_range(
+      vm_page, slot - (char *)vm_page,
+      slot - (char *)vm_page + vm_page_family->struct_size);
+
+  vm_page_family->slab_used_slots++;
+  if (++slab->used_slots == vm_page_family->slab_slots_per_page) {
+    mm_slab_page_move(vm_page, &vm_page_family->slab_partial_pages,
+                      &vm_page_family->slab_full_pages);
+  }
+
+  return slot;
+}
+
+static void mm_slab_free_locked(vm_page_t *vm_page, void *app_data) {
+  vm_page_family_t *vm_page_family = vm_page->pg_family;
+  mm_slab_meta_data_t *slab = &vm_page->slab_meta_data;
+
+  *(void **)app_data = slab->free_list;
+  slab->free_list = app_data;
+  vm_page_family->slab_used_slots--;
+
+  // A full page has a free slot again
+  if (slab->used_slots-- == vm_page_family->slab_slots_per_page) {
+    mm_slab_page_move(vm_page, &vm_page_family->slab_full_pages,
+                      &vm_page_family->slab_partial_pages);
+  }
+
+  // An empty page goes back to the page retention pool
+  if (slab->used_slots == 0) {
+    mm_slab_page_move(vm_page, &vm_page_family->slab_partial_pages, NULL);
+    mm_page_pool_release(vm_page);
+  }
+}
+
+static inline block_meta_data_t *
+mm_get_free_block_for_size(vm_page_family_t *vm_page_family,
+                           uint32_t req_size) {
+  uint32_t bin = mm_free_bin_index(req_size);
+  glthread_t *curr = NULL;
+
+  if (vm_page_family->placement != MM_PLACEMENT_SEGREGATED) {
+    return mm_get_free_block_by_policy(vm_page_family, req_size);
+  }
+
+  // The head of the request's own bin may already be large enough
+  if (vm_page_family->free_bins_bitmap & (1ULL << bin)) {
+    ITERATE_GLTHREAD_BEGIN(&vm_page_family->free_bins[bin], curr) {
+      block_meta_data_t *block_meta_data = glthread_to_block_meta_data(curr);
+      if (block_meta_data->block_size >= req_size) {
+        return block_meta_data;
+      }
+      // Only the open-ended last bin is worth walking
+      if (bin != MM_FREE_BINS - 1) {
+        break;
+      }
+    }
+    ITERATE_GLTHREAD_END(&vm_page_family->free_bins[bin], curr);
+  }
+
+  if (bin == MM_FREE_BINS - 1) {
+    return NULL;
+  }
+
+  // Every block of a higher non-empty bin fits, take the smallest such bin
+  uint64_t larger_bins =
+      vm_page_family->free_bins_bitmap & (~0ULL << (bin + 1));
+  if (!larger_bins) {
+    return NULL;
+  }
+
+  bin = __builtin_ctzll(larger_bins);
+  return glthread_to_block_meta_data(
+      BASE(&vm_page_family->free_bins[bin]));
+}
+
+static vm_bool_t
+mm_split_free_data_block_for_allocation(vm_page_family_t *vm_page_family,
+                                        block_meta_data_t *block_meta_data,
+                                        uint32_t size) {
+
+  block_meta_data_t *next_block_meta_data = NULL;
+
+  // Assert that the provided block is free
+  assert(block_meta_data->is_free == MM_TRUE);
+
+  // Check if the block size is sufficient for allocation
+  if (block_meta_data->block_size < size) {
+    return MM_FALSE;
+  }
+
+  // Calculate the remaining size after allocation
+  uint32_t remaining_size = block_meta_data->block_size - size;
+
+  // Take the block off its bin while it still has its original size
+  mm_remove_free_block_meta_data_from_free_block_list(vm_page_family,
+                                                      block_meta_data);
+
+  // Update metadata for the allocated portion
+  block_meta_data->is_free = MM_FALSE;
+  block_meta_data->block_size = size;
+  MM_BLOCK_TAG_NEXT(block_meta_data);
+
+  // Case 1: No Split
+  if (!remaining_size) {
+    return MM_TRUE;
+  }
+
+  // Case 3-2: Partial Split - Hard Internal Fragmentation
+  else if (remaining_size < sizeof(block_meta_data_t) + MM_MIN_BLOCK_SIZE) {
+    // The remainder cannot hold a free block and its free list links
+  }
+
+  // Case 3-1: Partial Split - Soft Internal Fragmentation
+  else if (remaining_size <
+           (sizeof(block_meta_data_t) + vm_page_family->struct_size)) {
+    // Create a new metadata block for the remaining space
+    next_block_meta_data = NEXT_META_BLOCK_BY_SIZE(block_meta_data);
+    next_block_meta_data->is_free = MM_TRUE;
+    next_block_meta_data->block_size =
+        remaining_size - sizeof(block_meta_data_t);
+    next_block_meta_data->offset = block_meta_data->offset +
+                                   sizeof(block_meta_data_t) +
+                                   block_meta_data->block_size;
+    mm_add_free_block_meta_data_to_free_block_list(vm_page_family,
+                                                   next_block_meta_data);
+    mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
+  }
+
+  // Case 2: Full Split - New Metadata Block Created
+  else {
+    // Create a new metadata block for the remaining space
+    next_block_meta_data = NEXT_META_BLOCK_BY_SIZE(block_meta_data);
+    next_block_meta_data->is_free = MM_TRUE;
+    next_block_meta_data->block_size =
+        remaining_size - sizeof(block_meta_data_t);
+    next_block_meta_data->offset = block_meta_data->offset +
+                                   sizeof(block_meta_data_t) +
+                                   block_meta_data->block_size;
+    mm_add_free_block_meta_data_to_free_block_list(vm_page_family,
+                                                   next_block_meta_data);
+    mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
+  }
+
+  return MM_TRUE;
+}
+
+MM_ALLOC_TEXT
+void *xcalloc(char *struct_name, int units) {
+  return mm_xalloc_by_name(struct_name, units, MM_TRUE);
+}
+
+MM_ALLOC_TEXT
+void *xmalloc(char *struct_name, int units) {
+  return mm_xalloc_by_name(struct_name, units, MM_FALSE);
+}
+
+MM_ALLOC_TEXT
+static void *mm_xalloc_by_name(char *struct_name, int units, vm_bool_t zero) {
+  // Initialize variables
+  char data_type[MAX_STRUCT_NAME_LEN];
+  uint8_t data_type_error_flag = 0;
+  vm_page_family_t *pg_family = NULL;
+
+  // Registered struct names hit the hash index directly, without parsing
+  pg_family = lookup_page_family_by_name(struct_name);
+  if (pg_family) {
+    return mm_xalloc_by_family(pg_family, units, zero);
+  }
+
+  // Parse the struct name and set the data type error
+  parse_struct_name(struct_name, data_type, &data_type_error_flag);
+
+  // Check if there was an error parsing the struct name
+  if (data_type_error_flag == 1) {
+    // Step 1: Look up the page family associated with the structure name
+    pg_family = lookup_page_family_by_name(struct_name);
+  } else {
+    // Step 1: Look up the page family associated with the data type
+    pg_family = lookup_page_family_by_name(data_type);
+  }
+
+  // If the page family is not registered, register it. Only known data types
+  // have a size, and threads racing on the same one share its page family.
+  if (!pg_family && (!data_type_error_flag || data_type_error_flag == 2) &&
+      get_size_of_datatype(data_type)) {
+    pg_family =
+        mm_get_page_family(data_type, get_size_of_datatype(data_type));
+    if (!pg_family) {
+      return NULL;
+    }
+  } else if (!pg_family) {
+    printf("Error: Structure %s not registered with Memory Manager\n",
+           struct_name);
+    return NULL;
+  }
+
+  // The numeric form carries its own unit size; the family itself is never
+  // modified here since other threads may be allocating from it
+  uint32_t struct_size = (data_type_error_flag == 2)
+                             ? (uint32_t)atoi(struct_name)
+                             : pg_family->struct_size;
+
+  // Check if the requested memory size fits in a block
+  if ((uint64_t)units * struct_size > MM_MAX_BLOCK_SIZE) {
+    printf("Error: Memory requested exceeds the maximum block size\n");
+    return NULL;
+  }
+
+  return mm_xcalloc_from_family(pg_family, units * struct_size, zero);
+}
+
+MM_ALLOC_TEXT
+void *xcalloc_family(vm_page_family_t *vm_page_family, int units) {
+  return mm_xalloc_by_family(vm_page_family, units, MM_TRUE);
+}
+
+MM_ALLOC_TEXT
+void *xmalloc_family(vm_page_family_t *vm_page_family, int units) {
+  return mm_xalloc_by_family(vm_page_family, units, MM_FALSE);
+}
+
+MM_ALLOC_TEXT
+static void *mm_xalloc_by_family(vm_page_family_t *vm_page_family, int units,
+                                 vm_bool_t zero) {
+  if (!vm_page_family) {
+    printf("Error: %s() called with an unregistered page family\n",
+           __FUNCTION__);
+    return NULL;
+  }
+
+  // Check if the requested memory size fits in a block
+  if ((uint64_t)units * vm_page_family->struct_size > MM_MAX_BLOCK_SIZE) {
+    printf("Error: Memory requested exceeds the maximum block size\n");
+    return NULL;
+  }
+
+  return mm_xcalloc_from_family(vm_page_family,
+                                units * vm_page_family->struct_size, zero);
+}
+
+MM_ALLOC_TEXT
+void *xcalloc_aligned(vm_page_family_t *vm_page_family, int units,
+                      uint32_t alignment) {
+  return mm_xalloc_aligned(vm_page_family, units, alignment, MM_TRUE);
+}
+
+MM_ALLOC_TEXT
+void *xmalloc_aligned(vm_page_family_t *vm_page_family, int units,
+                      uint32_t alignment) {
+  return mm_xalloc_aligned(vm_page_family, units, alignment, MM_FALSE);
+}
+
+MM_ALLOC_TEXT
+static void *mm_xalloc_aligned(vm_page_family_t *vm_page_family, int units,
+                               uint32_t alignment, vm_bool_t zero) {
+  uint32_t dirty_size = 0;
+
+  if (!vm_page_family || alignment & (alignment - 1)) {
+    printf("Error: %s() called with an unregistered page family or an "
+           "alignment that is not a power of two\n",
+           __FUNCTION__);
+    return NULL;
+  }
+
+  if (vm_page_family->is_movable) {
+    printf("Error: %s is movable, allocate it with xcalloc_movable()\n",
+           vm_page_family->struct_name);
+    return NULL;
+  }
+  vm_page_family = mm_numa_family(vm_page_family);
+
+  // Every object of the family is aligned this much already
+  if (alignment <= vm_page_family->alignment) {
+    return mm_xalloc_by_family(vm_page_family, units, zero);
+  }
+
+  // Check if the requested memory size fits in a block
+  if ((uint64_t)units * vm_page_family->struct_size > MM_MAX_BLOCK_SIZE) {
+    printf("Error: Memory requested exceeds the maximum block size\n");
+    return NULL;
+  }
+
+  if (__builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    return mm_debug_alloc(vm_page_family, units * vm_page_family->struct_size,
+                          zero, alignment);
+  }
+
+  // Room for the object, the slack to reach the aligned address and a free
+  // block in front of it
+  uint32_t req_size = units * vm_page_family->struct_size;
+  uint32_t size = mm_block_size_round(vm_page_family, req_size);
+  uint64_t carve_size = (uint64_t)size + alignment +
+                        sizeof(block_meta_data_t) + MM_MIN_BLOCK_SIZE;
+
+  if (carve_size > MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
+    // Large object spans start their data at a fixed offset of the span
+    if (req_size > MAX_PAGE_ALLOCATABLE_MEMORY(1) &&
+        alignment <= MM_MAX_FAMILY_ALIGNMENT) {
+      return mm_xcalloc_from_family(vm_page_family, req_size, zero);
+    }
+    printf("Error: Cannot align %u bytes on %u bytes\n", req_size, alignment);
+    return NULL;
+  }
+
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  block_meta_data_t *block_meta_data = mm_allocate_free_data_block(
+      vm_page_family,
+      mm_block_size_round(vm_page_family, (uint32_t)carve_size), &dirty_size);
+  if (!block_meta_data) {
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+    return NULL;
+  }
+
+  char *block_data = (char *)(block_meta_data + 1);
+  char *app_data = block_data;
+  if ((uintptr_t)block_data & (alignment - 1)) {
+    // Move the object to the aligned address and free the part in front,
+    // which is large enough for a free block
+    app_data = (char *)(((uintptr_t)block_data + sizeof(block_meta_data_t) +
+                         MM_MIN_BLOCK_SIZE + alignment - 1) &
+                        ~(uintptr_t)(alignment - 1));
+    block_meta_data_t *aligned_block = (block_meta_data_t *)app_data - 1;
+    uint32_t shift = app_data - block_data;
+
+    aligned_block->is_free = MM_FALSE;
+    aligned_block->offset = block_meta_data->offset + shift;
+    aligned_block->block_size = block_meta_data->block_size - shift;
+    block_meta_data->block_size = shift - sizeof(block_meta_data_t);
+    mm_bind_blocks_for_allocation(block_meta_data, aligned_block);
+    mm_free_blocks(block_meta_data);
+    block_meta_data = aligned_block;
+
+    // Only what was dirty past the shift is dirty in the object
+    dirty_size = dirty_size > shift ? dirty_size - shift : 0;
+  }
+  mm_block_shrink_locked(block_meta_data, size);
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  if (dirty_size > size) {
+    dirty_size = size;
+  }
+
+  // Only clear the bytes that are not known to be zero already
+  if (!zero) {
+    dirty_size = 0;
+  } else if (dirty_size) {
+    memset(app_data, 0, dirty_size);
+  }
+  __atomic_fetch_add(&mm_zeroing_bytes_saved, size - dirty_size,
+                     __ATOMIC_RELAXED);
+  mm_stats_count_ops(1, 0);
+  mm_profile_alloc_hook(app_data, size);
+
+  return app_data;
+}
+
+MM_ALLOC_TEXT
+static void *mm_xcalloc_from_family(vm_page_family_t *vm_page_family,
+                                    uint32_t req_size, vm_bool_t zero) {
+  void *app_data = NULL;
+  uint32_t dirty_size = 0;
+
+  // Movable objects need a handle the compactor can update
+  if (vm_page_family->is_movable) {
+    printf("Error: %s is movable, allocate it with xcalloc_movable()\n",
+           vm_page_family->struct_name);
+    return NULL;
+  }
+  vm_page_family = mm_numa_family(vm_page_family);
+
+  // The debug mode gives each object a block of its own
+  if (__builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    return mm_debug_alloc(vm_page_family, req_size, zero, 0);
+  }
+
+  // Requests that do not fit in a single page get a span of their own
+  if (req_size > MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
+    block_meta_data_t *block_meta_data =
+        mm_allocate_large_block(vm_page_family, req_size, &dirty_size);
+    if (!block_meta_data) {
+      return NULL;
+    }
+    // Freshly mapped spans hold zeros only, reused ones are cleared
+    if (!zero) {
+      dirty_size = 0;
+    } else if (dirty_size) {
+      memset(block_meta_data + 1, 0, dirty_size);
+    }
+    __atomic_fetch_add(&mm_zeroing_bytes_saved, req_size - dirty_size,
+                       __ATOMIC_RELAXED);
+    mm_stats_count_ops(1, 0);
+    mm_profile_alloc_hook(block_meta_data + 1, req_size);
+    return (void *)(block_meta_data + 1);
+  }
+
+  // Single-unit requests are served from the calling thread's cache
+  if (req_size == vm_page_family->struct_size) {
+    mm_thread_cache_bin_t *bin = mm_thread_cache_get_bin(vm_page_family);
+    if (bin) {
+      app_data = mm_thread_cache_alloc(bin, zero);
+      if (app_data) {
+        mm_stats_count_ops(1, 0);
+        mm_profile_alloc_hook(app_data, req_size);
+      }
+      return app_data;
+    }
+
+    // Slab families hand out single units from their slots
+    if (vm_page_family->is_slab) {
+      pthread_mutex_lock(&vm_page_family->family_lock);
+      app_data = mm_slab_alloc_locked(vm_page_family, &dirty_size);
+      pthread_mutex_unlock(&vm_page_family->family_lock);
+      if (!app_data) {
+        return NULL;
+      }
+      if (!zero) {
+        dirty_size = 0;
+      } else if (dirty_size) {
+        memset(app_data, 0, dirty_size);
+      }
+      __atomic_fetch_add(&mm_zeroing_bytes_saved, req_size - dirty_size,
+                         __ATOMIC_RELAXED);
+      mm_stats_count_ops(1, 0);
+      mm_profile_alloc_hook(app_data, req_size);
+      return app_data;
+    }
+  }
+
+  // Find a free block in the page family to satisfy the allocation request
+  req_size = mm_block_size_round(vm_page_family, req_size);
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  block_meta_data_t *free_block_meta_data =
+      mm_allocate_free_data_block(vm_page_family, req_size, &dirty_size);
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  // Return NULL if the allocation failed
+  if (!free_block_meta_data) {
+    return NULL;
+  }
+
+  app_data = (void *)(free_block_meta_data + 1);
+
+  // Only clear the bytes that are not known to be zero already
+  if (!zero) {
+    dirty_size = 0;
+  } else if (dirty_size) {
+    memset(app_data, 0, dirty_size);
+  }
+  __atomic_fetch_add(&mm_zeroing_bytes_saved,
+                     free_block_meta_data->block_size - dirty_size,
+                     __ATOMIC_RELAXED);
+  mm_stats_count_ops(1, 0);
+  mm_profile_alloc_hook(app_data, free_block_meta_data->block_size);
+
+  return app_data;
+}
+
+//-----------------< Realloc In-place resizing -----------------/
+static void mm_block_shrink_locked(block_meta_data_t *block_meta_data,
+                                   uint32_t size) {
+  uint32_t remaining_size = block_meta_data->block_size - size;
+
+  block_meta_data->block_size = size;
+
+  // A tail too small for a free block stays as hard internal fragmentation,
+  // which the block gets back when it is freed
+  if (remaining_size < sizeof(block_meta_data_t) + MM_MIN_BLOCK_SIZE) {
+    return;
+  }
+
+  // Turn the tail into an allocated block of its own and free it, which
+  // merges it with a free block that follows
+  block_meta_data_t *tail_block = NEXT_META_BLOCK_BY_SIZE(block_meta_data);
+  tail_block->is_free = MM_FALSE;
+  tail_block->block_size = remaining_size - sizeof(block_meta_data_t);
+  tail_block->offset =
+      block_meta_data->offset + sizeof(block_meta_data_t) + size;
+  mm_bind_blocks_for_allocation(block_meta_data, tail_block);
+  mm_free_blocks(tail_block);
+}
+
+static vm_bool_t mm_block_resize_locked(vm_page_family_t *vm_page_family,
+                                        block_meta_data_t *block_meta_data,
+                                        uint32_t size) {
+  vm_page_t *vm_page = MM_GET_PAGE_FROM_META_BLOCK(block_meta_data);
+  block_meta_data_t *next_block = NEXT_META_BLOCK(block_meta_data);
+  uint32_t start = block_meta_data->offset + sizeof(block_meta_data_t);
+
+  if (size > block_meta_data->block_size) {
+    // The block can extend up to the next allocated block or the page end
+    block_meta_data_t *limit_block = next_block;
+    if (next_block && next_block->is_free) {
+      limit_block = NEXT_META_BLOCK(next_block);
+    }
+    uint32_t limit = limit_block ? limit_block->offset : SYSTEM_PAGE_SIZE;
+    if (start + size > limit) {
+      return MM_FALSE;
+    }
+
+    // Absorb the free block that follows
+    if (next_block && next_block->is_free) {
+      mm_remove_free_block_meta_data_from_free_block_list(vm_page_family,
+                                                          next_block);
+      block_meta_data->next_offset = next_block->next_offset;
+      MM_BLOCK_TAG_NEXT(block_meta_data);
+    }
+    block_meta_data->block_size = limit - start;
+  }
+
+  mm_block_shrink_locked(block_meta_data, size);
+
+  // The grown part and the metadata of a split tail are in use now
+  mm_vm_page_claim_range(vm_page, start,
+                         start + block_meta_data->block_size +
+                             sizeof(block_meta_data_t));
+  return MM_TRUE;
+}
+
+static void *mm_large_block_resize(vm_page_t *vm_page, uint32_t req_size) {
+  vm_page_family_t *vm_page_family = vm_page->pg_family;
+  size_t span_size = offset_of(vm_page_t, page_memory) + (size_t)req_size;
+  uint32_t units = (span_size + SYSTEM_PAGE_SIZE - 1) / SYSTEM_PAGE_SIZE;
+  vm_page_t *new_page = NULL;
+  uint32_t dirty_size;
+
+  // An object that shrinks or still fits stays, and the span keeps the pages
+  // past its end, which mm_trim() may take back meanwhile
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  if (units <= vm_page->units) {
+    __atomic_fetch_add(&mm_large_bytes_in_use,
+                       (uint64_t)req_size - vm_page->block_meta_data.block_size,
+                       __ATOMIC_RELAXED);
+    vm_page->block_meta_data.block_size = req_size;
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+    return vm_page->page_memory;
+  }
+  if (vm_page->is_hugetlb) {
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+    return NULL;
+  }
+
+  // Grow geometrically, so that an object growing in small steps is not
+  // moved at every step
+  if (units < vm_page->units + vm_page->units / 2) {
+    units = vm_page->units + vm_page->units / 2;
+  }
+  units = mm_large_span_units(units);
+
+  // The pages of a retained span are already backed, copying the object
+  // there is cheaper than faulting in those of a remapped span
+  if (units <= MM_LARGE_SPAN_POOL_MAX_UNITS) {
+    new_page =
+        mm_large_span_pool_acquire(vm_page->numa_node, units, &dirty_size);
+  }
+  if (new_page) {
+    units = new_page->units;
+    memcpy(new_page, vm_page,
+           offset_of(vm_page_t, page_memory) +
+               (size_t)vm_page->block_meta_data.block_size);
+    new_page->units = units;
+  } else {
+#ifdef MREMAP_MAYMOVE
+    // The kernel extends the mapping, or moves its pages elsewhere without
+    // copying them
+    new_page = mremap(vm_page, vm_page->units * SYSTEM_PAGE_SIZE,
+                      units * SYSTEM_PAGE_SIZE, MREMAP_MAYMOVE);
+    if (new_page == MAP_FAILED) {
+      pthread_mutex_unlock(&vm_page_family->family_lock);
+      return NULL;
+    }
+    __atomic_fetch_add(&mm_pages_mapped, units - new_page->units,
+                       __ATOMIC_RELAXED);
+    new_page->units = units;
+    vm_page = NULL;
+#else
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+    return NULL;
+#endif
+  }
+
+  // The span takes the place of the old one in the family's span list
+  if (new_page->prev) {
+    new_page->prev->next = new_page;
+  } else {
+    vm_page_family->first_large_page = new_page;
+  }
+  if (new_page->next) {
+    new_page->next->prev = new_page;
+  }
+  __atomic_fetch_add(&mm_large_bytes_in_use,
+                     (uint64_t)req_size - new_page->block_meta_data.block_size,
+                     __ATOMIC_RELAXED);
+  new_page->block_meta_data.block_size = req_size;
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  // The old span of a copied object is free
+  if (vm_page && !mm_large_span_pool_release(vm_page)) {
+    mm_return_vm_page_to_kernel((void *)vm_page, vm_page->units);
+  }
+  return new_page->page_memory;
+}
+
+MM_ALLOC_TEXT
+void *xrealloc(void *app_data, int units) {
+  if (!app_data) {
+    return NULL;
+  }
+  if (units <= 0) {
+    xfree(app_data);
+    return NULL;
+  }
+
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+  vm_page_family_t *vm_page_family = hosting_page->pg_family;
+  void *new_app_data = NULL;
+
+  // Check if the requested memory size fits in a block
+  if ((uint64_t)units * vm_page_family->struct_size > MM_MAX_BLOCK_SIZE) {
+    printf("Error: Memory requested exceeds the maximum block size\n");
+    return NULL;
+  }
+  uint32_t req_size = units * vm_page_family->struct_size;
+  if (__builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    return mm_debug_realloc(app_data, req_size);
+  }
+  uint32_t old_size = mm_usable_size(app_data);
+
+  // Try to resize the object where it is
+  switch (hosting_page->page_kind) {
+  case MM_PAGE_SLAB:
+    if (req_size <= vm_page_family->slab_slot_size) {
+      new_app_data = app_data;
+    }
+    break;
+  case MM_PAGE_LARGE:
+    if (req_size > MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
+      new_app_data = mm_large_block_resize(hosting_page, req_size);
+    }
+    break;
+  default:
+    if (req_size <= MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
+      pthread_mutex_lock(&vm_page_family->family_lock);
+      if (mm_block_resize_locked(vm_page_family,
+                                 (block_meta_data_t *)app_data - 1,
+                                 mm_block_size_round(vm_page_family,
+                                                     req_size))) {
+        new_app_data = app_data;
+      }
+      pthread_mutex_unlock(&vm_page_family->family_lock);
+    }
+    break;
+  }
+
+  if (new_app_data == app_data) {
+    __atomic_fetch_add(&mm_realloc_stats.in_place, 1, __ATOMIC_RELAXED);
+    return new_app_data;
+  }
+
+  // Fall back to allocate, copy and free
+  if (!new_app_data) {
+    new_app_data = mm_xcalloc_from_family(vm_page_family, req_size, MM_FALSE);
+    if (!new_app_data) {
+      return NULL;
+    }
+    memcpy(new_app_data, app_data, old_size < req_size ? old_size : req_size);
+    xfree(app_data);
+  }
+  __atomic_fetch_add(&mm_realloc_stats.moved, 1, __ATOMIC_RELAXED);
+  return new_app_data;
+}
+
+void mm_get_realloc_stats(mm_realloc_stats_t *stats) {
+  stats->in_place =
+      __atomic_load_n(&mm_realloc_stats.in_place, __ATOMIC_RELAXED);
+  stats->moved = __atomic_load_n(&mm_realloc_stats.moved, __ATOMIC_RELAXED);
+}
+
+//-----------------< Bulk Batched allocation and free -----------------/
+static uint32_t mm_allocate_blocks_locked(vm_page_family_t *vm_page_family,
+                                          uint32_t size, void **objects,
+                                          uint32_t *dirty_sizes,
+                                          uint32_t count) {
+  uint32_t allocated = 0;
+
+  while (allocated < count) {
+    block_meta_data_t *block_meta_data =
+        mm_get_free_block_for_size(vm_page_family, size);
+    if (!block_meta_data) {
+      vm_page_t *vm_page = mm_family_new_page_add(vm_page_family);
+      if (!vm_page) {
+        break;
+      }
+      block_meta_data = &vm_page->block_meta_data;
+    }
+
+    // The block leaves its bin once, however many objects it yields
+    mm_remove_free_block_meta_data_from_free_block_list(vm_page_family,
+                                                        block_meta_data);
+
+    // Carve objects off the front of the block while it is large enough
+    while (block_meta_data && allocated < count &&
+           block_meta_data->block_size >= size) {
+      uint32_t remaining_size = block_meta_data->block_size - size;
+      block_meta_data_t *next_block_meta_data = NULL;
+
+      block_meta_data->is_free = MM_FALSE;
+      block_meta_data->block_size = size;
+      MM_BLOCK_TAG_NEXT(block_meta_data);
+
+      // A remainder too small for a free block stays as hard internal
+      // fragmentation of the last object
+      if (remaining_size >= sizeof(block_meta_data_t) + MM_MIN_BLOCK_SIZE) {
+        next_block_meta_data = NEXT_META_BLOCK_BY_SIZE(block_meta_data);
+        next_block_meta_data->is_free = MM_TRUE;
+        next_block_meta_data->block_size =
+            remaining_size - sizeof(block_meta_data_t);
+        next_block_meta_data->offset =
+            block_meta_data->offset + sizeof(block_meta_data_t) + size;
+        mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
+      }
+
+      dirty_sizes[allocated] = mm_block_claim_dirty_size(block_meta_data);
+      objects[allocated++] = (void *)(block_meta_data + 1);
+      block_meta_data = next_block_meta_data;
+    }
+
+    // Whatever is left of the block goes back to a bin
+    if (block_meta_data) {
+      mm_add_free_block_meta_data_to_free_block_list(vm_page_family,
+                                                     block_meta_data);
+    }
+  }
+
+  return allocated;
+}
+
+MM_ALLOC_TEXT
+int xcalloc_bulk(vm_page_family_t *vm_page_family, int count,
+                 void **objects) {
+  uint32_t dirty_sizes[MM_BULK_CHUNK];
+  int allocated = 0;
+
+  if (!vm_page_family || count < 0) {
+    printf("Error: %s() called with an unregistered page family or a "
+           "negative count\n",
+           __FUNCTION__);
+    return 0;
+  }
+
+  if (vm_page_family->is_movable) {
+    printf("Error: %s is movable, allocate it with xcalloc_movable()\n",
+           vm_page_family->struct_name);
+    return 0;
+  }
+  vm_page_family = mm_numa_family(vm_page_family);
+
+  uint32_t size = vm_page_family->struct_size;
+
+  // Large objects each own a span, and the debug mode checks objects one by
+  // one, so there is nothing to share between them
+  if (size > MAX_PAGE_ALLOCATABLE_MEMORY(1) ||
+      __builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    while (allocated < count) {
+      objects[allocated] = mm_xalloc_by_family(vm_page_family, 1, MM_TRUE);
+      if (!objects[allocated]) {
+        break;
+      }
+      allocated++;
+    }
+    return allocated;
+  }
+
+  // Drain the objects the calling thread already holds, without refilling
+  mm_thread_cache_bin_t *bin = mm_thread_cache_get_bin(vm_page_family);
+  if (bin) {
+    while (allocated < count && bin->count > 0) {
+      objects[allocated++] = mm_thread_cache_alloc(bin, MM_TRUE);
+    }
+  }
+
+  uint32_t block_size = mm_block_size_round(vm_page_family, size);
+  while (allocated < count) {
+    void **chunk = &objects[allocated];
+    uint32_t wanted = count - allocated < MM_BULK_CHUNK
+                          ? (uint32_t)(count - allocated)
+                          : MM_BULK_CHUNK;
+    uint32_t got = 0;
+    uint32_t i;
+
+    pthread_mutex_lock(&vm_page_family->family_lock);
+    if (vm_page_family->is_slab) {
+      while (got < wanted) {
+        chunk[got] = mm_slab_alloc_locked(vm_page_family, &dirty_sizes[got]);
+        if (!chunk[got]) {
+          break;
+        }
+        got++;
+      }
+    } else {
+      got = mm_allocate_blocks_locked(vm_page_family, block_size, chunk,
+                                      dirty_sizes, wanted);
+    }
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+
+    // Clear outside the lock, only the bytes that are not known to be zero
+    uint32_t usable_size = vm_page_family->is_slab ? size : block_size;
+    uint64_t bytes_saved = 0;
+    for (i = 0; i < got; i++) {
+      if (dirty_sizes[i]) {
+        memset(chunk[i], 0, dirty_sizes[i]);
+      }
+      bytes_saved += usable_size - dirty_sizes[i];
+    }
+    __atomic_fetch_add(&mm_zeroing_bytes_saved, bytes_saved,
+                       __ATOMIC_RELAXED);
+
+    allocated += got;
+    if (got < wanted) {
+      break;
+    }
+  }
+
+  mm_stats_count_ops(allocated, 0);
+  if (__atomic_load_n(&mm_profile_enabled, __ATOMIC_ACQUIRE)) {
+    int i;
+    for (i = 0; i < allocated; i++) {
+      mm_profile_alloc_hook(objects[i], size);
+    }
+  }
+  return allocated;
+}
+
+static int mm_compare_addresses(const void *a, const void *b) {
+  uintptr_t first = (uintptr_t)*(void *const *)a;
+  uintptr_t second = (uintptr_t)*(void *const *)b;
+
+  return (first > second) - (first < second);
+}
+
+static void mm_free_sorted_chunk(void **objects, uint32_t count) {
+  vm_page_family_t *locked_family = NULL;
+  uint32_t i = 0;
+
+  while (i < count) {
+    vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(objects[i]);
+    vm_page_family_t *vm_page_family = hosting_page->pg_family;
+
+    // Large objects own their whole span and take the lock themselves
+    if (hosting_page->page_kind == MM_PAGE_LARGE) {
+      if (locked_family) {
+        pthread_mutex_unlock(&locked_family->family_lock);
+        locked_family = NULL;
+      }
+      mm_free_large_block(hosting_page);
+      i++;
+      continue;
+    }
+
+    if (vm_page_family != locked_family) {
+      if (locked_family) {
+        pthread_mutex_unlock(&locked_family->family_lock);
+      }
+      pthread_mutex_lock(&vm_page_family->family_lock);
+      locked_family = vm_page_family;
+    }
+
+    if (hosting_page->page_kind == MM_PAGE_SLAB) {
+      mm_slab_free_locked(hosting_page, objects[i++]);
+      continue;
+    }
+
+    // Extend the run while the next object is the block right after it
+    block_meta_data_t *first_block = (block_meta_data_t *)objects[i++] - 1;
+    block_meta_data_t *last_block = first_block;
+    assert(first_block->is_free == MM_FALSE);
+    while (i < count) {
+      block_meta_data_t *next_block = NEXT_META_BLOCK(last_block);
+      if (!next_block || objects[i] != (void *)(next_block + 1)) {
+        break;
+      }
+      assert(next_block->is_free == MM_FALSE);
+      last_block = next_block;
+      i++;
+    }
+
+    // Merge the run into its first block, which is then freed as one
+    if (last_block != first_block) {
+      first_block->block_size =
+          (uint32_t)((char *)(last_block + 1) + last_block->block_size -
+                     (char *)(first_block + 1));
+      first_block->next_offset = last_block->next_offset;
+      MM_BLOCK_TAG_NEXT(first_block);
+    }
+    mm_free_blocks(first_block);
+  }
+
+  if (locked_family) {
+    pthread_mutex_unlock(&locked_family->family_lock);
+  }
+}
+
+void xfree_bulk(void **objects, int count) {
+  void *chunk[MM_BULK_CHUNK];
+  int done = 0;
+  int i;
+
+  if (__builtin_expect(MM_DEBUG_FLAGS() != 0, 0)) {
+    for (i = 0; i < count; i++) {
+      mm_debug_free(objects[i]);
+    }
+    return;
+  }
+
+  mm_stats_count_ops(0, count > 0 ? count : 0);
+  if (__atomic_load_n(&mm_heap_profile, __ATOMIC_ACQUIRE)) {
+    for (i = 0; i < count; i++) {
+      mm_profile_free_hook(objects[i]);
+    }
+  }
+
+  // Sorting brings the objects of a page, and neighbouring blocks, together
+  while (done < count) {
+    uint32_t n = count - done < MM_BULK_CHUNK ? (uint32_t)(count - done)
+                                              : MM_BULK_CHUNK;
+    memcpy(chunk, &objects[done], n * sizeof(chunk[0]));
+    qsort(chunk, n, sizeof(chunk[0]), mm_compare_addresses);
+    mm_free_sorted_chunk(chunk, n);
+    done += n;
+  }
+}
+
+//-----------------< ThreadCache Per-thread cache section -----------------/
+static void mm_thread_cache_destructor(void *arg) {
+  (void)arg;
+  mm_thread_cache_flush();
+  mm_thread_cache_registered = 0;
+  mm_thread_cache_torn_down = 1;
+}
+
+static void mm_thread_cache_key_create(void) {
+  pthread_key_create(&mm_thread_cache_key, mm_thread_cache_destructor);
+}
+
+static mm_thread_cache_bin_t *
+mm_thread_cache_get_bin(vm_page_family_t *vm_page_family) {
+  if (!__atomic_load_n(&mm_thread_cache_enabled, __ATOMIC_RELAXED) ||
+      vm_page_family->family_id >= MM_TCACHE_MAX_FAMILIES) {
+    return NULL;
+  }
+
+  // First use on this thread: arrange for the cache to be flushed on exit
+  if (!mm_thread_cache_registered) {
+    if (mm_thread_cache_torn_down) {
+      return NULL;
+    }
+    pthread_once(&mm_thread_cache_key_once, mm_thread_cache_key_create);
+    pthread_setspecific(mm_thread_cache_key, &mm_thread_cache);
+    mm_thread_cache_registered = 1;
+  }
+
+  mm_thread_cache_bin_t *bin =
+      &mm_thread_cache.bins[vm_page_family->family_id];
+  bin->family = vm_page_family;
+  return bin;
+}
+
+static void *mm_thread_cache_alloc(mm_thread_cache_bin_t *bin,
+                                   vm_bool_t zero) {
+  vm_page_family_t *vm_page_family = bin->family;
+  uint32_t size = vm_page_family->struct_size;
+  uint32_t dirty_size;
+  void *app_data;
+
+  // Refill an empty bin with a batch of objects under a single lock
+  if (bin->count == 0) {
+    pthread_mutex_lock(&vm_page_family->family_lock);
+    while (bin->count < MM_TCACHE_BATCH) {
+      if (vm_page_family->is_slab) {
+        app_data = mm_slab_alloc_locked(vm_page_family, &dirty_size);
+      } else {
+        block_meta_data_t *block_meta_data = mm_allocate_free_data_block(
+            vm_page_family, mm_block_size_round(vm_page_family, size),
+            &dirty_size);
+        app_data = block_meta_data ? (void *)(block_meta_data + 1) : NULL;
+      }
+      if (!app_data) {
+        break;
+      }
+      // Fresh blocks only hold their old free list links, clear them now
+      if (dirty_size <= MM_MIN_BLOCK_SIZE) {
+        memset(app_data, 0, dirty_size);
+        dirty_size = 0;
+      }
+      // Remember which objects never held any data
+      if (dirty_size) {
+        bin->zeroed_mask &= ~(1u << bin->count);
+      } else {
+        bin->zeroed_mask |= 1u << bin->count;
+      }
+      bin->objects[bin->count++] = app_data;
+    }
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+
+    // Publish the bytes this thread did not have to clear so far
+    __atomic_fetch_add(&mm_zeroing_bytes_saved,
+                       mm_thread_cache.zeroing_bytes_saved, __ATOMIC_RELAXED);
+    mm_thread_cache.zeroing_bytes_saved = 0;
+
+    if (bin->count == 0) {
+      return NULL;
+    }
+  }
+
+  app_data = bin->objects[--bin->count];
+  // The key must not outlive the object's stay in the cache
+  *(uintptr_t *)app_data = 0;
+  if (zero && !(bin->zeroed_mask & (1u << bin->count))) {
+    // Cached objects hold stale data from their previous owner
+    memset(app_data, 0, size);
+  } else {
+    mm_thread_cache.zeroing_bytes_saved += size;
+  }
+  return app_data;
+}
+
+static void mm_thread_cache_release_locked(mm_thread_cache_bin_t *bin,
+                                           uint32_t count) {
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    vm_page_t *vm_page = MM_GET_PAGE_FROM_APP_DATA(bin->objects[i]);
+    if (vm_page->page_kind == MM_PAGE_SLAB) {
+      mm_slab_free_locked(vm_page, bin->objects[i]);
+    } else {
+      mm_free_blocks((block_meta_data_t *)bin->objects[i] - 1);
+    }
+  }
+
+  // Keep the most recently freed (cache-hot) objects in the bin
+  memmove(&bin->objects[0], &bin->objects[count],
+          (bin->count - count) * sizeof(bin->objects[0]));
+  bin->zeroed_mask = count < MM_TCACHE_CAPACITY ? bin->zeroed_mask >> count : 0;
+  bin->count -= count;
+}
+
+static void mm_thread_cache_free(mm_thread_cache_bin_t *bin, void *app_data) {
+  uint32_t i;
+
+  // The key may also be data of the application, the bin has the last word
+  if (__builtin_expect(*(uintptr_t *)app_data == MM_TCACHE_KEY, 0)) {
+    for (i = 0; i < bin->count; i++) {
+      assert(bin->objects[i] != app_data);
+    }
+  }
+
+  // Make room by returning the oldest batch to the family under a single lock
+  if (bin->count == MM_TCACHE_CAPACITY) {
+    pthread_mutex_lock(&bin->family->family_lock);
+    mm_thread_cache_release_locked(bin, MM_TCACHE_BATCH);
+    pthread_mutex_unlock(&bin->family->family_lock);
+  }
+
+  *(uintptr_t *)app_data = MM_TCACHE_KEY;
+  bin->zeroed_mask &= ~(1u << bin->count);
+  bin->objects[bin->count++] = app_data;
+}
+
+void mm_thread_cache_flush() {
+  uint32_t i;
+
+  for (i = 0; i < MM_TCACHE_MAX_FAMILIES; i++) {
+    mm_thread_cache_bin_t *bin = &mm_thread_cache.bins[i];
+    if (bin->count == 0) {
+      continue;
+    }
+    pthread_mutex_lock(&bin->family->family_lock);
+    mm_thread_cache_release_locked(bin, bin->count);
+    pthread_mutex_unlock(&bin->family->family_lock);
+  }
+
+  __atomic_fetch_add(&mm_zeroing_bytes_saved,
+                     mm_thread_cache.zeroing_bytes_saved, __ATOMIC_RELAXED);
+  mm_thread_cache.zeroing_bytes_saved = 0;
+  mm_stats_publish_ops();
+}
+
+void mm_set_thread_cache(int enable) {
+  __atomic_store_n(&mm_thread_cache_enabled, enable, __ATOMIC_RELAXED);
+}
+
+//-----------------< Stats Allocator statistics -----------------/
+static inline void mm_stats_count_ops(uint32_t allocs, uint32_t frees) {
+  if (__builtin_expect(!mm_thread_cache.has_allocated, 0) && allocs) {
+    mm_thread_cache.has_allocated = 1;
+    __atomic_store_n(&mm_allocations_started, 1, __ATOMIC_RELEASE);
+  }
+  mm_thread_cache.alloc_count += allocs;
+  mm_thread_cache.free_count += frees;
+  if (mm_thread_cache.alloc_count + mm_thread_cache.free_count >=
+      MM_STATS_PUBLISH_BATCH) {
+    mm_stats_publish_ops();
+  }
+}
+
+static void mm_stats_publish_ops(void) {
+  if (mm_thread_cache.alloc_count) {
+    __atomic_fetch_add(&mm_alloc_count, mm_thread_cache.alloc_count,
+                       __ATOMIC_RELAXED);
+    mm_thread_cache.alloc_count = 0;
+  }
+  if (mm_thread_cache.free_count) {
+    __atomic_fetch_add(&mm_free_count, mm_thread_cache.free_count,
+                       __ATOMIC_RELAXED);
+    mm_thread_cache.free_count = 0;
+  }
+}
+
+static uint32_t
+mm_largest_free_block_locked(vm_page_family_t *vm_page_family) {
+  uint32_t largest = 0;
+  glthread_t *curr = NULL;
+
+  if (!vm_page_family->free_bins_bitmap) {
+    return 0;
+  }
+
+  // Every block of a lower bin is smaller than any block of this one
+  uint32_t bin = 63 - __builtin_clzll(vm_page_family->free_bins_bitmap);
+  ITERATE_GLTHREAD_BEGIN(&vm_page_family->free_bins[bin], curr) {
+    block_meta_data_t *block_meta_data = glthread_to_block_meta_data(curr);
+    if (block_meta_data->block_size > largest) {
+      largest = block_meta_data->block_size;
+    }
+  }
+  ITERATE_GLTHREAD_END(&vm_page_family->free_bins[bin], curr);
+
+  return largest;
+}
+
+static inline uint64_t
+mm_family_bytes_in_use_locked(vm_page_family_t *vm_page_family) {
+  return (uint64_t)vm_page_family->data_pages *
+             mm_max_page_allocatable_memory(1) -
+         vm_page_family->free_bytes +
+         (uint64_t)vm_page_family->slab_used_slots *
+             vm_page_family->slab_slot_size;
+}
+
+void mm_get_stats(mm_stats_t *stats) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
+  struct timespec now;
+
+  // The caller's own operations are always accounted for
+  mm_stats_publish_ops();
+  memset(stats, 0, sizeof(*stats));
+
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      pthread_mutex_lock(&vm_page_family_curr->family_lock);
+      uint32_t largest = mm_largest_free_block_locked(vm_page_family_curr);
+      if (largest > stats->largest_free_block) {
+        stats->largest_free_block = largest;
+      }
+      stats->bytes_in_use +=
+          mm_family_bytes_in_use_locked(vm_page_family_curr);
+      stats->free_blocks += vm_page_family_curr->free_block_count;
+      stats->free_bytes += vm_page_family_curr->free_bytes;
+      pthread_mutex_unlock(&vm_page_family_curr->family_lock);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
+  }
+
+  stats->bytes_in_use +=
+      __atomic_load_n(&mm_large_bytes_in_use, __ATOMIC_RELAXED) +
+      (uint64_t)__atomic_load_n(&mm_arena_pages_in_use, __ATOMIC_RELAXED) *
+          SYSTEM_PAGE_SIZE;
+  stats->pages_mapped = __atomic_load_n(&mm_pages_mapped, __ATOMIC_RELAXED);
+  if (stats->free_bytes) {
+    stats->fragmentation =
+        1.0 - (double)stats->largest_free_block / stats->free_bytes;
+  }
+  stats->allocs = __atomic_load_n(&mm_alloc_count, __ATOMIC_RELAXED);
+  stats->frees = __atomic_load_n(&mm_free_count, __ATOMIC_RELAXED);
+  stats->moved_objects = __atomic_load_n(&mm_moved_objects, __ATOMIC_RELAXED);
+  stats->compacted_pages =
+      __atomic_load_n(&mm_compacted_pages, __ATOMIC_RELAXED);
+
+  // Rates cover the time since the previous call, whoever made it
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  double time = now.tv_sec + now.tv_nsec / 1e9;
+  pthread_mutex_lock(&mm_stats_lock);
+  if (mm_stats_last.time > 0 && time > mm_stats_last.time) {
+    stats->alloc_rate =
+        (stats->allocs - mm_stats_last.allocs) / (time - mm_stats_last.time);
+    stats->free_rate =
+        (stats->frees - mm_stats_last.frees) / (time - mm_stats_last.time);
+  }
+  mm_stats_last.time = time;
+  mm_stats_last.allocs = stats->allocs;
+  mm_stats_last.frees = stats->frees;
+  pthread_mutex_unlock(&mm_stats_lock);
+}
+
+static int mm_stats_dump_open(const char *path) {
+  if (strncmp(path, "unix:", strlen("unix:")) == 0) {
+    struct sockaddr_un addr;
+    const char *socket_path = path + strlen("unix:");
+    size_t len = strlen(socket_path);
+
+    if (len >= sizeof(addr.sun_path)) {
+      return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, socket_path, len + 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  return open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+}
+
+static void mm_deadline_after_ms(struct timespec *deadline,
+                                 uint32_t interval_ms) {
+  clock_gettime(CLOCK_REALTIME, deadline);
+  deadline->tv_sec += interval_ms / 1000;
+  deadline->tv_nsec += (long)(interval_ms % 1000) * 1000000;
+  if (deadline->tv_nsec >= 1000000000) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000;
+  }
+}
+
+static void *mm_stats_dump_thread(void *arg) {
+  char line[512];
+  mm_stats_t stats;
+  struct timespec deadline;
+  struct timespec now;
+  (void)arg;
+
+  pthread_mutex_lock(&mm_stats_dump_lock);
+  vm_bool_t is_socket =
+      strncmp(mm_stats_dump_path, "unix:", strlen("unix:")) == 0;
+  for (;;) {
+    mm_deadline_after_ms(&deadline, mm_stats_dump_interval_ms);
+    while (!mm_stats_dump_stopping &&
+           pthread_cond_timedwait(&mm_stats_dump_cond, &mm_stats_dump_lock,
+                                  &deadline) == 0) {
+    }
+    if (mm_stats_dump_stopping) {
+      break;
+    }
+    pthread_mutex_unlock(&mm_stats_dump_lock);
+
+    mm_get_stats(&stats);
+    clock_gettime(CLOCK_REALTIME, &now);
+    int len = snprintf(
+        line, sizeof(line),
+        "{\"time\":%ld.%03ld,\"bytes_in_use\":%" PRIu64
+        ",\"pages_mapped\":%" PRIu64 ",\"free_blocks\":%" PRIu64
+        ",\"free_bytes\":%" PRIu64 ",\"largest_free_block\":%u"
+        ",\"fragmentation\":%.4f,\"allocs\":%" PRIu64 ",\"frees\":%" PRIu64
+        ",\"alloc_rate\":%.1f,\"free_rate\":%.1f,\"moved_objects\":%" PRIu64
+        ",\"compacted_pages\":%" PRIu64 "}\n",
+        (long)now.tv_sec, now.tv_nsec / 1000000, stats.bytes_in_use,
+        stats.pages_mapped, stats.free_blocks, stats.free_bytes,
+        stats.largest_free_block, stats.fragmentation, stats.allocs,
+        stats.frees, stats.alloc_rate, stats.free_rate, stats.moved_objects,
+        stats.compacted_pages);
+
+    // A socket whose reader went away is reconnected on the next round
+    if (mm_stats_dump_fd < 0) {
+      mm_stats_dump_fd = mm_stats_dump_open(mm_stats_dump_path);
+    }
+    if (mm_stats_dump_fd >= 0) {
+      ssize_t written =
+          is_socket ? send(mm_stats_dump_fd, line, len, MSG_NOSIGNAL)
+                    : write(mm_stats_dump_fd, line, len);
+      if (written != len) {
+        close(mm_stats_dump_fd);
+        mm_stats_dump_fd = -1;
+      }
+    }
+
+    pthread_mutex_lock(&mm_stats_dump_lock);
+  }
+  pthread_mutex_unlock(&mm_stats_dump_lock);
+
+  return NULL;
+}
+
+int mm_stats_dump_start(const char *path, uint32_t interval_ms) {
+  pthread_mutex_lock(&mm_stats_dump_lock);
+  if (mm_stats_dump_running) {
+    pthread_mutex_unlock(&mm_stats_dump_lock);
+    printf("Error: The statistics dump is already running\n");
+    return -1;
+  }
+  if (!path || !interval_ms ||
+      strlen(path) >= sizeof(mm_stats_dump_path)) {
+    pthread_mutex_unlock(&mm_stats_dump_lock);
+    printf("Error: %s() called with an invalid path or interval\n",
+           __FUNCTION__);
+    return -1;
+  }
+
+  mm_stats_dump_fd = mm_stats_dump_open(path);
+  if (mm_stats_dump_fd < 0) {
+    pthread_mutex_unlock(&mm_stats_dump_lock);
+    printf("Error: Could not open %s for the statistics dump\n", path);
+    return -1;
+  }
+  memcpy(mm_stats_dump_path, path, strlen(path) + 1);
+  mm_stats_dump_interval_ms = interval_ms;
+  mm_stats_dump_stopping = 0;
+
+  if (pthread_create(&mm_stats_dump_tid, NULL, mm_stats_dump_thread, NULL) !=
+      0) {
+    close(mm_stats_dump_fd);
+    mm_stats_dump_fd = -1;
+    pthread_mutex_unlock(&mm_stats_dump_lock);
+    printf("Error: Could not start the statistics dump thread\n");
+    return -1;
+  }
+  mm_stats_dump_running = 1;
+  pthread_mutex_unlock(&mm_stats_dump_lock);
+
+  return 0;
+}
+
+void mm_stats_dump_stop() {
+  pthread_mutex_lock(&mm_stats_dump_lock);
+  if (!mm_stats_dump_running) {
+    pthread_mutex_unlock(&mm_stats_dump_lock);
+    return;
+  }
+  mm_stats_dump_stopping = 1;
+  pthread_cond_signal(&mm_stats_dump_cond);
+  pthread_mutex_unlock(&mm_stats_dump_lock);
+
+  pthread_join(mm_stats_dump_tid, NULL);
+
+  pthread_mutex_lock(&mm_stats_dump_lock);
+  if (mm_stats_dump_fd >= 0) {
+    close(mm_stats_dump_fd);
+    mm_stats_dump_fd = -1;
+  }
+  mm_stats_dump_running = 0;
+  pthread_mutex_unlock(&mm_stats_dump_lock);
+}
+
+//-----------------< Profile Heap profiler -----------------/
+static inline uint32_t mm_profile_address_hash(void *app_data) {
+  return (uint32_t)((((uintptr_t)app_data >> 4) * 0x9E3779B97F4A7C15ULL) >>
+                    32);
+}
+
+MM_ALLOC_TEXT
+static inline void mm_profile_alloc_hook(void *app_data, uint32_t size) {
+  if (__builtin_expect(__atomic_load_n(&mm_profile_enabled, __ATOMIC_ACQUIRE),
+                       0)) {
+    mm_thread_cache.profile_countdown -= size;
+    if (mm_thread_cache.profile_countdown <= 0) {
+      mm_profile_record(app_data, size);
+    }
+  }
+}
+
+static inline void mm_profile_free_hook(void *app_data) {
+  if (__builtin_expect(
+          __atomic_load_n(&mm_heap_profile, __ATOMIC_ACQUIRE) != NULL, 0)) {
+    mm_profile_forget(app_data);
+  }
+}
+
+MM_ALLOC_TEXT
+static void mm_profile_record(void *app_data, uint32_t size) {
+  mm_heap_profile_t *profile = mm_heap_profile;
+  void *stack[MM_PROFILE_MAX_DEPTH + MM_PROFILE_MAX_ALLOC_FRAMES];
+  uint32_t interval = profile->sample_interval;
+  uint32_t *rng = &mm_thread_cache.profile_rng;
+  vm_bool_t first_countdown = !*rng;
+  int depth, skip;
+
+  // Intervals are drawn uniformly around the average so that sampling does
+  // not lock onto a periodic allocation pattern. A thread's first call only
+  // seeds its generator and draws its first countdown.
+  if (first_countdown) {
+    *rng = (uint32_t)(uintptr_t)&mm_thread_cache ^ (uint32_t)time(NULL);
+    *rng |= 1;
+    mm_thread_cache.profile_countdown = 0;
+  }
+
+  // The overshoot of the allocation that crossed the countdown is carried
+  // over, so that samples are one interval apart on average
+  while (mm_thread_cache.profile_countdown <= 0) {
+    *rng ^= *rng << 13;
+    *rng ^= *rng >> 17;
+    *rng ^= *rng << 5;
+    mm_thread_cache.profile_countdown += 1 + *rng % (2 * (uint64_t)interval);
+  }
+  if (first_countdown) {
+    return;
+  }
+
+  // The frames of the allocation functions, this one first, are trimmed so
+  // that the stack starts at the allocation site. A return address points
+  // past its call, which may be past the end of the function.
+  depth = backtrace(stack, MM_PROFILE_MAX_DEPTH + MM_PROFILE_MAX_ALLOC_FRAMES);
+  for (skip = 0; skip < depth; skip++) {
+    char *address = (char *)stack[skip] - 1;
+    if (address < __start_mm_alloc_text || address >= __stop_mm_alloc_text) {
+      break;
+    }
+  }
+  depth -= skip;
+  if (depth > MM_PROFILE_MAX_DEPTH) {
+    depth = MM_PROFILE_MAX_DEPTH;
+  }
+
+  pthread_mutex_lock(&mm_profile_lock);
+  int site = mm_profile_site_get_locked(stack + skip, depth);
+  if (site < 0 || profile->live_samples >= MM_PROFILE_MAX_SAMPLES / 2) {
+    profile->dropped_samples++;
+    pthread_mutex_unlock(&mm_profile_lock);
+    return;
+  }
+
+  // A sample stands for the interval it was drawn from, or for itself when
+  // it is larger
+  uint64_t estimate = size > interval ? size : interval;
+  mm_profile_insert_locked(app_data, site, size, estimate);
+
+  mm_profile_site_t *profile_site = &profile->sites[site];
+  profile_site->alloc_count++;
+  profile_site->alloc_bytes += size;
+  profile_site->alloc_estimate += estimate;
+  pthread_mutex_unlock(&mm_profile_lock);
+}
+
+static void mm_profile_insert_locked(void *app_data, uint32_t site,
+                                     uint32_t size, uint64_t estimate) {
+  mm_heap_profile_t *profile = mm_heap_profile;
+  uint32_t hash = mm_profile_address_hash(app_data);
+  uint32_t slot = hash & (MM_PROFILE_MAX_SAMPLES - 1);
+
+  while (profile->samples[slot].app_data) {
+    slot = (slot + 1) & (MM_PROFILE_MAX_SAMPLES - 1);
+  }
+  mm_profile_sample_t *sample = &profile->samples[slot];
+  sample->app_data = app_data;
+  sample->site = site;
+  sample->size = size;
+  sample->estimate = estimate;
+  profile->live_samples++;
+  __atomic_store_n(&profile->filter[hash & (MM_PROFILE_FILTER_SIZE - 1)],
+                   profile->filter[hash & (MM_PROFILE_FILTER_SIZE - 1)] + 1,
+                   __ATOMIC_RELAXED);
+
+  mm_profile_site_t *profile_site = &profile->sites[site];
+  profile_site->live_count++;
+  profile_site->live_bytes += size;
+  profile_site->live_estimate += estimate;
+}
+
+static void mm_profile_move(void *old_app_data, void *new_app_data) {
+  mm_heap_profile_t *profile = mm_heap_profile;
+  uint32_t hash = mm_profile_address_hash(old_app_data);
+  mm_profile_sample_t sample;
+
+  if (!__atomic_load_n(&profile->filter[hash & (MM_PROFILE_FILTER_SIZE - 1)],
+                       __ATOMIC_RELAXED)) {
+    return;
+  }
+
+  pthread_mutex_lock(&mm_profile_lock);
+  uint32_t slot = hash & (MM_PROFILE_MAX_SAMPLES - 1);
+  while (profile->samples[slot].app_data &&
+         profile->samples[slot].app_data != old_app_data) {
+    slot = (slot + 1) & (MM_PROFILE_MAX_SAMPLES - 1);
+  }
+  sample = profile->samples[slot];
+  pthread_mutex_unlock(&mm_profile_lock);
+  if (!sample.app_data) {
+    return;
+  }
+
+  // The old block stays allocated until the move completes, so no other
+  // object can take the sample over in between
+  mm_profile_forget(old_app_data);
+  pthread_mutex_lock(&mm_profile_lock);
+  mm_profile_insert_locked(new_app_data, sample.site, sample.size,
+                           sample.estimate);
+  pthread_mutex_unlock(&mm_profile_lock);
+}
+
+static void mm_profile_forget(void *app_data) {
+  mm_heap_profile_t *profile = mm_heap_profile;
+  uint32_t hash = mm_profile_address_hash(app_data);
+  uint16_t *filter = &profile->filter[hash & (MM_PROFILE_FILTER_SIZE - 1)];
+
+  if (!__atomic_load_n(filter, __ATOMIC_RELAXED)) {
+    return;
+  }
+
+  pthread_mutex_lock(&mm_profile_lock);
+  uint32_t slot = hash & (MM_PROFILE_MAX_SAMPLES - 1);
+  while (profile->samples[slot].app_data &&
+         profile->samples[slot].app_data != app_data) {
+    slot = (slot + 1) & (MM_PROFILE_MAX_SAMPLES - 1);
+  }
+  if (!profile->samples[slot].app_data) {
+    pthread_mutex_unlock(&mm_profile_lock);
+    return;
+  }
+
+  mm_profile_sample_t *sample = &profile->samples[slot];
+  mm_profile_site_t *profile_site = &profile->sites[sample->site];
+  profile_site->live_count--;
+  profile_site->live_bytes -= sample->size;
+  profile_site->live_estimate -= sample->estimate;
+  profile->live_samples--;
+  __atomic_store_n(filter, *filter - 1, __ATOMIC_RELAXED);
+
+  // Shift back the samples that probed past the emptied slot, so that
+  // lookups never need tombstones
+  uint32_t empty = slot;
+  for (;;) {
+    slot = (slot + 1) & (MM_PROFILE_MAX_SAMPLES - 1);
+    if (!profile->samples[slot].app_data) {
+      break;
+    }
+    uint32_t home = mm_profile_address_hash(profile->samples[slot].app_data) &
+                    (MM_PROFILE_MAX_SAMPLES - 1);
+    if (((slot - home) & (MM_PROFILE_MAX_SAMPLES - 1)) >=
+        ((slot - empty) & (MM_PROFILE_MAX_SAMPLES - 1))) {
+      profile->samples[empty] = profile->samples[slot];
+      empty = slot;
+    }
+  }
+  profile->samples[empty].app_data = NULL;
+  pthread_mutex_unlock(&mm_profile_lock);
+}
+
+static int mm_profile_site_get_locked(void **stack, uint32_t depth) {
+  mm_heap_profile_t *profile = mm_heap_profile;
+  uint64_t hash = depth;
+  uint32_t i;
+
+  for (i = 0; i < depth; i++) {
+    hash = (hash ^ (uintptr_t)stack[i]) * 0x100000001B3ULL;
+  }
+  uint32_t bucket = (uint32_t)(hash >> 32) % MM_PROFILE_SITE_BUCKETS;
+
+  for (i = profile->site_buckets[bucket]; i;
+       i = profile->sites[i - 1].hash_next) {
+    mm_profile_site_t *profile_site = &profile->sites[i - 1];
+    if (profile_site->depth == depth &&
+        memcmp(profile_site->stack, stack, depth * sizeof(void *)) == 0) {
+      return i - 1;
+    }
+  }
+
+  if (profile->site_count == MM_PROFILE_MAX_SITES) {
+    return -1;
+  }
+  mm_profile_site_t *profile_site = &profile->sites[profile->site_count];
+  memcpy(profile_site->stack, stack, depth * sizeof(void *));
+  profile_site->depth = depth;
+  profile_site->hash_next = profile->site_buckets[bucket];
+  profile->site_buckets[bucket] = ++profile->site_count;
+
+  return profile->site_count - 1;
+}
+
+int mm_heap_profile_start(uint32_t sample_interval) {
+  mm_heap_profile_t *profile;
+  void *stack[1];
+
+  pthread_mutex_lock(&mm_profile_lock);
+  profile = mm_heap_profile;
+  if (!profile) {
+    uint32_t units = (sizeof(mm_heap_profile_t) + SYSTEM_PAGE_SIZE - 1) /
+                     SYSTEM_PAGE_SIZE;
+    profile = mm_get_new_vm_page_from_kernel(units);
+    if (!profile) {
+      pthread_mutex_unlock(&mm_profile_lock);
+      return -1;
+    }
+  } else {
+    memset(profile, 0, sizeof(*profile));
+  }
+  profile->sample_interval =
+      sample_interval ? sample_interval : MM_PROFILE_DEFAULT_INTERVAL;
+  // Frees test the pointer without the lock, so publish it set up, once
+  if (!mm_heap_profile) {
+    __atomic_store_n(&mm_heap_profile, profile, __ATOMIC_RELEASE);
+  }
+  pthread_mutex_unlock(&mm_profile_lock);
+
+  // backtrace() loads its unwinder, which allocates, on its first call
+  backtrace(stack, 1);
+
+  // Allocations that see the switch on also see the profile set up
+  __atomic_store_n(&mm_profile_enabled, 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+void mm_heap_profile_stop() {
+  __atomic_store_n(&mm_profile_enabled, 0, __ATOMIC_RELAXED);
+}
+
+static void mm_profile_flush(mm_profile_writer_t *writer) {
+  if (writer->len &&
+      write(writer->fd, writer->buf, writer->len) != (ssize_t)writer->len) {
+    writer->failed = MM_TRUE;
+  }
+  writer->len = 0;
+}
+
+static void mm_profile_printf(mm_profile_writer_t *writer, const char *format,
+                              ...) {
+  va_list args;
+
+  if (writer->len > sizeof(writer->buf) / 2) {
+    mm_profile_flush(writer);
+  }
+
+  va_start(args, format);
+  int len = vsnprintf(writer->buf + writer->len,
+                      sizeof(writer->buf) - writer->len, format, args);
+  va_end(args);
+  if (len > 0) {
+    writer->len += (uint32_t)len < sizeof(writer->buf) - writer->len
+                       ? (uint32_t)len
+                       : sizeof(writer->buf) - writer->len - 1;
+  }
+}
+
+static void mm_profile_print_frame(mm_profile_writer_t *writer,
+                                   void *address) {
+  Dl_info info;
+
+  // A return address points past the call, which may be past the function
+  if (!dladdr((char *)address - 1, &info)) {
+    mm_profile_printf(writer, "0x%lx", (unsigned long)address);
+  } else if (info.dli_sname) {
+    mm_profile_printf(writer, "%s", info.dli_sname);
+  } else if (info.dli_fname) {
+    const char *name = strrchr(info.dli_fname, '/');
+    mm_profile_printf(
+        writer, "%s+0x%lx", name ? name + 1 : info.dli_fname,
+        (unsigned long)((char *)address - (char *)info.dli_fbase));
+  } else {
+    mm_profile_printf(writer, "0x%lx", (unsigned long)address);
+  }
+}
+
+int mm_heap_profile_write(const char *path, mm_heap_profile_format_t format) {
+  mm_profile_writer_t writer;
+  mm_heap_profile_t *profile =
+      __atomic_load_n(&mm_heap_profile, __ATOMIC_ACQUIRE);
+  uint64_t live_count = 0, live_bytes = 0, alloc_count = 0, alloc_bytes = 0;
+  uint32_t i, j;
+
+  if (!profile) {
+    printf("Error: %s() called before mm_heap_profile_start()\n",
+           __FUNCTION__);
+    return -1;
+  }
+  writer.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (writer.fd < 0) {
+    printf("Error: Could not open %s for the heap profile\n", path);
+    return -1;
+  }
+  writer.len = 0;
+  writer.failed = MM_FALSE;
+
+  pthread_mutex_lock(&mm_profile_lock);
+  if (format == MM_HEAP_PROFILE_FOLDED) {
+    for (i = 0; i < profile->site_count; i++) {
+      mm_profile_site_t *profile_site = &profile->sites[i];
+      if (!profile_site->live_count) {
+        continue;
+      }
+      for (j = profile_site->depth; j > 0; j--) {
+        mm_profile_print_frame(&writer, profile_site->stack[j - 1]);
+        mm_profile_printf(&writer, j > 1 ? ";" : " ");
+      }
+      mm_profile_printf(&writer, "%llu\n",
+                        (unsigned long long)profile_site->live_estimate);
+    }
+  } else {
+    for (i = 0; i < profile->site_count; i++) {
+      live_count += profile->sites[i].live_count;
+      live_bytes += profile->sites[i].live_bytes;
+      alloc_count += profile->sites[i].alloc_count;
+      alloc_bytes += profile->sites[i].alloc_bytes;
+    }
+    mm_profile_printf(&writer,
+                      "heap profile: %llu: %llu [%llu: %llu] @ heap_v2/%u\n",
+                      (unsigned long long)live_count,
+                      (unsigned long long)live_bytes,
+                      (unsigned long long)alloc_count,
+                      (unsigned long long)alloc_bytes,
+                      profile->sample_interval);
+    for (i = 0; i < profile->site_count; i++) {
+      mm_profile_site_t *profile_site = &profile->sites[i];
+      mm_profile_printf(&writer, "%llu: %llu [%llu: %llu] @",
+                        (unsigned long long)profile_site->live_count,
+                        (unsigned long long)profile_site->live_bytes,
+                        (unsigned long long)profile_site->alloc_count,
+                        (unsigned long long)profile_site->alloc_bytes);
+      for (j = 0; j < profile_site->depth; j++) {
+        mm_profile_printf(&writer, " %p", profile_site->stack[j]);
+      }
+      mm_profile_printf(&writer, "\n");
+    }
+
+    // pprof maps the addresses back to the binaries with the memory map
+    mm_profile_printf(&writer, "\nMAPPED_LIBRARIES:\n");
+    int maps_fd = open("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+    if (maps_fd >= 0) {
+      ssize_t len;
+      mm_profile_flush(&writer);
+      while ((len = read(maps_fd, writer.buf, sizeof(writer.buf))) > 0) {
+        writer.len = len;
+        mm_profile_flush(&writer);
+      }
+      close(maps_fd);
+    }
+  }
+  pthread_mutex_unlock(&mm_profile_lock);
+
+  mm_profile_flush(&writer);
+  close(writer.fd);
+
+  return writer.failed ? -1 : 0;
+}
+
+//-----------------< Movable Relocatable objects -----------------/
+static void mm_handle_family_create(void) {
+  mm_handle_family = mm_instantiate_new_slab_family("mm_handle_slot_t",
+                                                    sizeof(mm_handle_slot_t));
+}
+
+vm_page_family_t *mm_instantiate_new_movable_page_family(char *struct_name,
+                                                         uint32_t struct_size) {
+  pthread_once(&mm_handle_family_once, mm_handle_family_create);
+  if (!mm_handle_family) {
+    printf("Error: Could not register the handles of movable objects\n");
+    return NULL;
+  }
+
+  pthread_mutex_lock(&mm_registry_lock);
+  vm_page_family_t *vm_page_family = mm_reserve_page_family(struct_name);
+  if (vm_page_family) {
+    vm_page_family->is_movable = MM_TRUE;
+    mm_publish_page_family(vm_page_family, struct_size);
+  }
+  pthread_mutex_unlock(&mm_registry_lock);
+  return vm_page_family;
+}
+
+MM_ALLOC_TEXT
+mm_handle_slot_t *xcalloc_movable(vm_page_family_t *vm_page_family,
+                                  int units) {
+  block_meta_data_t *block_meta_data = NULL;
+  uint32_t dirty_size = 0;
+
+  if (!vm_page_family || !vm_page_family->is_movable) {
+    printf("Error: %s() called with a page family that is not movable\n",
+           __FUNCTION__);
+    return NULL;
+  }
+
+  // Check if the requested memory size and the prefix fit in a block
+  if ((uint64_t)units * vm_page_family->struct_size + MM_MOVABLE_PREFIX >
+      MM_MAX_BLOCK_SIZE) {
+    printf("Error: Memory requested exceeds the maximum block size\n");
+    return NULL;
+  }
+  uint32_t req_size = units * vm_page_family->struct_size + MM_MOVABLE_PREFIX;
+  vm_page_family = mm_numa_family(vm_page_family);
+
+  pthread_mutex_lock(&mm_handle_family->family_lock);
+  mm_handle_slot_t *handle =
+      mm_slab_alloc_locked(mm_handle_family, &dirty_size);
+  pthread_mutex_unlock(&mm_handle_family->family_lock);
+  if (!handle) {
+    return NULL;
+  }
+
+  // The object stays pinned, out of the compactor's reach, until it is
+  // initialized
+  handle->pins = 1;
+
+  if (req_size > MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
+    // Large object spans are never compacted
+    block_meta_data =
+        mm_allocate_large_block(vm_page_family, req_size, &dirty_size);
+  } else {
+    req_size = mm_block_size_round(vm_page_family, req_size);
+    pthread_mutex_lock(&vm_page_family->family_lock);
+    block_meta_data =
+        mm_allocate_free_data_block(vm_page_family, req_size, &dirty_size);
+    // The compactor may look the handle up as soon as the lock is released
+    if (block_meta_data) {
+      *(mm_handle_slot_t **)(block_meta_data + 1) = handle;
+    }
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+  }
+
+  if (!block_meta_data) {
+    pthread_mutex_lock(&mm_handle_family->family_lock);
+    mm_slab_free_locked(MM_GET_PAGE_FROM_APP_DATA(handle), handle);
+    pthread_mutex_unlock(&mm_handle_family->family_lock);
+    return NULL;
+  }
+
+  char *data = (char *)(block_meta_data + 1);
+  *(mm_handle_slot_t **)data = handle;
+  handle->app_data = data + MM_MOVABLE_PREFIX;
+
+  // Only clear the bytes that are not known to be zero already
+  if (dirty_size > MM_MOVABLE_PREFIX) {
+    memset(handle->app_data, 0, dirty_size - MM_MOVABLE_PREFIX);
+  }
+  mm_stats_count_ops(1, 0);
+  mm_profile_alloc_hook(handle->app_data,
+                        block_meta_data->block_size - MM_MOVABLE_PREFIX);
+
+  __atomic_store_n(&handle->pins, 0, __ATOMIC_RELEASE);
+  return handle;
+}
+
+void xfree_movable(mm_handle_slot_t *handle) {
+  if (!handle) {
+    return;
+  }
+
+  // The pin waits for a move in progress and keeps the compactor away
+  void *app_data = mm_handle_pin(handle);
+  block_meta_data_t *block_meta_data =
+      (block_meta_data_t *)((char *)app_data - MM_MOVABLE_PREFIX) - 1;
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_META_BLOCK(block_meta_data);
+  vm_page_family_t *vm_page_family = hosting_page->pg_family;
+
+  mm_stats_count_ops(0, 1);
+  mm_profile_free_hook(app_data);
+
+  if (hosting_page->page_kind == MM_PAGE_LARGE) {
+    mm_free_large_block(hosting_page);
+  } else {
+    pthread_mutex_lock(&vm_page_family->family_lock);
+    mm_free_blocks(block_meta_data);
+    pthread_mutex_unlock(&vm_page_family->family_lock);
+  }
+
+  pthread_mutex_lock(&mm_handle_family->family_lock);
+  mm_slab_free_locked(MM_GET_PAGE_FROM_APP_DATA(handle), handle);
+  pthread_mutex_unlock(&mm_handle_family->family_lock);
+}
+
+void *mm_handle_pin(mm_handle_slot_t *handle) {
+  uint32_t pins = __atomic_fetch_add(&handle->pins, 1, __ATOMIC_ACQUIRE);
+
+  // The compactor publishes the new address before clearing the bit
+  while (pins & MM_HANDLE_MOVING) {
+    sched_yield();
+    pins = __atomic_load_n(&handle->pins, __ATOMIC_ACQUIRE);
+  }
+  return __atomic_load_n(&handle->app_data, __ATOMIC_RELAXED);
+}
+
+void mm_handle_unpin(mm_handle_slot_t *handle) {
+  __atomic_fetch_sub(&handle->pins, 1, __ATOMIC_RELEASE);
+}
+
+//-----------------< Compaction Evacuation of sparse pages -----------------/
+static block_meta_data_t *
+mm_compact_alloc_locked(vm_page_family_t *vm_page_family, uint32_t req_size) {
+  uint32_t bin = mm_free_bin_index(req_size);
+  uint64_t bins = vm_page_family->free_bins_bitmap & (~0ULL << bin);
+  glthread_t *curr = NULL;
+
+  // First fit in size class order, walking past the free blocks of the
+  // pages being evacuated
+  while (bins) {
+    bin = __builtin_ctzll(bins);
+    bins &= bins - 1;
+    ITERATE_GLTHREAD_BEGIN(&vm_page_family->free_bins[bin], curr) {
+      block_meta_data_t *block_meta_data = glthread_to_block_meta_data(curr);
+      vm_page_t *vm_page = MM_GET_PAGE_FROM_META_BLOCK(block_meta_data);
+      if (block_meta_data->block_size >= req_size && !vm_page->is_evacuating) {
+        mm_split_free_data_block_for_allocation(vm_page_family,
+                                                block_meta_data, req_size);
+        mm_block_claim_dirty_size(block_meta_data);
+        return block_meta_data;
+      }
+    }
+    ITERATE_GLTHREAD_END(&vm_page_family->free_bins[bin], curr);
+  }
+
+  return NULL;
+}
+
+static int mm_movable_block_move_locked(vm_page_family_t *vm_page_family,
+                                        block_meta_data_t *block_meta_data) {
+  mm_handle_slot_t *handle = *(mm_handle_slot_t **)(block_meta_data + 1);
+  uint32_t pins = 0;
+
+  if (!__atomic_compare_exchange_n(&handle->pins, &pins, MM_HANDLE_MOVING, 0,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+    return 0;
+  }
+
+  block_meta_data_t *new_block_meta_data =
+      mm_compact_alloc_locked(vm_page_family, block_meta_data->block_size);
+  if (!new_block_meta_data) {
+    __atomic_fetch_and(&handle->pins, ~MM_HANDLE_MOVING, __ATOMIC_RELEASE);
+    return -1;
+  }
+
+  // The prefix moves along with the object, still pointing at the handle
+  memcpy(new_block_meta_data + 1, block_meta_data + 1,
+         block_meta_data->block_size);
+  void *app_data = (char *)(new_block_meta_data + 1) + MM_MOVABLE_PREFIX;
+  if (__builtin_expect(
+          __atomic_load_n(&mm_heap_profile, __ATOMIC_ACQUIRE) != NULL, 0)) {
+    mm_profile_move(handle->app_data, app_data);
+  }
+  __atomic_store_n(&handle->app_data, app_data, __ATOMIC_RELAXED);
+  __atomic_fetch_and(&handle->pins, ~MM_HANDLE_MOVING, __ATOMIC_RELEASE);
+
+  mm_free_blocks(block_meta_data);
+  __atomic_fetch_add(&mm_moved_objects, 1, __ATOMIC_RELAXED);
+  return 1;
+}
+
+uint32_t mm_compact(vm_page_family_t *vm_page_family, uint32_t max_pages) {
+  vm_page_t *victims[MM_COMPACT_MAX_PAGES];
+  uint32_t victim_used[MM_COMPACT_MAX_PAGES];
+  uint32_t victim_count = 0;
+  uint32_t emptied = 0;
+  uint32_t i;
+  vm_page_t *vm_page = NULL;
+  block_meta_data_t *block_meta_data = NULL;
+
+  if (!vm_page_family || !vm_page_family->is_movable) {
+    printf("Error: %s() called with a page family that is not movable\n",
+           __FUNCTION__);
+    return 0;
+  }
+  if (max_pages > MM_COMPACT_MAX_PAGES) {
+    max_pages = MM_COMPACT_MAX_PAGES;
+  }
+  if (!max_pages) {
+    return 0;
+  }
+
+  uint32_t capacity = mm_max_page_allocatable_memory(1);
+  pthread_mutex_lock(&vm_page_family->family_lock);
+
+  // Keep the sparsest pages, sorted by the bytes their live blocks take
+  ITERATE_VM_PAGE_BEGIN(vm_page_family, vm_page) {
+    uint32_t used = 0;
+    ITERATE_VM_PAGE_ALL_BLOCKS_BEGIN(vm_page, block_meta_data) {
+      if (!block_meta_data->is_free) {
+        used += sizeof(block_meta_data_t) + block_meta_data->block_size;
+      }
+    }
+    ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page, block_meta_data);
+
+    if ((uint64_t)used * 100 >=
+        (uint64_t)capacity * MM_COMPACT_SPARSE_PERCENT) {
+      continue;
+    }
+    if (victim_count == max_pages) {
+      if (used >= victim_used[max_pages - 1]) {
+        continue;
+      }
+      victim_count--;
+    }
+    for (i = victim_count; i > 0 && victim_used[i - 1] > used; i--) {
+      victims[i] = victims[i - 1];
+      victim_used[i] = victim_used[i - 1];
+    }
+    victims[i] = vm_page;
+    victim_used[i] = used;
+    victim_count++;
+  }
+  ITERATE_VM_PAGE_END(vm_page_family, vm_page);
+
+  // Only evacuate what the free blocks of the remaining pages can take
+  uint64_t room = vm_page_family->free_bytes;
+  uint64_t moved = 0;
+  for (i = 0; i < victim_count; i++) {
+    uint64_t victim_free = capacity - victim_used[i];
+    if (room < victim_free || moved + victim_used[i] > room - victim_free) {
+      break;
+    }
+    room -= victim_free;
+    moved += victim_used[i];
+  }
+  victim_count = i;
+
+  for (i = 0; i < victim_count; i++) {
+    victims[i]->is_evacuating = MM_TRUE;
+  }
+
+  for (i = 0; i < victim_count; i++) {
+    vm_bool_t pinned = MM_FALSE;
+    int status = 1;
+
+    block_meta_data = &victims[i]->block_meta_data;
+    while (block_meta_data) {
+      // Free blocks never touch, so the block after a free one is in use
+      // and survives the merges made when the current block is freed
+      block_meta_data_t *next = NEXT_META_BLOCK(block_meta_data);
+      if (next && next->is_free) {
+        next = NEXT_META_BLOCK(next);
+      }
+      if (!block_meta_data->is_free) {
+        status = mm_movable_block_move_locked(vm_page_family, block_meta_data);
+        if (status < 0) {
+          break;
+        }
+        if (status == 0) {
+          pinned = MM_TRUE;
+        }
+      }
+      block_meta_data = next;
+    }
+    if (status < 0) {
+      break;
+    }
+
+    // Freeing the last block handed the page to the page retention pool
+    if (!pinned) {
+      victims[i] = NULL;
+      emptied++;
+    }
+  }
+
+  for (i = 0; i < victim_count; i++) {
+    if (victims[i]) {
+      victims[i]->is_evacuating = MM_FALSE;
+    }
+  }
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  __atomic_fetch_add(&mm_compacted_pages, emptied, __ATOMIC_RELAXED);
+  return emptied;
+}
+
+static uint32_t mm_family_free_percent(vm_page_family_t *vm_page_family) {
+  uint32_t percent = 0;
+
+  // A single page has nowhere to move its objects to
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  if (vm_page_family->data_pages > 1) {
+    percent = vm_page_family->free_bytes * 100 /
+              ((uint64_t)vm_page_family->data_pages *
+               mm_max_page_allocatable_memory(1));
+  }
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+
+  return percent;
+}
+
+static void *mm_compactor_thread(void *arg) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
+  struct timespec deadline;
+  (void)arg;
+
+  pthread_mutex_lock(&mm_compactor_lock);
+  for (;;) {
+    mm_deadline_after_ms(&deadline, mm_compactor_interval_ms);
+    while (!mm_compactor_stopping &&
+           pthread_cond_timedwait(&mm_compactor_cond, &mm_compactor_lock,
+                                  &deadline) == 0) {
+    }
+    if (mm_compactor_stopping) {
+      break;
+    }
+    uint32_t threshold = mm_compactor_threshold;
+    pthread_mutex_unlock(&mm_compactor_lock);
+
+    for (families_page = mm_first_families_page(); families_page;
+         families_page = families_page->next) {
+      ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+        if (vm_page_family_curr->is_movable &&
+            mm_family_free_percent(vm_page_family_curr) >= threshold) {
+          mm_compact(vm_page_family_curr, MM_COMPACT_STEP_PAGES);
+        }
+      }
+      ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
+    }
+
+    pthread_mutex_lock(&mm_compactor_lock);
   }
+  pthread_mutex_unlock(&mm_compactor_lock);
+
+  return NULL;
 }
 
-static int free_blocks_comparison_function(void *_block_meta_data1,
-                                           void *_block_meta_data2) {
-  block_meta_data_t *block_meta_data1 = (block_meta_data_t *)_block_meta_data1;
-  block_meta_data_t *block_meta_data2 = (block_meta_data_t *)_block_meta_data2;
+int mm_compactor_start(uint32_t interval_ms, uint32_t threshold_percent) {
+  pthread_mutex_lock(&mm_compactor_lock);
+  if (mm_compactor_running) {
+    pthread_mutex_unlock(&mm_compactor_lock);
+    printf("Error: The compactor is already running\n");
+    return -1;
+  }
+  if (!interval_ms || !threshold_percent || threshold_percent > 100) {
+    pthread_mutex_unlock(&mm_compactor_lock);
+    printf("Error: %s() called with an invalid interval or threshold\n",
+           __FUNCTION__);
+    return -1;
+  }
 
-  if (block_meta_data1->block_size > block_meta_data2->block_size) {
+  mm_compactor_interval_ms = interval_ms;
+  mm_compactor_threshold = threshold_percent;
+  mm_compactor_stopping = 0;
+  if (pthread_create(&mm_compactor_tid, NULL, mm_compactor_thread, NULL) !=
+      0) {
+    pthread_mutex_unlock(&mm_compactor_lock);
+    printf("Error: Could not start the compactor thread\n");
     return -1;
-  } else if (block_meta_data1->block_size < block_meta_data2->block_size) {
-    return 1;
-  } else {
-    return 0;
   }
+  mm_compactor_running = 1;
+  pthread_mutex_unlock(&mm_compactor_lock);
+
+  return 0;
 }
 
-static void
-mm_add_free_block_meta_data_to_free_block_list(vm_page_family_t *vm_page_family,
-                                               block_meta_data_t *free_block) {
+void mm_compactor_stop() {
+  pthread_mutex_lock(&mm_compactor_lock);
+  if (!mm_compactor_running) {
+    pthread_mutex_unlock(&mm_compactor_lock);
+    return;
+  }
+  mm_compactor_stopping = 1;
+  pthread_cond_signal(&mm_compactor_cond);
+  pthread_mutex_unlock(&mm_compactor_lock);
 
-  // Assert that the free_block is indeed marked as free
-  assert(free_block->is_free == MM_TRUE);
+  pthread_join(mm_compactor_tid, NULL);
 
-  // Insert the free block metadata into the free block list of the virtual
-  // memory page family
-  glthread_priority_insert(&vm_page_family->free_block_priority_list_head,
-                           &free_block->priority_thread_glue,
-                           free_blocks_comparison_function,
-                           offset_of(block_meta_data_t, priority_thread_glue));
+  pthread_mutex_lock(&mm_compactor_lock);
+  mm_compactor_running = 0;
+  pthread_mutex_unlock(&mm_compactor_lock);
 }
 
-static int mm_get_hard_internal_memory_frag_size(block_meta_data_t *first,
-                                                 block_meta_data_t *second) {
-  // Get the next block after the first block
-  block_meta_data_t *next_block = NEXT_META_BLOCK_BY_SIZE(first);
-
-  // Calculate the size of hard internal memory fragmentation
-  return (int)((unsigned long)second - (unsigned long)(next_block));
+//-----------------< Debug Guard pages and canaries -----------------/
+int mm_set_debug_flags(uint32_t flags) {
+  // Objects held by any thread, its cache included, lack the canaries
+  if (__atomic_load_n(&mm_allocations_started, __ATOMIC_ACQUIRE)) {
+    printf("Error: %s() called after objects were allocated\n", __FUNCTION__);
+    return -1;
+  }
+  __atomic_store_n(&mm_debug_flags, flags & MM_DEBUG_ALL, __ATOMIC_RELAXED);
+  return 0;
 }
 
-static block_meta_data_t *mm_free_blocks(block_meta_data_t *to_be_free_block) {
-  block_meta_data_t *return_block = NULL; /// 1 Pointer to the freed block
-  assert(to_be_free_block->is_free == MM_FALSE);
+static void mm_debug_init(void) {
+  static const char *names[] = {"canary", "poison", "guard", "validate"};
+  const char *curr = getenv("HMM_DEBUG");
+  uint32_t i;
 
-  // Retrieving hosting page and page family
-  vm_page_t *hosting_page = MM_GET_PAGE_FROM_META_BLOCK(to_be_free_block);
+  while (curr && *curr) {
+    size_t len = strcspn(curr, ",");
+    uint32_t flags = len == 3 && !strncmp(curr, "all", len) ? MM_DEBUG_ALL : 0;
 
-  // Setting return_block to the block being freed
-  return_block = to_be_free_block;
-  to_be_free_block->is_free = MM_TRUE; /// 2 Marking the block as free
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+      if (strlen(names[i]) == len && !strncmp(curr, names[i], len)) {
+        flags = 1u << i;
+      }
+    }
+    if (!flags && len) {
+      printf("Error: Unknown HMM_DEBUG check %.*s\n", (int)len, curr);
+    }
+    __atomic_fetch_or(&mm_debug_flags, flags, __ATOMIC_RELAXED);
+    curr += len;
+    if (*curr == ',') {
+      curr++;
+    }
+  }
+}
 
-  block_meta_data_t *next_block =
-      NEXT_META_BLOCK(to_be_free_block); /// 3 Next block pointer
+MM_ALLOC_TEXT
+static void *mm_debug_alloc(vm_page_family_t *vm_page_family,
+                            uint32_t req_size, vm_bool_t zero,
+                            uint32_t alignment) {
+  block_meta_data_t *block_meta_data = NULL;
+  uint32_t dirty_size = 0;
+  char *app_data = NULL;
 
-  // Handling Hard IF memory
-  if (next_block) {
-    // Scenario 1: When data block to be freed is not the last uppermost meta
-    // block in a VM data page
-    to_be_free_block->block_size +=
-        mm_get_hard_internal_memory_frag_size(to_be_free_block, next_block);
+  // Over-aligned objects take a guarded span as well, since their data is
+  // aligned where the span ends
+  if ((MM_DEBUG_FLAGS() & MM_DEBUG_GUARD) ||
+      alignment > vm_page_family->alignment) {
+    app_data = mm_debug_alloc_guarded(vm_page_family, req_size, alignment);
+  } else if (req_size > MM_MAX_BLOCK_SIZE - sizeof(mm_debug_trailer_t)) {
+    printf("Error: Memory requested exceeds the maximum block size\n");
   } else {
-    // Scenario 2: Page Boundary condition
-    // Block being freed is the uppermost free data block in a VM data page,
-    // checking for hard internal fragmented memory and merge
-    char *end_address_of_vm_page =
-        (char *)((char *)hosting_page + SYSTEM_PAGE_SIZE);
-    char *end_address_of_free_data_block =
-        (char *)(to_be_free_block + 1) + to_be_free_block->block_size;
-    int internal_mem_fragmentation =
-        (int)((unsigned long)end_address_of_vm_page -
-              (unsigned long)end_address_of_free_data_block);
-    to_be_free_block->block_size += internal_mem_fragmentation;
-  }
+    uint32_t size = mm_block_size_round(
+        vm_page_family, req_size + sizeof(mm_debug_trailer_t));
 
-  // Performing merging with next block if it's free
-  if (next_block && next_block->is_free == MM_TRUE) {
-    mm_union_free_blocks(to_be_free_block,
-                         next_block); /// 4 Union two free blocks
-    return_block = to_be_free_block;
+    if (size > MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
+      block_meta_data =
+          mm_allocate_large_block(vm_page_family, size, &dirty_size);
+      if (block_meta_data) {
+        mm_debug_trailer_set(block_meta_data, req_size);
+      }
+    } else {
+      pthread_mutex_lock(&vm_page_family->family_lock);
+      block_meta_data =
+          mm_allocate_free_data_block(vm_page_family, size, &dirty_size);
+      if (block_meta_data) {
+        mm_debug_trailer_set(block_meta_data, req_size);
+        if (MM_DEBUG_FLAGS() & MM_DEBUG_VALIDATE) {
+          mm_debug_validate_page_locked(
+              MM_GET_PAGE_FROM_META_BLOCK(block_meta_data));
+        }
+      }
+      pthread_mutex_unlock(&vm_page_family->family_lock);
+    }
+    if (block_meta_data) {
+      app_data = (char *)(block_meta_data + 1);
+      if (zero && dirty_size) {
+        memset(app_data, 0, req_size < dirty_size ? req_size : dirty_size);
+      }
+    }
   }
 
-  // Checking the previous block if it was free and merging if necessary
-  block_meta_data_t *prev_block = PREV_META_BLOCK(to_be_free_block);
-  if (prev_block && prev_block->is_free) {
-    mm_union_free_blocks(prev_block, to_be_free_block);
-    return_block = prev_block;
+  if (!app_data) {
+    return NULL;
+  }
+  if (!zero && (MM_DEBUG_FLAGS() & MM_DEBUG_POISON)) {
+    memset(app_data, MM_DEBUG_ALLOC_BYTE, req_size);
   }
+  mm_stats_count_ops(1, 0);
+  mm_profile_alloc_hook(app_data, req_size);
 
-  // Checking if the hosting page becomes empty after freeing this block
-  if (mm_is_vm_page_empty(hosting_page)) {
-    mm_vm_page_delete_and_free(
-        hosting_page); /// 5 Delete and free the hosting page
+  return app_data;
+}
+
+MM_ALLOC_TEXT
+static void *mm_debug_alloc_guarded(vm_page_family_t *vm_page_family,
+                                    uint32_t req_size, uint32_t alignment) {
+  size_t header_size = offset_of(vm_page_t, page_memory);
+
+  if (alignment < vm_page_family->alignment) {
+    alignment = vm_page_family->alignment;
+  }
+  if (alignment > SYSTEM_PAGE_SIZE) {
+    printf("Error: Cannot guard objects aligned on %u bytes\n", alignment);
     return NULL;
   }
 
-  // Adding the freed block metadata to the free block list
-  mm_add_free_block_meta_data_to_free_block_list(hosting_page->pg_family,
-                                                 return_block);
+  // Room for the object, the page header and the header's own alignment
+  // slack, then the guard page
+  size_t data_size =
+      ((size_t)req_size + alignment - 1) & ~(size_t)(alignment - 1);
+  size_t slack = header_size > alignment ? header_size : alignment;
+  uint32_t units =
+      (header_size + data_size + slack + SYSTEM_PAGE_SIZE - 1) /
+          SYSTEM_PAGE_SIZE +
+      1;
+  char *span = mm_get_new_vm_page_from_kernel(units);
+  if (!span) {
+    return NULL;
+  }
+  mm_numa_bind(span, (size_t)units * SYSTEM_PAGE_SIZE,
+               vm_page_family->numa_node);
 
-  return return_block;
-}
+  char *guard = span + (size_t)(units - 1) * SYSTEM_PAGE_SIZE;
+  if (mprotect(guard, SYSTEM_PAGE_SIZE, PROT_NONE) != 0) {
+    printf("Error: Could not protect the guard page\n");
+  }
 
-void xfree(void *app_data) {
-  // Adjust the pointer to point to the block metadata
-  block_meta_data_t *block_meta_data =
-      (block_meta_data_t *)((char *)app_data - sizeof(block_meta_data_t));
+  // Move the object down until the header fits in front of it, in the page
+  // holding its first byte
+  char *app_data = guard - data_size;
+  while (((uintptr_t)app_data - 1) % SYSTEM_PAGE_SIZE + 1 < header_size) {
+    app_data -= alignment;
+  }
 
-  // Ensure that the block is not already free
-  assert(block_meta_data->is_free == MM_FALSE);
+  vm_page_t *vm_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+  vm_page->pg_family = vm_page_family;
+  vm_page->page_kind = MM_PAGE_GUARDED;
+  vm_page->units = units;
+  vm_page->is_hugetlb = MM_FALSE;
+  vm_page->numa_node = vm_page_family->numa_node;
+  vm_page->block_meta_data.is_free = MM_FALSE;
+  vm_page->block_meta_data.block_size = req_size;
+  vm_page->block_meta_data.offset = offset_of(vm_page_t, block_meta_data);
+  vm_page->block_meta_data.prev_offset =
+      ((char *)vm_page - span) / SYSTEM_PAGE_SIZE;
+  vm_page->block_meta_data.prev_free = MM_FALSE;
+  vm_page->block_meta_data.next_offset = 0;
+  memset(app_data + req_size, MM_DEBUG_CANARY_BYTE,
+         guard - (app_data + req_size));
+  __atomic_fetch_add(&mm_large_bytes_in_use, req_size, __ATOMIC_RELAXED);
 
-  // Call the memory manager's free blocks function
-  mm_free_blocks(block_meta_data);
+  return app_data;
 }
 
-//-----------------<  Memory allocation section -----------------/
-static block_meta_data_t *
-mm_allocate_free_data_block(vm_page_family_t *vm_page_family,
-                            uint32_t req_size) {
-
-  vm_bool_t status;
-  vm_page_t *vm_page = NULL;
+static void mm_debug_free(void *app_data) {
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+  vm_page_family_t *vm_page_family = hosting_page->pg_family;
+  block_meta_data_t *block_meta_data = (block_meta_data_t *)app_data - 1;
 
-  // Get the biggest free block in the page family
-  block_meta_data_t *biggest_block_meta_data =
-      mm_get_biggest_free_block_page_family(vm_page_family);
+  mm_stats_count_ops(0, 1);
+  mm_profile_free_hook(app_data);
 
-  // Check if there is no available block or if the available block is too small
-  if (!biggest_block_meta_data ||
-      biggest_block_meta_data->block_size < req_size) {
+  // Unmapping the whole span makes later accesses fault as well
+  if (hosting_page->page_kind == MM_PAGE_GUARDED) {
+    uint32_t req_size = hosting_page->block_meta_data.block_size;
+    char *span = (char *)hosting_page -
+                 (size_t)hosting_page->block_meta_data.prev_offset *
+                     SYSTEM_PAGE_SIZE;
+    uint8_t *guard =
+        (uint8_t *)span + (size_t)(hosting_page->units - 1) * SYSTEM_PAGE_SIZE;
+    uint8_t *curr = (uint8_t *)app_data + req_size;
 
-    // Add a new page to the page family
-    vm_page = mm_family_new_page_add(vm_page_family);
+    for (; (MM_DEBUG_FLAGS() & MM_DEBUG_CANARY) && curr < guard; curr++) {
+      if (*curr != MM_DEBUG_CANARY_BYTE) {
+        mm_debug_report(app_data, "buffer overrun");
+      }
+    }
+    __atomic_fetch_sub(&mm_large_bytes_in_use, req_size, __ATOMIC_RELAXED);
+    mm_return_vm_page_to_kernel(span, hosting_page->units);
+    return;
+  }
 
-    // Allocate the free block from the new page
-    status = mm_split_free_data_block_for_allocation(
-        vm_page_family, &vm_page->block_meta_data, req_size);
+  if (block_meta_data->is_free) {
+    mm_debug_report(app_data, "double free");
+  }
+  // Validation checks the trailer too, once the block header is known sane
+  if ((MM_DEBUG_FLAGS() & (MM_DEBUG_CANARY | MM_DEBUG_VALIDATE)) ==
+      MM_DEBUG_CANARY) {
+    mm_debug_trailer_check(block_meta_data);
+  }
 
-    // Return the allocated block's metadata if successful
-    if (status) {
-      return &vm_page->block_meta_data;
+  if (hosting_page->page_kind == MM_PAGE_LARGE) {
+    if (MM_DEBUG_FLAGS() & MM_DEBUG_VALIDATE) {
+      mm_debug_check_block(hosting_page, block_meta_data);
     }
-    return NULL;
+    mm_free_large_block(hosting_page);
+    return;
   }
 
-  // Attempt to split the biggest free block to satisfy the allocation request
-  status = mm_split_free_data_block_for_allocation(
-      vm_page_family, biggest_block_meta_data, req_size);
+  pthread_mutex_lock(&vm_page_family->family_lock);
+  if (MM_DEBUG_FLAGS() & MM_DEBUG_VALIDATE) {
+    mm_debug_validate_page_locked(hosting_page);
+  }
+  if (MM_DEBUG_FLAGS() & MM_DEBUG_POISON) {
+    memset(app_data, MM_DEBUG_FREE_BYTE, block_meta_data->block_size);
+  }
+  mm_free_blocks(block_meta_data);
+  pthread_mutex_unlock(&vm_page_family->family_lock);
+}
 
-  // Return the allocated block's metadata if successful
-  if (status) {
-    return biggest_block_meta_data;
+MM_ALLOC_TEXT
+static void *mm_debug_realloc(void *app_data, uint32_t req_size) {
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+  uint32_t old_size = mm_debug_object_size(app_data);
+
+  void *new_app_data = mm_debug_alloc(mm_numa_family(hosting_page->pg_family),
+                                      req_size, MM_FALSE, 0);
+  if (!new_app_data) {
+    return NULL;
   }
+  memcpy(new_app_data, app_data, old_size < req_size ? old_size : req_size);
+  mm_debug_free(app_data);
+  __atomic_fetch_add(&mm_realloc_stats.moved, 1, __ATOMIC_RELAXED);
 
-  return NULL;
+  return new_app_data;
 }
 
-static inline block_meta_data_t *
-mm_get_biggest_free_block_page_family(vm_page_family_t *vm_page_family) {
-  // Retrieve the right pointer of the free_block_priority_list_head in the
-  // vm_page_family
-  glthread_t *biggest_free_block_glue =
-      vm_page_family->free_block_priority_list_head.right;
+static uint32_t mm_debug_object_size(void *app_data) {
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
+  block_meta_data_t *block_meta_data = (block_meta_data_t *)app_data - 1;
 
-  // If a block exists in the priority list, return its metadata
-  if (biggest_free_block_glue) {
-    return glthread_to_block_meta_data(biggest_free_block_glue);
+  if (hosting_page->page_kind == MM_PAGE_GUARDED) {
+    return hosting_page->block_meta_data.block_size;
   }
-
-  // If the priority list is empty, return NULL
-  return NULL;
+  return ((mm_debug_trailer_t *)((char *)app_data +
+                                 block_meta_data->block_size) -
+          1)
+      ->req_size;
 }
 
-static vm_bool_t
-mm_split_free_data_block_for_allocation(vm_page_family_t *vm_page_family,
-                                        block_meta_data_t *block_meta_data,
-                                        uint32_t size) {
+static void mm_debug_trailer_set(block_meta_data_t *block_meta_data,
+                                 uint32_t req_size) {
+  uint8_t *app_data = (uint8_t *)(block_meta_data + 1);
+  mm_debug_trailer_t *trailer =
+      (mm_debug_trailer_t *)(app_data + block_meta_data->block_size) - 1;
 
-  block_meta_data_t *next_block_meta_data = NULL;
+  memset(app_data + req_size, MM_DEBUG_CANARY_BYTE,
+         (uint8_t *)trailer - (app_data + req_size));
+  trailer->req_size = req_size;
+  trailer->magic = MM_DEBUG_MAGIC ^ req_size;
+  trailer->canary = 0x0101010101010101ull * MM_DEBUG_CANARY_BYTE;
+}
 
-  // Assert that the provided block is free
-  assert(block_meta_data->is_free == MM_TRUE);
+static void mm_debug_trailer_check(block_meta_data_t *block_meta_data) {
+  uint8_t *app_data = (uint8_t *)(block_meta_data + 1);
+  mm_debug_trailer_t *trailer =
+      (mm_debug_trailer_t *)(app_data + block_meta_data->block_size) - 1;
 
-  // Check if the block size is sufficient for allocation
-  if (block_meta_data->block_size < size) {
-    return MM_FALSE;
+  if (block_meta_data->block_size < sizeof(mm_debug_trailer_t) ||
+      trailer->magic != (MM_DEBUG_MAGIC ^ trailer->req_size) ||
+      trailer->req_size >
+          block_meta_data->block_size - sizeof(mm_debug_trailer_t) ||
+      trailer->canary != 0x0101010101010101ull * MM_DEBUG_CANARY_BYTE) {
+    mm_debug_report(app_data, "buffer overrun");
   }
 
-  // Calculate the remaining size after allocation
-  uint32_t remaining_size = block_meta_data->block_size - size;
+  uint8_t *curr = app_data + trailer->req_size;
+  for (; curr < (uint8_t *)trailer; curr++) {
+    if (*curr != MM_DEBUG_CANARY_BYTE) {
+      mm_debug_report(app_data, "buffer overrun");
+    }
+  }
+}
 
-  // Update metadata for the allocated portion
-  block_meta_data->is_free = MM_FALSE;
-  block_meta_data->block_size = size;
-  remove_glthread(&block_meta_data->priority_thread_glue);
+static void mm_debug_check_block(vm_page_t *vm_page,
+                                 block_meta_data_t *block_meta_data) {
+  size_t page_size = (size_t)vm_page->units * SYSTEM_PAGE_SIZE;
+  size_t offset = (char *)block_meta_data - (char *)vm_page;
+  size_t end =
+      offset + sizeof(block_meta_data_t) + block_meta_data->block_size;
 
-  // Case 1: No Split
-  if (!remaining_size) {
-    return MM_TRUE;
+  if (block_meta_data->offset != offset || end > page_size) {
+    mm_debug_report(block_meta_data + 1, "corrupted block header");
   }
-
-  // Case 3-1: Partial Split - Soft Internal Fragmentation
-  else if (sizeof(block_meta_data_t) < remaining_size &&
-           remaining_size <
-               (sizeof(block_meta_data_t) + vm_page_family->struct_size)) {
-    // Create a new metadata block for the remaining space
-    next_block_meta_data = NEXT_META_BLOCK_BY_SIZE(block_meta_data);
-    next_block_meta_data->is_free = MM_TRUE;
-    next_block_meta_data->block_size =
-        remaining_size - sizeof(block_meta_data_t);
-    next_block_meta_data->offset = block_meta_data->offset +
-                                   sizeof(block_meta_data_t) +
-                                   block_meta_data->block_size;
-    init_glthread(&next_block_meta_data->priority_thread_glue);
-    mm_add_free_block_meta_data_to_free_block_list(vm_page_family,
-                                                   next_block_meta_data);
-    mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
+  if (block_meta_data->next_offset &&
+      (block_meta_data->next_offset < end ||
+       block_meta_data->next_offset + sizeof(block_meta_data_t) > page_size ||
+       NEXT_META_BLOCK(block_meta_data)->prev_offset != offset ||
+       NEXT_META_BLOCK(block_meta_data)->prev_free !=
+           block_meta_data->is_free)) {
+    mm_debug_report(block_meta_data + 1, "corrupted block chain");
   }
 
-  // Case 3-2: Partial Split - Hard Internal Fragmentation
-  else if (remaining_size < sizeof(block_meta_data_t)) {
-    // No need to do anything
+  // Movable objects have no trailer
+  if (!block_meta_data->is_free && (MM_DEBUG_FLAGS() & MM_DEBUG_CANARY) &&
+      !vm_page->pg_family->is_movable) {
+    mm_debug_trailer_check(block_meta_data);
   }
+}
 
-  // Case 2: Full Split - New Metadata Block Created
-  else {
-    // Create a new metadata block for the remaining space
-    next_block_meta_data = NEXT_META_BLOCK_BY_SIZE(block_meta_data);
-    next_block_meta_data->is_free = MM_TRUE;
-    next_block_meta_data->block_size =
-        remaining_size - sizeof(block_meta_data_t);
-    next_block_meta_data->offset = block_meta_data->offset +
-                                   sizeof(block_meta_data_t) +
-                                   block_meta_data->block_size;
-    init_glthread(&next_block_meta_data->priority_thread_glue);
-    mm_add_free_block_meta_data_to_free_block_list(vm_page_family,
-                                                   next_block_meta_data);
-    mm_bind_blocks_for_allocation(block_meta_data, next_block_meta_data);
-  }
+static void mm_debug_validate_page_locked(vm_page_t *vm_page) {
+  block_meta_data_t *block_meta_data = NULL;
 
-  return MM_TRUE;
+  // The walk verifies each block it meets
+  ITERATE_VM_PAGE_ALL_BLOCKS_BEGIN(vm_page, block_meta_data) {}
+  ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page, block_meta_data);
 }
 
-void *xcalloc(char *struct_name, int units) {
-  // Initialize variables
-  char data_type[MAX_STRUCT_NAME_LEN];
-  uint8_t data_type_error_flag = 0;
-  vm_page_family_t *pg_family = NULL;
+static void mm_debug_report(void *app_data, const char *what) {
+  vm_page_t *hosting_page = MM_GET_PAGE_FROM_APP_DATA(app_data);
 
-  // Parse the struct name and set the data type error
-  parse_struct_name(struct_name, data_type, &data_type_error_flag);
+  printf("Error: %s at %p, an object of %s\n", what, app_data,
+         hosting_page->pg_family->struct_name);
+  fflush(stdout);
+  abort();
+}
 
-  // Check if there was an error parsing the struct name
-  if (data_type_error_flag == 1) {
-    // Step 1: Look up the page family associated with the structure name
-    pg_family = lookup_page_family_by_name(struct_name);
-  } else {
-    // Step 1: Look up the page family associated with the data type
-    pg_family = lookup_page_family_by_name(data_type);
-  }
+//-----------------< Fork Fork handlers -----------------/
+void mm_fork_prepare(void) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
 
-  // If the page family is not registered, register it
-  if (!pg_family && (!data_type_error_flag || data_type_error_flag == 2)) {
-    mm_instantiate_new_page_family(data_type, get_size_of_datatype(data_type));
-    pg_family = lookup_page_family_by_name(data_type);
-  } else if (!pg_family) {
-    printf("Error: Structure %s not registered with Memory Manager\n",
-           struct_name);
-    return NULL;
+  pthread_mutex_lock(&mm_compactor_lock);
+  pthread_mutex_lock(&mm_stats_dump_lock);
+  pthread_mutex_lock(&mm_numa_lock);
+  // No family can be registered past this point, so the walk below and the
+  // ones of the other handlers see the same families
+  pthread_mutex_lock(&mm_registry_lock);
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      pthread_mutex_lock(&vm_page_family_curr->family_lock);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
   }
+  pthread_mutex_lock(&mm_global_page_pool_lock);
+  pthread_mutex_lock(&mm_profile_lock);
+  pthread_mutex_lock(&mm_stats_lock);
+}
 
-  if (data_type_error_flag == 2) {
-    pg_family->struct_size = atoi(struct_name);
-  } else {
-    pg_family->struct_size = get_size_of_datatype(data_type);
-  }
+void mm_fork_parent(void) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
 
-  // Check if the requested memory size exceeds the maximum allocatable memory
-  // per page
-  if (units * pg_family->struct_size > MAX_PAGE_ALLOCATABLE_MEMORY(1)) {
-    printf("Error: Memory requested exceeds page size\n");
-    return NULL;
+  pthread_mutex_unlock(&mm_stats_lock);
+  pthread_mutex_unlock(&mm_profile_lock);
+  pthread_mutex_unlock(&mm_global_page_pool_lock);
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      pthread_mutex_unlock(&vm_page_family_curr->family_lock);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
   }
+  pthread_mutex_unlock(&mm_registry_lock);
+  pthread_mutex_unlock(&mm_numa_lock);
+  pthread_mutex_unlock(&mm_stats_dump_lock);
+  pthread_mutex_unlock(&mm_compactor_lock);
+}
 
-  // Find a free block in the page family to satisfy the allocation request
-  block_meta_data_t *free_block_meta_data =
-      mm_allocate_free_data_block(pg_family, units * pg_family->struct_size);
+void mm_fork_child(void) {
+  vm_page_for_families_t *families_page;
+  vm_page_family_t *vm_page_family_curr;
 
-  // Check if the allocation was successful
-  if (free_block_meta_data) {
-    // Initialize the allocated memory to zero
-    memset((char *)(free_block_meta_data + 1), 0,
-           free_block_meta_data->block_size);
-    // Return a pointer to the allocated memory
-    return (void *)(free_block_meta_data + 1);
+  // Only the forking thread exists in the child, so the locks it holds are
+  // simply made anew
+  pthread_mutex_init(&mm_stats_lock, NULL);
+  pthread_mutex_init(&mm_profile_lock, NULL);
+  pthread_mutex_init(&mm_global_page_pool_lock, NULL);
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      pthread_mutex_init(&vm_page_family_curr->family_lock, NULL);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
   }
+  pthread_mutex_init(&mm_registry_lock, NULL);
+  pthread_mutex_init(&mm_numa_lock, NULL);
 
-  // Return NULL if the allocation failed
-  return NULL;
+  // The background threads were not duplicated
+  if (mm_stats_dump_fd >= 0) {
+    close(mm_stats_dump_fd);
+    mm_stats_dump_fd = -1;
+  }
+  mm_stats_dump_running = 0;
+  mm_stats_dump_stopping = 0;
+  pthread_cond_init(&mm_stats_dump_cond, NULL);
+  pthread_mutex_init(&mm_stats_dump_lock, NULL);
+  mm_compactor_running = 0;
+  mm_compactor_stopping = 0;
+  pthread_cond_init(&mm_compactor_cond, NULL);
+  pthread_mutex_init(&mm_compactor_lock, NULL);
 }
 
 //-----------------< Printing information section -----------------/
@@ -615,12 +4423,13 @@ void mm_print_registered_page_families() {
   // structure
   uint32_t struct_size; // Size of the structure
 
+  // Pointer to iterate over virtual memory pages
+  vm_page_for_families_t *current_page = mm_first_families_page();
+
   // Check if there are no registered page families
-  if (first_vm_page_for_families == NULL) {
+  if (current_page == NULL) {
     printf("No page families registered for printing.\n");
   } else {
-    // Pointer to iterate over virtual memory pages
-    vm_page_for_families_t *current_page = first_vm_page_for_families;
 
     // Iterate over all virtual memory pages containing page families
     do {
@@ -641,62 +4450,114 @@ void mm_print_registered_page_families() {
   }
 }
 
+static void mm_slab_block_usage(vm_page_t *vm_page,
+                                uint32_t *total_block_count,
+                                uint32_t *free_block_count,
+                                uint32_t *occupied_block_count,
+                                uint32_t *application_memory_usage) {
+  for (; vm_page; vm_page = vm_page->next) {
+    vm_page_family_t *vm_page_family = vm_page->pg_family;
+    uint32_t used_slots = vm_page->slab_meta_data.used_slots;
+
+    *total_block_count += vm_page_family->slab_slots_per_page;
+    *free_block_count += vm_page_family->slab_slots_per_page - used_slots;
+    *occupied_block_count += used_slots;
+    *application_memory_usage += used_slots * vm_page_family->slab_slot_size;
+  }
+}
+
 void mm_print_block_usage() {
+  vm_page_for_families_t *families_page;
   vm_page_t *vm_page_curr;
   vm_page_family_t *vm_page_family_curr;
   block_meta_data_t *block_meta_data_curr;
   uint32_t total_block_count, free_block_count, occupied_block_count;
   uint32_t application_memory_usage;
 
-  // Iterate over page families
-  ITERATE_PAGE_FAMILIES_BEGIN(first_vm_page_for_families, vm_page_family_curr) {
-    // Initialize counters
-    total_block_count = 0;
-    free_block_count = 0;
-    application_memory_usage = 0;
-    occupied_block_count = 0;
-
-    // Iterate over virtual memory pages
-    ITERATE_VM_PAGE_BEGIN(vm_page_family_curr, vm_page_curr) {
-      // Iterate over all blocks within the page
-      ITERATE_VM_PAGE_ALL_BLOCKS_BEGIN(vm_page_curr, block_meta_data_curr) {
-        // Increment total block count
-        total_block_count++;
+  // Objects parked in the caller's thread cache would show up as occupied
+  mm_thread_cache_flush();
 
-        // Perform sanity checks
-        if (block_meta_data_curr->is_free == MM_FALSE) {
-          assert(IS_GLTHREAD_LIST_EMPTY(
-              &block_meta_data_curr->priority_thread_glue));
-        }
-        if (block_meta_data_curr->is_free == MM_TRUE) {
-          assert(!IS_GLTHREAD_LIST_EMPTY(
-              &block_meta_data_curr->priority_thread_glue));
-        }
+  // Iterate over page families on every page hosting them
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      // Initialize counters
+      total_block_count = 0;
+      free_block_count = 0;
+      application_memory_usage = 0;
+      occupied_block_count = 0;
+
+      // Iterate over virtual memory pages
+      ITERATE_VM_PAGE_BEGIN(vm_page_family_curr, vm_page_curr) {
+        // Iterate over all blocks within the page
+        ITERATE_VM_PAGE_ALL_BLOCKS_BEGIN(vm_page_curr, block_meta_data_curr) {
+          // Increment total block count
+          total_block_count++;
 
-        // Update counts based on block status
-        if (block_meta_data_curr->is_free == MM_TRUE) {
-          free_block_count++;
-        } else {
-          application_memory_usage +=
-              block_meta_data_curr->block_size + sizeof(block_meta_data_t);
-          occupied_block_count++;
+          // Perform sanity checks
+          if (block_meta_data_curr->is_free == MM_TRUE) {
+            assert(!IS_GLTHREAD_LIST_EMPTY(
+                MM_FREE_BLOCK_GLUE(block_meta_data_curr)));
+            assert(vm_page_family_curr->free_bins_bitmap &
+                   (1ULL << mm_free_bin_index(
+                        block_meta_data_curr->block_size)));
+          }
+
+          // Update counts based on block status
+          if (block_meta_data_curr->is_free == MM_TRUE) {
+            free_block_count++;
+          } else {
+            application_memory_usage +=
+                block_meta_data_curr->block_size + sizeof(block_meta_data_t);
+            occupied_block_count++;
+          }
         }
+        ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page_curr, block_meta_data_curr);
+      }
+      ITERATE_VM_PAGE_END(vm_page_family_curr, vm_page_curr);
+
+      // Slots of slab pages count as blocks without metadata
+      mm_slab_block_usage(vm_page_family_curr->slab_partial_pages,
+                          &total_block_count, &free_block_count,
+                          &occupied_block_count, &application_memory_usage);
+      mm_slab_block_usage(vm_page_family_curr->slab_full_pages,
+                          &total_block_count, &free_block_count,
+                          &occupied_block_count, &application_memory_usage);
+
+      // Each large object span hosts a single occupied block
+      for (vm_page_curr = vm_page_family_curr->first_large_page; vm_page_curr;
+           vm_page_curr = vm_page_curr->next) {
+        total_block_count++;
+        occupied_block_count++;
+        application_memory_usage += vm_page_curr->block_meta_data.block_size +
+                                    sizeof(block_meta_data_t);
       }
-      ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page_curr, block_meta_data_curr);
-    }
-    ITERATE_VM_PAGE_END(vm_page_family_curr, vm_page_curr);
 
-    // Print block usage information for the current page family
-    printf("%-20s   TBC : %-4u    FBC : %-4u    OBC : %-4u AppMemUsage : %u\n",
-           vm_page_family_curr->struct_name, total_block_count,
-           free_block_count, occupied_block_count, application_memory_usage);
+      // Print block usage information for the current page family
+      printf(
+          "%-20s   TBC : %-4u    FBC : %-4u    OBC : %-4u AppMemUsage : %u\n",
+          vm_page_family_curr->struct_name, total_block_count,
+          free_block_count, occupied_block_count, application_memory_usage);
+    }
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
   }
-  ITERATE_PAGE_FAMILIES_END(first_vm_page_for_families, vm_page_family_curr);
 }
 
 void mm_print_vm_page_details(vm_page_t *vm_page) {
   printf("\t\t next = %p, prev = %p\n", vm_page->next, vm_page->prev);
   printf("\t\t page family = %s\n", vm_page->pg_family->struct_name);
+  if (vm_page->page_kind == MM_PAGE_LARGE) {
+    printf("\t\t large object span, units = %u%s\n", vm_page->units,
+           vm_page->is_hugetlb ? " (huge pages)" : "");
+  }
+  if (vm_page->page_kind == MM_PAGE_SLAB) {
+    // Slab pages have no blocks to walk
+    printf("\t\t slab page, slots used = %u/%u, slot size = %u\n",
+           vm_page->slab_meta_data.used_slots,
+           vm_page->pg_family->slab_slots_per_page,
+           vm_page->pg_family->slab_slot_size);
+    return;
+  }
 
   uint32_t j = 0;
   block_meta_data_t *curr;
@@ -706,55 +4567,108 @@ void mm_print_vm_page_details(vm_page_t *vm_page) {
     printf("\t\t\t%-14p Block %-3u %s  block_size = %-6u  "
            "offset = %-6u  prev = %-14p  next = %p\n",
            curr, j++, curr->is_free ? "F R E E D" : "ALLOCATED",
-           curr->block_size, curr->offset, curr->prev_block, curr->next_block);
+           curr->block_size, curr->offset, PREV_META_BLOCK(curr),
+           NEXT_META_BLOCK(curr));
   }
   ITERATE_VM_PAGE_ALL_BLOCKS_END(vm_page, curr);
 }
 
 void mm_print_memory_usage(char *struct_name) {
+  vm_page_for_families_t *families_page;
   vm_page_t *vm_page = NULL;
   vm_page_family_t *vm_page_family_curr;
   uint32_t number_of_struct_families = 0;
   uint32_t cumulative_vm_pages_claimed_from_kernel = 0;
 
+  // Objects parked in the caller's thread cache keep their pages alive
+  mm_thread_cache_flush();
+
   // Print page size
   printf("\nPage Size = %zu Bytes\n", SYSTEM_PAGE_SIZE);
 
-  // Iterate over each virtual memory page family
-  ITERATE_PAGE_FAMILIES_BEGIN(first_vm_page_for_families, vm_page_family_curr) {
-    if (struct_name) {
-      // Filter output by structure name if specified
-      if (strncmp(struct_name, vm_page_family_curr->struct_name,
-                  strlen(vm_page_family_curr->struct_name)) != 0) {
-        continue;
+  // Iterate over page families on every page hosting them
+  for (families_page = mm_first_families_page(); families_page;
+       families_page = families_page->next) {
+    ITERATE_PAGE_FAMILIES_BEGIN(families_page, vm_page_family_curr) {
+      if (struct_name) {
+        // Filter output by structure name if specified
+        if (strncmp(struct_name, vm_page_family_curr->struct_name,
+                    strlen(vm_page_family_curr->struct_name)) != 0) {
+          continue;
+        }
       }
-    }
 
-    // Increment number of structure families processed
-    number_of_struct_families++;
+      // Increment number of structure families processed
+      number_of_struct_families++;
+
+      // Print details of each virtual memory page family
+      printf(ANSI_COLOR_GREEN
+             "vm_page_family : %s, struct size = %u\n" ANSI_COLOR_RESET,
+             vm_page_family_curr->struct_name,
+             vm_page_family_curr->struct_size);
+
+      // Iterate over each virtual memory page within the family
+      ITERATE_VM_PAGE_BEGIN(vm_page_family_curr, vm_page) {
+        cumulative_vm_pages_claimed_from_kernel++;
+        mm_print_vm_page_details(vm_page);
+      }
+      ITERATE_VM_PAGE_END(vm_page_family_curr, vm_page);
 
-    // Print details of each virtual memory page family
-    printf(ANSI_COLOR_GREEN
-           "vm_page_family : %s, struct size = %u\n" ANSI_COLOR_RESET,
-           vm_page_family_curr->struct_name, vm_page_family_curr->struct_size);
+      // Slab pages are kept apart from the pages carved into blocks
+      for (vm_page = vm_page_family_curr->slab_partial_pages; vm_page;
+           vm_page = vm_page->next) {
+        cumulative_vm_pages_claimed_from_kernel++;
+        mm_print_vm_page_details(vm_page);
+      }
+      for (vm_page = vm_page_family_curr->slab_full_pages; vm_page;
+           vm_page = vm_page->next) {
+        cumulative_vm_pages_claimed_from_kernel++;
+        mm_print_vm_page_details(vm_page);
+      }
 
-    // Iterate over each virtual memory page within the family
-    ITERATE_VM_PAGE_BEGIN(vm_page_family_curr, vm_page) {
-      cumulative_vm_pages_claimed_from_kernel++;
-      mm_print_vm_page_details(vm_page);
+      // Large object spans count for every system page they map
+      for (vm_page = vm_page_family_curr->first_large_page; vm_page;
+           vm_page = vm_page->next) {
+        cumulative_vm_pages_claimed_from_kernel += vm_page->units;
+        mm_print_vm_page_details(vm_page);
+      }
+      printf("\n");
     }
-    ITERATE_VM_PAGE_END(vm_page_family_curr, vm_page);
-    printf("\n");
+    ITERATE_PAGE_FAMILIES_END(families_page, vm_page_family_curr);
   }
-  ITERATE_PAGE_FAMILIES_END(first_vm_page_for_families, vm_page_family_curr);
 
   // Print total number of VM pages in use and their total memory usage
   printf(ANSI_COLOR_MAGENTA
-         "# Of VM Pages in Use : %u (%lu Bytes)\n" ANSI_COLOR_RESET,
+         "# Of VM Pages in Use : %u (%zu Bytes)\n" ANSI_COLOR_RESET,
          cumulative_vm_pages_claimed_from_kernel,
          SYSTEM_PAGE_SIZE * cumulative_vm_pages_claimed_from_kernel);
 
+  // Pages held by arenas are not attached to any page family
+  uint32_t arena_pages =
+      __atomic_load_n(&mm_arena_pages_in_use, __ATOMIC_RELAXED);
+  cumulative_vm_pages_claimed_from_kernel += arena_pages;
+  printf("Arena pages : %u\n", arena_pages);
+
+  // Retained empty pages are still mapped
+  mm_page_pool_stats_t pool_stats;
+  mm_get_page_pool_stats(&pool_stats);
+  cumulative_vm_pages_claimed_from_kernel += pool_stats.retained;
+  printf("Page pool : %u retained, %" PRIu64 " hits, %" PRIu64
+         " misses, %" PRIu64 " released\n",
+         pool_stats.retained, pool_stats.hits, pool_stats.misses,
+         pool_stats.released);
+
   // Print total memory being used by the Memory Manager
-  printf("Total Memory being used by Memory Manager = %lu Bytes\n",
+  printf("Total Memory being used by Memory Manager = %zu Bytes\n",
          cumulative_vm_pages_claimed_from_kernel * SYSTEM_PAGE_SIZE);
+
+  // Print how much clearing was avoided by lazy zeroing and xmalloc()
+  printf("Zeroing skipped on allocation = %" PRIu64 " Bytes\n",
+         __atomic_load_n(&mm_zeroing_bytes_saved, __ATOMIC_RELAXED));
+
+  // Print how many resizes kept their object in place
+  mm_realloc_stats_t realloc_stats;
+  mm_get_realloc_stats(&realloc_stats);
+  printf("Reallocations : %" PRIu64 " in place, %" PRIu64 " moved\n",
+         realloc_stats.in_place, realloc_stats.moved);
 }
@@ -0,0 +1,115 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_bulk_bench.c ****************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_bulk_bench.c
+ * @brief Burst allocation benchmark for the Memory Manager.
+ *
+ * This program allocates and frees bursts of single-unit objects, as a
+ * packet or request pipeline does, once with one `xcalloc_family()`/`xfree()`
+ * call per object and once with `xcalloc_bulk()`/`xfree_bulk()` per burst.
+ * Every burst size is run with the per-thread cache enabled and disabled.
+ *
+ * Usage: hmm_bulk_bench [objects_per_round]
+ */
+
+#include "memory_manager_api.h"
+#include "bench_common.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_MAX_BURST 256
+#define BENCH_DEFAULT_OBJECTS 4000000
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Object allocated in bursts by the benchmark.
+ */
+typedef struct bench_obj_ {
+  uint64_t payload[8]; /**< One cache line worth of data. */
+} bench_obj_t;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Runs one round of the benchmark.
+ *
+ * @param family Page family of the objects.
+ * @param burst Number of objects allocated, touched and freed together.
+ * @param objects Total number of objects to allocate in the round.
+ * @param bulk Non-zero to use the bulk calls.
+ * @return Average cost of an allocation plus its free, in nanoseconds.
+ */
+static double bench_run(mm_family_handle_t family, int burst,
+                        unsigned long objects, int bulk) {
+  void *burst_objects[BENCH_MAX_BURST];
+  unsigned long rounds = objects / burst;
+  unsigned long r;
+  int i;
+
+  double start = bench_now();
+  for (r = 0; r < rounds; r++) {
+    if (bulk) {
+      if (xcalloc_bulk(family, burst, burst_objects) != burst) {
+        printf("Error: Out of memory\n");
+        exit(1);
+      }
+    } else {
+      for (i = 0; i < burst; i++) {
+        burst_objects[i] = xcalloc_family(family, 1);
+      }
+    }
+    for (i = 0; i < burst; i++) {
+      ((bench_obj_t *)burst_objects[i])->payload[0] = r;
+    }
+    if (bulk) {
+      xfree_bulk(burst_objects, burst);
+    } else {
+      for (i = 0; i < burst; i++) {
+        xfree(burst_objects[i]);
+      }
+    }
+  }
+  double elapsed = bench_now() - start;
+
+  return elapsed * 1e9 / (rounds * burst);
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  unsigned long objects =
+      argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_OBJECTS;
+  int burst;
+  int cached;
+
+  mm_init();
+  mm_family_handle_t family = MM_REG_STRUCT(bench_obj_t);
+
+  printf("%-8s %-8s %14s %14s %10s\n", "tcache", "burst", "single ns/obj",
+         "bulk ns/obj", "speedup");
+
+  for (cached = 1; cached >= 0; cached--) {
+    mm_set_thread_cache(cached);
+    for (burst = 32; burst <= BENCH_MAX_BURST; burst *= 2) {
+      double single = bench_run(family, burst, objects, 0);
+      double bulk = bench_run(family, burst, objects, 1);
+      mm_thread_cache_flush();
+      printf("%-8s %-8d %14.1f %14.1f %9.2fx\n", cached ? "on" : "off",
+             burst, single, bulk, single / bulk);
+    }
+  }
+
+  return 0;
+}
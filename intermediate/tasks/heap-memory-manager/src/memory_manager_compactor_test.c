@@ -0,0 +1,151 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_compactor_test.c ************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_compactor_test.c
+ * @brief Test of the movable objects and of the compactor.
+ *
+ * This program allocates movable objects of various sizes, fills each of
+ * them with a pattern of its own, then frees nine objects out of ten, which
+ * leaves every page sparsely used. It then runs `mm_compact()` until no page
+ * is left to evacuate, and checks that:
+ *
+ * - pages were emptied and fewer system pages are mapped afterwards,
+ * - every remaining handle still leads to its object, with its data intact.
+ *
+ * Usage: hmm_compactor_test
+ */
+
+#include "memory_manager_api.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+//-----------------< Macros section -----------------/
+#define TEST_OBJECTS 4000
+#define TEST_KEPT_EVERY 10
+#define TEST_COMPACT_PAGES 4
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Movable object allocated by the test.
+ */
+typedef struct test_obj_ {
+  uint64_t id;  /**< Identifier derived from the index of the object. */
+  char pad[40]; /**< Filled with a pattern derived from the index. */
+} test_obj_t;
+
+//-----------------< Global variables section -----------------/
+static mm_handle_t test_handles[TEST_OBJECTS];
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Returns the number of structures of the object at an index.
+ */
+static int test_units(int i) { return 1 + (i % 3 == 0); }
+
+/**
+ * @brief Fills the object at an index with its pattern.
+ */
+static void test_fill(int i) {
+  test_obj_t *obj = mm_handle_pin(test_handles[i]);
+  int unit;
+
+  for (unit = 0; unit < test_units(i); unit++) {
+    obj[unit].id = (uint64_t)i * 7 + 1;
+    memset(obj[unit].pad, (char)(i + unit), sizeof(obj[unit].pad));
+  }
+  mm_handle_unpin(test_handles[i]);
+}
+
+/**
+ * @brief Checks that the object at an index still holds its pattern.
+ *
+ * @return 0 if the object is intact, 1 otherwise.
+ */
+static int test_check(int i) {
+  test_obj_t *obj = mm_handle_pin(test_handles[i]);
+  int failed = 0;
+  int unit;
+  size_t byte;
+
+  for (unit = 0; unit < test_units(i); unit++) {
+    failed |= obj[unit].id != (uint64_t)i * 7 + 1;
+    for (byte = 0; byte < sizeof(obj[unit].pad); byte++) {
+      failed |= obj[unit].pad[byte] != (char)(i + unit);
+    }
+  }
+  mm_handle_unpin(test_handles[i]);
+
+  if (failed) {
+    printf("Error: Movable object %d was corrupted\n", i);
+  }
+  return failed;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+  mm_stats_t before, after;
+  uint32_t emptied = 0;
+  uint32_t step;
+  int failures = 0;
+  int i;
+
+  mm_init();
+  mm_family_handle_t family = MM_REG_STRUCT_MOVABLE(test_obj_t);
+  if (!family) {
+    printf("Error: Could not register a movable page family\n");
+    return 1;
+  }
+
+  for (i = 0; i < TEST_OBJECTS; i++) {
+    test_handles[i] = xcalloc_movable(family, test_units(i));
+    if (!test_handles[i]) {
+      printf("Error: xcalloc_movable() failed\n");
+      return 1;
+    }
+    test_fill(i);
+  }
+  for (i = 0; i < TEST_OBJECTS; i++) {
+    if (i % TEST_KEPT_EVERY) {
+      xfree_movable(test_handles[i]);
+      test_handles[i] = NULL;
+    }
+  }
+
+  // Retained pages would hide the pages given back by the compactor
+  mm_trim();
+  mm_get_stats(&before);
+  while ((step = mm_compact(family, TEST_COMPACT_PAGES)) > 0) {
+    emptied += step;
+  }
+  mm_trim();
+  mm_get_stats(&after);
+
+  if (!emptied || after.compacted_pages != emptied) {
+    printf("Error: The compactor emptied %u pages\n", emptied);
+    failures++;
+  }
+  if (after.pages_mapped >= before.pages_mapped) {
+    printf("Error: %lu pages mapped before compaction, %lu after\n",
+           (unsigned long)before.pages_mapped,
+           (unsigned long)after.pages_mapped);
+    failures++;
+  }
+  for (i = 0; i < TEST_OBJECTS; i += TEST_KEPT_EVERY) {
+    failures += test_check(i);
+    xfree_movable(test_handles[i]);
+  }
+
+  printf("compactor: %s\n", failures ? "FAILED" : "passed");
+  return failures != 0;
+}
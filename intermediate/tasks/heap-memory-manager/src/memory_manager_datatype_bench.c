@@ -0,0 +1,124 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_datatype_bench.c ************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_datatype_bench.c
+ * @brief Data type size lookup benchmark for the Memory Manager.
+ *
+ * This program compares `get_size_of_datatype()`, a perfect hash lookup, with
+ * the linear `strcmp()` scan over the same names that it replaced. It prints
+ * the average cost of a lookup of:
+ *
+ * - hits: every name of `DATATYPE_SIZE_LIST`, in turn,
+ * - misses: structure names, which the scan compares with every entry.
+ *
+ * Usage: hmm_datatype_bench [lookups]
+ */
+
+#include "datatype_size_lookup.h"
+#include "bench_common.h"
+#include <stdlib.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_DEFAULT_LOOKUPS 20000000
+#define BENCH_NAME(name, type) name,
+#define BENCH_MAPPING(name, type) {name, sizeof(type)},
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Entry of the linear scan.
+ */
+typedef struct bench_mapping_ {
+  const char *name; /**< The name of the data type. */
+  size_t size;      /**< The size of the data type in bytes. */
+} bench_mapping_t;
+
+//-----------------< Global variables section -----------------/
+static const bench_mapping_t bench_mappings[] = {
+    DATATYPE_SIZE_LIST(BENCH_MAPPING)};
+
+static const char *const bench_hits[] = {DATATYPE_SIZE_LIST(BENCH_NAME)};
+
+static const char *const bench_misses[] = {
+    "student_t", "emp_t", "struct node", "long long double", "uint128_t",
+    "intx_t",    "list",  "vm_page_t",
+};
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief The previous lookup: compares the name with every entry in turn.
+ */
+static size_t bench_linear_lookup(const char *data_type) {
+  for (size_t i = 0; i < sizeof(bench_mappings) / sizeof(bench_mappings[0]);
+       ++i) {
+    if (strcmp(data_type, bench_mappings[i].name) == 0) {
+      return bench_mappings[i].size;
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Looks names up in turn and returns the average cost of a lookup.
+ *
+ * @param lookup The lookup function.
+ * @param names The names to look up.
+ * @param count Number of names.
+ * @param lookups Number of lookups.
+ * @param sum Receives the sum of the sizes found, so no lookup is elided.
+ */
+static double bench_run(size_t (*lookup)(const char *),
+                        const char *const *names, size_t count,
+                        unsigned long lookups, size_t *sum) {
+  unsigned long i;
+  size_t total = 0;
+  size_t next = 0;
+
+  double start = bench_now();
+  for (i = 0; i < lookups; i++) {
+    total += lookup(names[next]);
+    if (++next == count) {
+      next = 0;
+    }
+  }
+  double elapsed = bench_now() - start;
+
+  *sum += total;
+  return elapsed * 1e9 / lookups;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  unsigned long lookups =
+      argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_LOOKUPS;
+  size_t hits = sizeof(bench_hits) / sizeof(bench_hits[0]);
+  size_t misses = sizeof(bench_misses) / sizeof(bench_misses[0]);
+  size_t sum = 0;
+
+  if (!lookups) {
+    printf("Error: The number of lookups must be positive\n");
+    return 1;
+  }
+
+  printf("%zu data types\n", hits);
+  printf("%-14s %14s %14s\n", "lookup", "hit ns", "miss ns");
+  printf("%-14s %14.1f %14.1f\n", "linear",
+         bench_run(bench_linear_lookup, bench_hits, hits, lookups, &sum),
+         bench_run(bench_linear_lookup, bench_misses, misses, lookups, &sum));
+  printf("%-14s %14.1f %14.1f\n", "perfect hash",
+         bench_run(get_size_of_datatype, bench_hits, hits, lookups, &sum),
+         bench_run(get_size_of_datatype, bench_misses, misses, lookups, &sum));
+
+  return sum == 0;
+}
@@ -0,0 +1,156 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_debug_test.c ****************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_debug_test.c
+ * @brief Regression test of the debug mode canaries.
+ *
+ * Each case runs in a child process of its own, since the debug mode can
+ * only be enabled before the first allocation and a detected corruption
+ * aborts the program:
+ *
+ * - an intact object is freed without complaint,
+ * - a byte written past the end of an object is reported when it is freed,
+ * - `mm_set_debug_flags()` is refused once another thread allocated an
+ *   object, even one it freed into its thread cache and never published.
+ *
+ * Usage: hmm_debug_test
+ */
+
+#include "memory_manager_api.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Object allocated by the test cases.
+ */
+typedef struct test_obj_ {
+  char name[40]; /**< Some data. */
+  uint32_t id;   /**< More data. */
+} test_obj_t;
+
+//-----------------< Global variables section -----------------/
+static pthread_barrier_t test_barrier;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Allocates, fills and frees an object without overrunning it.
+ */
+static int test_intact(void) {
+  if (mm_set_debug_flags(MM_DEBUG_CANARY) != 0) {
+    return 1;
+  }
+  test_obj_t *obj = XCALLOC(1, test_obj_t);
+  memset(obj, 0x5A, sizeof(*obj));
+  XFREE(obj);
+  return 0;
+}
+
+/**
+ * @brief Writes one byte past the end of an object, then frees it.
+ */
+static int test_overrun(void) {
+  if (mm_set_debug_flags(MM_DEBUG_CANARY) != 0) {
+    return 1;
+  }
+  test_obj_t *obj = XCALLOC(1, test_obj_t);
+  ((volatile char *)obj)[sizeof(*obj)] = 0x5A;
+  XFREE(obj);
+  return 0;
+}
+
+/**
+ * @brief Allocates and frees an object, which stays in the thread's cache,
+ * then waits for the main thread.
+ */
+static void *test_cache_thread(void *arg) {
+  (void)arg;
+  test_obj_t *obj = XCALLOC(1, test_obj_t);
+  XFREE(obj);
+  pthread_barrier_wait(&test_barrier);
+  pthread_barrier_wait(&test_barrier);
+  return NULL;
+}
+
+/**
+ * @brief Enables the debug mode while another thread holds an object in its
+ * thread cache.
+ */
+static int test_other_thread(void) {
+  pthread_t thread;
+  int ret;
+
+  mm_set_thread_cache(1);
+  pthread_barrier_init(&test_barrier, NULL, 2);
+  pthread_create(&thread, NULL, test_cache_thread, NULL);
+  pthread_barrier_wait(&test_barrier);
+  ret = mm_set_debug_flags(MM_DEBUG_CANARY);
+  pthread_barrier_wait(&test_barrier);
+  pthread_join(thread, NULL);
+
+  return ret == -1 ? 0 : 1;
+}
+
+/**
+ * @brief Runs a case in a child process.
+ *
+ * @param name Name of the case.
+ * @param fn The case, returning the exit status of the child.
+ * @param expected_signal Signal the child must die of, 0 if it must exit
+ * with status 0.
+ * @return 0 if the child ended as expected, 1 otherwise.
+ */
+static int test_run(const char *name, int (*fn)(void), int expected_signal) {
+  int status;
+
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    printf("Error: fork() failed\n");
+    return 1;
+  }
+  if (pid == 0) {
+    // The report of an expected corruption is not a failure of the test
+    if (expected_signal) {
+      int fd = open("/dev/null", O_WRONLY);
+      dup2(fd, STDOUT_FILENO);
+    }
+    mm_init();
+    MM_REG_STRUCT(test_obj_t);
+    _exit(fn());
+  }
+  waitpid(pid, &status, 0);
+
+  int passed = expected_signal ? WIFSIGNALED(status) &&
+                                     WTERMSIG(status) == expected_signal
+                               : WIFEXITED(status) && !WEXITSTATUS(status);
+  printf("%-28s %s\n", name, passed ? "passed" : "FAILED");
+  return !passed;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @return 0 if every case passed, 1 otherwise.
+ */
+int main(void) {
+  int failures = 0;
+
+  failures += test_run("debug canary intact", test_intact, 0);
+  failures += test_run("debug canary overrun", test_overrun, SIGABRT);
+  failures += test_run("debug flags after allocation", test_other_thread, 0);
+
+  return failures != 0;
+}
@@ -0,0 +1,126 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_free_bench.c ****************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_free_bench.c
+ * @brief Free latency benchmark of a fragmented heap for the Memory Manager.
+ *
+ * This program fills pages with objects of mixed sizes, then frees them in
+ * random order in two passes, with the thread cache disabled so that every
+ * `xfree()` reaches the block lists:
+ *
+ * - scattered: every other object, so each freed block sits between
+ *   allocated neighbours and nothing is merged,
+ * - coalescing: the remaining objects, each merged with one or two free
+ *   neighbours.
+ *
+ * The random order spreads the frees over the whole heap, so the cost of
+ * reaching a block's neighbours and owning page dominates. Emptied pages are
+ * retained and reused by the next round.
+ *
+ * Usage: hmm_free_bench [objects] [rounds]
+ */
+
+#include "memory_manager_api.h"
+#include "bench_common.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_DEFAULT_OBJECTS 400000
+#define BENCH_DEFAULT_ROUNDS 5
+#define BENCH_UNIT_SIZE 8
+#define BENCH_SEED 42
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Shuffles `count` objects in place.
+ */
+static void bench_shuffle(void **objects, unsigned long count, uint64_t *rng) {
+  unsigned long i;
+
+  for (i = count; i > 1; i--) {
+    unsigned long j = bench_rand(rng) % i;
+    void *tmp = objects[i - 1];
+    objects[i - 1] = objects[j];
+    objects[j] = tmp;
+  }
+}
+
+/**
+ * @brief Frees `count` objects and returns the average cost of a free.
+ */
+static double bench_free_all(void **objects, unsigned long count) {
+  unsigned long i;
+
+  double start = bench_now();
+  for (i = 0; i < count; i++) {
+    xfree(objects[i]);
+  }
+  return (bench_now() - start) * 1e9 / count;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  unsigned long objects =
+      argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_OBJECTS;
+  int rounds = argc > 2 ? atoi(argv[2]) : BENCH_DEFAULT_ROUNDS;
+  void **all = malloc(objects * sizeof(void *));
+  void **scattered = malloc(objects / 2 * sizeof(void *));
+  void **remaining = malloc((objects + 1) / 2 * sizeof(void *));
+  uint64_t rng = BENCH_SEED;
+  unsigned long i;
+  int round;
+
+  if (!all || !scattered || !remaining) {
+    printf("Error: Out of memory\n");
+    return 1;
+  }
+
+  mm_init();
+  mm_set_thread_cache(0);
+  // Emptied pages stay with the family, so no free pays for an munmap()
+  mm_set_page_pool_limits(UINT32_MAX, 0);
+  mm_family_handle_t family =
+      mm_instantiate_new_page_family("bench_unit", BENCH_UNIT_SIZE);
+
+  printf("%-6s %18s %18s\n", "round", "scattered ns/free",
+         "coalescing ns/free");
+  for (round = 1; round <= rounds; round++) {
+    // Objects of 16 to 512 bytes, laid out back to back in their pages
+    for (i = 0; i < objects; i++) {
+      all[i] = xmalloc_family(family, 2 + bench_rand(&rng) % 63);
+      if (!all[i]) {
+        printf("Error: Out of memory\n");
+        return 1;
+      }
+      if (i % 2) {
+        scattered[i / 2] = all[i];
+      } else {
+        remaining[i / 2] = all[i];
+      }
+    }
+    bench_shuffle(scattered, objects / 2, &rng);
+    bench_shuffle(remaining, (objects + 1) / 2, &rng);
+
+    double scattered_ns = bench_free_all(scattered, objects / 2);
+    double coalescing_ns = bench_free_all(remaining, (objects + 1) / 2);
+    printf("%-6d %18.1f %18.1f\n", round, scattered_ns, coalescing_ns);
+  }
+
+  free(all);
+  free(scattered);
+  free(remaining);
+  return 0;
+}
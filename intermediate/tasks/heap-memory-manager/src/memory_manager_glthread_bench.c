@@ -0,0 +1,188 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_glthread_bench.c ************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_glthread_bench.c
+ * @brief Priority queue benchmark of the glthread library.
+ *
+ * This program runs the same priority queue workload on a sorted glthread
+ * list (`glthread_priority_insert()`) and on a glthread pairing heap, for
+ * 100, 1000, ... nodes, and prints the average cost of:
+ *
+ * - insert: inserting every node with a random priority,
+ * - churn:  removing the node of the highest priority and inserting it
+ *   again with a new random priority,
+ * - count:  reading the number of nodes.
+ *
+ * Both structures must hand out the same priorities in the same order,
+ * which the program checks.
+ *
+ * Usage: hmm_glthread_bench [max_nodes]
+ */
+
+#include "glthread.h"
+#include "bench_common.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_DEFAULT_MAX_NODES 10000
+#define BENCH_MIN_NODES 100
+#define BENCH_CHURN_ROUNDS 4
+#define BENCH_SEED 42
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief A queued element, linked into both structures.
+ */
+typedef struct bench_item_ {
+  uint32_t priority;              /**< Priority of the element. */
+  glthread_t list_glue;           /**< Links of the sorted list. */
+  glthread_heap_node_t heap_glue; /**< Links of the pairing heap. */
+} bench_item_t;
+
+/**
+ * @brief Average costs of a run, in nanoseconds.
+ */
+typedef struct bench_result_ {
+  double insert_ns; /**< Cost of an insert. */
+  double churn_ns;  /**< Cost of a removal plus an insert. */
+  double count_ns;  /**< Cost of reading the number of nodes. */
+  uint64_t check;   /**< Checksum of the priorities removed, in order. */
+} bench_result_t;
+
+GLTHREAD_TO_STRUCT(bench_list_to_item, bench_item_t, list_glue, glthreadptr);
+GLTHREAD_HEAP_TO_STRUCT(bench_heap_to_item, bench_item_t, heap_glue, nodeptr);
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Orders items by decreasing priority.
+ */
+static int bench_compare(void *first, void *second) {
+  uint32_t a = ((bench_item_t *)first)->priority;
+  uint32_t b = ((bench_item_t *)second)->priority;
+
+  return a > b ? -1 : (a < b ? 1 : 0);
+}
+
+/**
+ * @brief Runs the workload on a sorted glthread list.
+ */
+static void bench_list(bench_item_t *items, unsigned long nodes,
+                       bench_result_t *result) {
+  glthread_t base;
+  uint64_t rng = BENCH_SEED;
+  unsigned long i;
+  unsigned long total = 0;
+
+  init_glthread(&base);
+  double start = bench_now();
+  for (i = 0; i < nodes; i++) {
+    items[i].priority = (uint32_t)bench_rand(&rng);
+    glthread_priority_insert(&base, &items[i].list_glue, bench_compare,
+                             offsetof(bench_item_t, list_glue));
+  }
+  result->insert_ns = (bench_now() - start) * 1e9 / nodes;
+
+  result->check = 0;
+  start = bench_now();
+  for (i = 0; i < nodes * BENCH_CHURN_ROUNDS; i++) {
+    bench_item_t *item = bench_list_to_item(BASE(&base));
+    remove_glthread(&item->list_glue);
+    result->check = result->check * 31 + item->priority;
+    item->priority = (uint32_t)bench_rand(&rng);
+    glthread_priority_insert(&base, &item->list_glue, bench_compare,
+                             offsetof(bench_item_t, list_glue));
+  }
+  result->churn_ns = (bench_now() - start) * 1e9 / (nodes * BENCH_CHURN_ROUNDS);
+
+  start = bench_now();
+  for (i = 0; i < nodes; i++) {
+    total += get_glthread_list_count(&base);
+  }
+  result->count_ns = (bench_now() - start) * 1e9 / nodes;
+  result->check += total != nodes * nodes;
+}
+
+/**
+ * @brief Runs the workload on a glthread pairing heap.
+ */
+static void bench_heap(bench_item_t *items, unsigned long nodes,
+                       bench_result_t *result) {
+  glthread_heap_t heap;
+  uint64_t rng = BENCH_SEED;
+  unsigned long i;
+  unsigned long total = 0;
+
+  init_glthread_heap(&heap, bench_compare, offsetof(bench_item_t, heap_glue));
+  double start = bench_now();
+  for (i = 0; i < nodes; i++) {
+    items[i].priority = (uint32_t)bench_rand(&rng);
+    glthread_heap_insert(&heap, &items[i].heap_glue);
+  }
+  result->insert_ns = (bench_now() - start) * 1e9 / nodes;
+
+  result->check = 0;
+  start = bench_now();
+  for (i = 0; i < nodes * BENCH_CHURN_ROUNDS; i++) {
+    bench_item_t *item = bench_heap_to_item(glthread_heap_pop(&heap));
+    result->check = result->check * 31 + item->priority;
+    item->priority = (uint32_t)bench_rand(&rng);
+    glthread_heap_insert(&heap, &item->heap_glue);
+  }
+  result->churn_ns = (bench_now() - start) * 1e9 / (nodes * BENCH_CHURN_ROUNDS);
+
+  start = bench_now();
+  for (i = 0; i < nodes; i++) {
+    total += GLTHREAD_HEAP_COUNT(&heap);
+    // Keeps the compiler from hoisting the read out of the loop
+    __asm__ volatile("" : : "r"(&heap) : "memory");
+  }
+  result->count_ns = (bench_now() - start) * 1e9 / nodes;
+  result->check += total != nodes * nodes;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  unsigned long max_nodes =
+      argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_MAX_NODES;
+  bench_item_t *items = calloc(max_nodes ? max_nodes : 1, sizeof(*items));
+  bench_result_t list, heap;
+  unsigned long nodes;
+
+  if (!items) {
+    printf("Error: Out of memory\n");
+    return 1;
+  }
+
+  printf("%-8s %-6s %12s %12s %12s\n", "nodes", "queue", "insert ns",
+         "churn ns", "count ns");
+  for (nodes = BENCH_MIN_NODES; nodes <= max_nodes; nodes *= 10) {
+    bench_list(items, nodes, &list);
+    bench_heap(items, nodes, &heap);
+    if (list.check != heap.check) {
+      printf("Error: The list and the heap disagree for %lu nodes\n", nodes);
+      return 1;
+    }
+    printf("%-8lu %-6s %12.1f %12.1f %12.1f\n", nodes, "list", list.insert_ns,
+           list.churn_ns, list.count_ns);
+    printf("%-8lu %-6s %12.1f %12.1f %12.1f\n", nodes, "heap", heap.insert_ns,
+           heap.churn_ns, heap.count_ns);
+  }
+
+  free(items);
+  return 0;
+}
@@ -0,0 +1,146 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_mt_bench.c  *****************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_mt_bench.c
+ * @brief Multi-threaded benchmark for the Memory Manager.
+ *
+ * This program measures the throughput of `xcalloc()`/`xfree()` when several
+ * threads allocate and free single-unit objects of the same page family at
+ * the same time. Every thread count is run twice: once with the per-thread
+ * cache enabled and once with it disabled, where each call takes the family
+ * lock.
+ *
+ * Usage: hmm_mt_bench [max_threads] [ops_per_thread]
+ */
+
+#include "memory_manager_api.h"
+#include "bench_common.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_WORKING_SET 256 /**< Live objects kept by each thread. */
+#define BENCH_DEFAULT_MAX_THREADS 8
+#define BENCH_DEFAULT_OPS 2000000
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Object allocated by the benchmark threads.
+ */
+typedef struct bench_obj_ {
+  uint64_t payload[8]; /**< One cache line worth of data. */
+} bench_obj_t;
+
+/**
+ * @brief Arguments of a benchmark thread.
+ */
+typedef struct bench_thread_arg_ {
+  unsigned long ops; /**< Number of alloc/free operations to perform. */
+  unsigned seed;     /**< Seed of the slot selection sequence. */
+} bench_thread_arg_t;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Body of a benchmark thread.
+ *
+ * Each operation picks a pseudo-random slot of a private working set and
+ * either frees the object held there or allocates a new one into it.
+ *
+ * @param arg Pointer to a `bench_thread_arg_t`.
+ * @return Always NULL.
+ */
+static void *bench_thread(void *arg) {
+  bench_thread_arg_t *targ = (bench_thread_arg_t *)arg;
+  bench_obj_t *slots[BENCH_WORKING_SET] = {0};
+  unsigned seed = targ->seed;
+  unsigned long i;
+
+  for (i = 0; i < targ->ops; i++) {
+    seed = seed * 1103515245u + 12345u;
+    unsigned slot = (seed >> 16) % BENCH_WORKING_SET;
+    if (slots[slot]) {
+      XFREE(slots[slot]);
+      slots[slot] = NULL;
+    } else {
+      slots[slot] = XCALLOC(1, bench_obj_t);
+      slots[slot]->payload[0] = i;
+    }
+  }
+
+  for (i = 0; i < BENCH_WORKING_SET; i++) {
+    if (slots[i]) {
+      XFREE(slots[i]);
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Runs one round of the benchmark.
+ *
+ * @param threads Number of concurrent threads.
+ * @param ops Number of operations per thread.
+ * @return Aggregate throughput in operations per second.
+ */
+static double bench_run(int threads, unsigned long ops) {
+  pthread_t tids[threads];
+  bench_thread_arg_t args[threads];
+  int i;
+
+  double start = bench_now();
+  for (i = 0; i < threads; i++) {
+    args[i].ops = ops;
+    args[i].seed = (unsigned)i * 7919u + 1u;
+    pthread_create(&tids[i], NULL, bench_thread, &args[i]);
+  }
+  for (i = 0; i < threads; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  double elapsed = bench_now() - start;
+
+  return (double)threads * ops / elapsed;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  int max_threads = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_MAX_THREADS;
+  unsigned long ops =
+      argc > 2 ? strtoul(argv[2], NULL, 10) : BENCH_DEFAULT_OPS;
+  int threads;
+
+  mm_init();
+  MM_REG_STRUCT(bench_obj_t);
+
+  printf("%-8s %16s %16s %10s %10s\n", "threads", "cached ops/s",
+         "locked ops/s", "speedup", "scaling");
+
+  double cached_base = 0;
+  for (threads = 1; threads <= max_threads; threads *= 2) {
+    mm_set_thread_cache(1);
+    double cached = bench_run(threads, ops);
+    mm_set_thread_cache(0);
+    double locked = bench_run(threads, ops);
+
+    if (threads == 1) {
+      cached_base = cached;
+    }
+    printf("%-8d %16.0f %16.0f %9.2fx %9.2fx\n", threads, cached, locked,
+           cached / locked, cached / cached_base);
+  }
+
+  return 0;
+}
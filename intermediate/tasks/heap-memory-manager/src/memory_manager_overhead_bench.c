@@ -0,0 +1,136 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_overhead_bench.c ************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_overhead_bench.c
+ * @brief Memory overhead benchmark for the Memory Manager.
+ *
+ * This program allocates a fixed number of live objects for several object
+ * sizes and reports how many bytes of virtual memory pages they occupy
+ * compared to the bytes requested by the application. Pages are counted by
+ * collecting the distinct system pages the objects start in, so only the
+ * public API is needed.
+ *
+ * Usage: hmm_overhead_bench [objects_per_size]
+ */
+
+#include "memory_manager_api.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_DEFAULT_OBJECTS 100000
+
+/**
+ * @brief Declares a structure of the given size and its registration name.
+ */
+#define BENCH_DECLARE_OBJ(size)                                                \
+  typedef struct bench_obj_##size##_ {                                         \
+    char payload[size];                                                        \
+  } bench_obj_##size##_t
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+BENCH_DECLARE_OBJ(8);
+BENCH_DECLARE_OBJ(16);
+BENCH_DECLARE_OBJ(24);
+BENCH_DECLARE_OBJ(40);
+BENCH_DECLARE_OBJ(64);
+BENCH_DECLARE_OBJ(200);
+
+/**
+ * @brief Employee structure, as used by the test driver.
+ */
+typedef struct emp_ {
+  char name[32];   /**< Name of the employee. */
+  uint32_t emp_id; /**< ID of the employee. */
+} emp_t;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Compares two addresses, for qsort().
+ */
+static int bench_cmp_addr(const void *a, const void *b) {
+  uintptr_t x = *(const uintptr_t *)a;
+  uintptr_t y = *(const uintptr_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Allocates `count` objects of one page family and prints the memory
+ * they occupy.
+ *
+ * @param name Name of the page family, as registered.
+ * @param size Size of one object in bytes.
+ * @param count Number of live objects.
+ */
+static void bench_size(char *name, uint32_t size, unsigned long count) {
+  void **objects = malloc(count * sizeof(void *));
+  uintptr_t *pages = malloc(count * sizeof(uintptr_t));
+  uintptr_t page_mask = ~((uintptr_t)getpagesize() - 1);
+  unsigned long i, page_count = 0;
+
+  for (i = 0; i < count; i++) {
+    objects[i] = xcalloc(name, 1);
+    pages[i] = (uintptr_t)objects[i] & page_mask;
+  }
+
+  // Count the distinct pages the objects live in
+  qsort(pages, count, sizeof(uintptr_t), bench_cmp_addr);
+  for (i = 0; i < count; i++) {
+    if (i == 0 || pages[i] != pages[i - 1]) {
+      page_count++;
+    }
+  }
+
+  double requested = (double)count * size;
+  double used = (double)page_count * getpagesize();
+  printf("%-18s %6u %10lu %12.0f %12.0f %9.1f%%\n", name, size, page_count,
+         requested, used, 100.0 * (used - requested) / requested);
+
+  for (i = 0; i < count; i++) {
+    xfree(objects[i]);
+  }
+  free(objects);
+  free(pages);
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  unsigned long count =
+      argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_OBJECTS;
+
+  mm_init();
+  MM_REG_STRUCT(bench_obj_8_t);
+  MM_REG_STRUCT(bench_obj_16_t);
+  MM_REG_STRUCT(bench_obj_24_t);
+  MM_REG_STRUCT(bench_obj_40_t);
+  MM_REG_STRUCT(bench_obj_64_t);
+  MM_REG_STRUCT(bench_obj_200_t);
+  MM_REG_STRUCT(emp_t);
+
+  printf("%-18s %6s %10s %12s %12s %10s\n", "family", "size", "pages",
+         "requested", "used", "overhead");
+  bench_size("bench_obj_8_t", sizeof(bench_obj_8_t), count);
+  bench_size("bench_obj_16_t", sizeof(bench_obj_16_t), count);
+  bench_size("bench_obj_24_t", sizeof(bench_obj_24_t), count);
+  bench_size("bench_obj_40_t", sizeof(bench_obj_40_t), count);
+  bench_size("emp_t", sizeof(emp_t), count);
+  bench_size("bench_obj_64_t", sizeof(bench_obj_64_t), count);
+  bench_size("bench_obj_200_t", sizeof(bench_obj_200_t), count);
+
+  return 0;
+}
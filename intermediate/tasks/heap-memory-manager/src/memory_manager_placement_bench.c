@@ -0,0 +1,194 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_placement_bench.c ***********/
+/****************************************************************/
+
+/**
+ * @file memory_manager_placement_bench.c
+ * @brief Placement policy benchmark for the Memory Manager.
+ *
+ * This program replays mixed-size allocation patterns against a page family
+ * under each placement policy of `mm_set_placement_policy()`, and prints per
+ * scenario and policy:
+ *
+ * - the throughput in operations (allocations plus frees) per second,
+ * - the pages mapped for the family at the end of the pattern,
+ * - the overhead, i.e. those pages' bytes divided by the live bytes,
+ * - the fragmentation of `mm_get_stats()`, the share of the free bytes
+ *   outside the largest free block.
+ *
+ * The thread cache is disabled and empty pages are not retained, so that
+ * every request goes through the placement policy and every run starts from
+ * an empty heap. All policies replay the same requests for a scenario.
+ *
+ * Scenarios:
+ * - uniform:  random alloc/free over a working set, sizes 16 to 1024 bytes.
+ * - bimodal:  mostly 16 to 64 byte objects, some of 1 to 2 KB.
+ * - lifetime: most objects are replaced soon, a few live long.
+ *
+ * Usage: hmm_placement_bench [ops]
+ */
+
+#include "memory_manager_api.h"
+#include "bench_common.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_DEFAULT_OPS 200000
+#define BENCH_WORKING_SET 4000
+#define BENCH_SHORT_LIVED_SLOTS 64
+#define BENCH_UNIT_SIZE 8
+#define BENCH_SEED 42
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief An allocation pattern: name, request sizes and slot choice.
+ */
+typedef struct bench_scenario_ {
+  const char *name;             /**< Name printed in the report. */
+  uint32_t (*size)(uint64_t *); /**< Draws the size of a request. */
+  uint32_t (*slot)(uint64_t *); /**< Draws the slot replaced next. */
+} bench_scenario_t;
+
+/**
+ * @brief Measurements of one run.
+ */
+typedef struct bench_result_ {
+  double ops_per_sec; /**< Throughput. */
+  uint64_t pages;     /**< Pages mapped at the end of the pattern. */
+  double overhead;    /**< Mapped bytes per live byte. */
+  double frag;        /**< Free bytes outside the largest free block. */
+} bench_result_t;
+
+//-----------------< Functions implementation section -----------------/
+static uint32_t bench_uniform_size(uint64_t *rng) {
+  return 16 + bench_rand(rng) % (1024 - 16 + 1);
+}
+
+static uint32_t bench_bimodal_size(uint64_t *rng) {
+  if (bench_rand(rng) % 5) {
+    return 16 + bench_rand(rng) % (64 - 16 + 1);
+  }
+  return 1024 + bench_rand(rng) % (2048 - 1024 + 1);
+}
+
+static uint32_t bench_any_slot(uint64_t *rng) {
+  return bench_rand(rng) % BENCH_WORKING_SET;
+}
+
+/**
+ * @brief Picks a short-lived slot nine times out of ten.
+ */
+static uint32_t bench_lifetime_slot(uint64_t *rng) {
+  if (bench_rand(rng) % 10) {
+    return bench_rand(rng) % BENCH_SHORT_LIVED_SLOTS;
+  }
+  return bench_rand(rng) % BENCH_WORKING_SET;
+}
+
+/**
+ * @brief Replays a scenario on a new page family under a policy.
+ *
+ * @param scenario The allocation pattern.
+ * @param policy Placement policy of the family.
+ * @param ops Number of objects to allocate.
+ * @param result Receives the measurements.
+ */
+static void bench_run(const bench_scenario_t *scenario,
+                      mm_placement_policy_t policy, unsigned long ops,
+                      bench_result_t *result) {
+  static void *objects[BENCH_WORKING_SET];
+  static uint32_t sizes[BENCH_WORKING_SET];
+  char name[64];
+  uint64_t rng = BENCH_SEED;
+  uint64_t live_bytes = 0;
+  unsigned long done = 0;
+  unsigned long i;
+  mm_stats_t before, after;
+
+  snprintf(name, sizeof(name), "bench_%s_%d", scenario->name, (int)policy);
+  mm_family_handle_t family =
+      mm_instantiate_new_page_family(name, BENCH_UNIT_SIZE);
+  mm_set_placement_policy(family, policy);
+  mm_get_stats(&before);
+
+  double start = bench_now();
+  for (i = 0; i < ops; i++) {
+    uint32_t slot = scenario->slot(&rng);
+    uint32_t size = scenario->size(&rng);
+
+    if (objects[slot]) {
+      xfree(objects[slot]);
+      live_bytes -= sizes[slot];
+      done++;
+    }
+    objects[slot] = xmalloc_family(
+        family, (size + BENCH_UNIT_SIZE - 1) / BENCH_UNIT_SIZE);
+    if (!objects[slot]) {
+      printf("Error: Out of memory\n");
+      exit(1);
+    }
+    sizes[slot] = size;
+    live_bytes += size;
+    done++;
+  }
+  double elapsed = bench_now() - start;
+
+  mm_get_stats(&after);
+  result->ops_per_sec = done / elapsed;
+  result->pages = after.pages_mapped - before.pages_mapped;
+  result->overhead =
+      (double)result->pages * getpagesize() / (live_bytes ? live_bytes : 1);
+  result->frag = after.fragmentation;
+
+  for (i = 0; i < BENCH_WORKING_SET; i++) {
+    if (objects[i]) {
+      xfree(objects[i]);
+      objects[i] = NULL;
+    }
+  }
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  static const bench_scenario_t scenarios[] = {
+      {"uniform", bench_uniform_size, bench_any_slot},
+      {"bimodal", bench_bimodal_size, bench_any_slot},
+      {"lifetime", bench_uniform_size, bench_lifetime_slot},
+  };
+  static const char *policies[] = {"segregated", "best", "first", "next",
+                                   "worst"};
+  unsigned long ops = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_OPS;
+  bench_result_t result;
+  size_t s;
+  int p;
+
+  mm_init();
+  mm_set_thread_cache(0);
+  mm_set_page_pool_limits(0, 0);
+
+  printf("%-10s %-12s %12s %8s %10s %8s\n", "scenario", "policy", "ops/s",
+         "pages", "overhead", "frag");
+  for (s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+    for (p = MM_PLACEMENT_SEGREGATED; p <= MM_PLACEMENT_WORST_FIT; p++) {
+      bench_run(&scenarios[s], (mm_placement_policy_t)p, ops, &result);
+      printf("%-10s %-12s %12.0f %8lu %9.2fx %8.3f\n", scenarios[s].name,
+             policies[p], result.ops_per_sec, (unsigned long)result.pages,
+             result.overhead, result.frag);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,413 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_preload.c   *****************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_preload.c
+ * @brief Drop-in replacement of the C library allocator.
+ *
+ * This file implements `malloc()`, `calloc()`, `realloc()`, `free()`,
+ * `posix_memalign()`, `aligned_alloc()`, `memalign()`, `valloc()`,
+ * `pvalloc()` and `malloc_usable_size()` on top of the Memory Manager, so
+ * that unmodified programs can run on it:
+ *
+ *   make preload
+ *   LD_PRELOAD=./lib/libhmm_preload.so ./some_program
+ *
+ * Requests up to `HMM_PRELOAD_CLASS_MAX_SIZE` bytes are rounded up to a size
+ * class, each class being a page family of its own so that single-unit
+ * allocations take the thread cache. Larger requests go to a page family of
+ * one byte structures and end up in variable-sized blocks or, above a page,
+ * in large object spans, which the large span pool keeps for reuse instead
+ * of mapping one per request.
+ *
+ * The Memory Manager's fork handlers are registered with `pthread_atfork()`,
+ * so that programs forking from multi-threaded code keep working in the
+ * child.
+ *
+ * Every size is a multiple of `HMM_PRELOAD_ALIGNMENT`, which keeps every
+ * block aligned like the C library's. Stricter alignments are served by
+ * over-allocating and placing a `hmm_preload_tag_t` in front of the aligned
+ * pointer.
+ *
+ * This file is not part of the Memory Manager library, it is only linked
+ * into `libhmm_preload.so`.
+ */
+
+#include "memory_manager_api.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+//-----------------< Macros section -----------------/
+/**
+ * @brief Alignment of every pointer returned by `malloc()`.
+ */
+#define HMM_PRELOAD_ALIGNMENT 16
+
+/**
+ * @brief Largest request served from a size class page family.
+ */
+#define HMM_PRELOAD_CLASS_MAX_SIZE 1024
+
+/**
+ * @brief Largest request served at all, below the maximum block size.
+ */
+#define HMM_PRELOAD_MAX_SIZE 0x7FFFF000u
+
+/**
+ * @brief Size of the static buffer serving re-entrant allocations.
+ */
+#define HMM_PRELOAD_BOOTSTRAP_SIZE (64 * 1024)
+
+/**
+ * @brief Exports an allocator entry point.
+ *
+ * The library is built with hidden visibility so that the Memory Manager's
+ * own symbols, such as `xfree()`, neither interpose nor get interposed by
+ * same-named functions of the host program.
+ */
+#define HMM_PRELOAD_EXPORT __attribute__((visibility("default")))
+
+/**
+ * @brief Rounds `size` up to a multiple of `HMM_PRELOAD_ALIGNMENT`.
+ */
+#define HMM_PRELOAD_ROUND(size)                                                \
+  (((size) + HMM_PRELOAD_ALIGNMENT - 1) & ~(size_t)(HMM_PRELOAD_ALIGNMENT - 1))
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Marker placed right in front of an over-aligned pointer.
+ *
+ * It overlays the block metadata that precedes every other pointer. A
+ * block's first word holds its size, which is never zero, so a zero `marker`
+ * identifies a tag.
+ */
+typedef struct hmm_preload_tag_ {
+  uint32_t marker;   /**< Always zero. */
+  uint32_t offset;   /**< Distance back to the pointer of the block. */
+  uint64_t reserved; /**< Keeps the tag as large as a block header. */
+} hmm_preload_tag_t;
+
+//-----------------< Global variables section -----------------/
+/**
+ * @brief Sizes of the size classes, in increasing order.
+ */
+static const uint32_t hmm_preload_class_sizes[] = {
+    16,  32,  48,  64,  80,  96,  112, 128, 144, 160, 176, 192,
+    208, 224, 240, 256, 320, 384, 448, 512, 640, 768, 896, 1024};
+
+#define HMM_PRELOAD_CLASS_COUNT                                                \
+  (sizeof(hmm_preload_class_sizes) / sizeof(hmm_preload_class_sizes[0]))
+
+/**
+ * @brief Page family of each size class.
+ */
+static mm_family_handle_t hmm_preload_class_families[HMM_PRELOAD_CLASS_COUNT];
+
+/**
+ * @brief Size class of each `HMM_PRELOAD_ALIGNMENT` bytes of request.
+ */
+static uint8_t
+    hmm_preload_class_of[HMM_PRELOAD_CLASS_MAX_SIZE / HMM_PRELOAD_ALIGNMENT +
+                         1];
+
+/**
+ * @brief Page family of one byte structures, for larger requests.
+ */
+static mm_family_handle_t hmm_preload_byte_family;
+
+static pthread_once_t hmm_preload_once = PTHREAD_ONCE_INIT;
+static int hmm_preload_ready = 0;
+
+/**
+ * @brief Set while the calling thread is inside the Memory Manager.
+ *
+ * The Memory Manager reports errors with `printf()`, which may allocate;
+ * such nested requests are served from `hmm_preload_bootstrap` instead of
+ * re-entering a page family whose lock the thread may hold.
+ */
+static __thread int hmm_preload_busy;
+
+/**
+ * @brief Static buffer serving re-entrant allocations, never freed.
+ */
+static char hmm_preload_bootstrap[HMM_PRELOAD_BOOTSTRAP_SIZE]
+    __attribute__((aligned(HMM_PRELOAD_ALIGNMENT)));
+static size_t hmm_preload_bootstrap_used = 0;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Initializes the Memory Manager and registers the size classes.
+ */
+static void hmm_preload_setup(void) {
+  char name[32];
+  uint32_t class_index = 0, granule;
+
+  mm_init();
+  for (class_index = 0; class_index < HMM_PRELOAD_CLASS_COUNT;
+       class_index++) {
+    snprintf(name, sizeof(name), "hmm_malloc_%u",
+             hmm_preload_class_sizes[class_index]);
+    hmm_preload_class_families[class_index] = mm_instantiate_new_page_family(
+        name, hmm_preload_class_sizes[class_index]);
+  }
+
+  class_index = 0;
+  for (granule = 0; granule < sizeof(hmm_preload_class_of); granule++) {
+    while (hmm_preload_class_sizes[class_index] <
+           granule * HMM_PRELOAD_ALIGNMENT) {
+      class_index++;
+    }
+    hmm_preload_class_of[granule] = class_index;
+  }
+
+  hmm_preload_byte_family = mm_instantiate_new_page_family("hmm_malloc", 1);
+
+  // A child forked while another thread holds a page family lock would
+  // deadlock on its first allocation. The C library may allocate while
+  // registering the handlers, which must not wait for this very setup.
+  hmm_preload_busy = 1;
+  pthread_atfork(mm_fork_prepare, mm_fork_parent, mm_fork_child);
+  hmm_preload_busy = 0;
+  __atomic_store_n(&hmm_preload_ready, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Serves a request from the bootstrap buffer.
+ *
+ * The size of each chunk is stored in the `HMM_PRELOAD_ALIGNMENT` bytes in
+ * front of it.
+ */
+static void *hmm_preload_bootstrap_alloc(size_t size) {
+  size_t chunk = HMM_PRELOAD_ALIGNMENT + HMM_PRELOAD_ROUND(size);
+  size_t offset = __atomic_fetch_add(&hmm_preload_bootstrap_used, chunk,
+                                     __ATOMIC_RELAXED);
+
+  if (offset + chunk > HMM_PRELOAD_BOOTSTRAP_SIZE) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  *(size_t *)(hmm_preload_bootstrap + offset) = size;
+  return hmm_preload_bootstrap + offset + HMM_PRELOAD_ALIGNMENT;
+}
+
+static inline int hmm_preload_is_bootstrap(void *ptr) {
+  return (char *)ptr >= hmm_preload_bootstrap &&
+         (char *)ptr < hmm_preload_bootstrap + HMM_PRELOAD_BOOTSTRAP_SIZE;
+}
+
+/**
+ * @brief Allocates `size` bytes, aligned on `HMM_PRELOAD_ALIGNMENT`.
+ *
+ * @param size Size of the request in bytes.
+ * @param zero Whether the memory must be zeroed.
+ */
+MM_ALLOC_TEXT
+static void *hmm_preload_alloc(size_t size, int zero) {
+  void *ptr;
+
+  if (hmm_preload_busy) {
+    return hmm_preload_bootstrap_alloc(size);
+  }
+  if (!__atomic_load_n(&hmm_preload_ready, __ATOMIC_ACQUIRE)) {
+    pthread_once(&hmm_preload_once, hmm_preload_setup);
+  }
+  if (size > HMM_PRELOAD_MAX_SIZE) {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  hmm_preload_busy = 1;
+  if (size <= HMM_PRELOAD_CLASS_MAX_SIZE) {
+    mm_family_handle_t family = hmm_preload_class_families
+        [hmm_preload_class_of[(size + HMM_PRELOAD_ALIGNMENT - 1) /
+                              HMM_PRELOAD_ALIGNMENT]];
+    ptr = zero ? xcalloc_family(family, 1) : xmalloc_family(family, 1);
+  } else {
+    int units = (int)HMM_PRELOAD_ROUND(size);
+    ptr = zero ? xcalloc_family(hmm_preload_byte_family, units)
+               : xmalloc_family(hmm_preload_byte_family, units);
+  }
+  hmm_preload_busy = 0;
+
+  if (!ptr) {
+    errno = ENOMEM;
+  }
+  return ptr;
+}
+
+/**
+ * @brief Returns the tag in front of `ptr` if it was over-aligned, or NULL.
+ */
+static inline hmm_preload_tag_t *hmm_preload_get_tag(void *ptr) {
+  hmm_preload_tag_t *tag = (hmm_preload_tag_t *)ptr - 1;
+  return tag->marker == 0 ? tag : NULL;
+}
+
+/**
+ * @brief Allocates `size` bytes aligned on `alignment`, a power of two.
+ */
+MM_ALLOC_TEXT
+static void *hmm_preload_alloc_aligned(size_t alignment, size_t size) {
+  if (alignment <= HMM_PRELOAD_ALIGNMENT) {
+    return hmm_preload_alloc(size, 0);
+  }
+  if (size > HMM_PRELOAD_MAX_SIZE - alignment) {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  // Blocks are aligned on HMM_PRELOAD_ALIGNMENT, so the aligned pointer lies
+  // at most `alignment` bytes in and leaves room for the tag in front of it
+  char *block = hmm_preload_alloc(size + alignment, 0);
+  if (!block) {
+    return NULL;
+  }
+  char *ptr = (char *)(((uintptr_t)block + HMM_PRELOAD_ALIGNMENT +
+                        alignment - 1) &
+                       ~(uintptr_t)(alignment - 1));
+
+  // Bootstrap chunks keep their size in front of the pointer instead
+  if (hmm_preload_is_bootstrap(block)) {
+    *(size_t *)(ptr - HMM_PRELOAD_ALIGNMENT) = size;
+    return ptr;
+  }
+  hmm_preload_tag_t *tag = (hmm_preload_tag_t *)ptr - 1;
+  tag->marker = 0;
+  tag->offset = ptr - block;
+  tag->reserved = 0;
+  return ptr;
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *malloc(size_t size) {
+  return hmm_preload_alloc(size, 0);
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *calloc(size_t nmemb, size_t size) {
+  if (size && nmemb > SIZE_MAX / size) {
+    errno = ENOMEM;
+    return NULL;
+  }
+  return hmm_preload_alloc(nmemb * size, 1);
+}
+
+HMM_PRELOAD_EXPORT void free(void *ptr) {
+  hmm_preload_tag_t *tag;
+
+  if (!ptr || hmm_preload_is_bootstrap(ptr)) {
+    return;
+  }
+  tag = hmm_preload_get_tag(ptr);
+  if (tag) {
+    ptr = (char *)ptr - tag->offset;
+  }
+
+  hmm_preload_busy = 1;
+  xfree(ptr);
+  hmm_preload_busy = 0;
+}
+
+HMM_PRELOAD_EXPORT size_t malloc_usable_size(void *ptr) {
+  hmm_preload_tag_t *tag;
+
+  if (!ptr) {
+    return 0;
+  }
+  if (hmm_preload_is_bootstrap(ptr)) {
+    return *(size_t *)((char *)ptr - HMM_PRELOAD_ALIGNMENT);
+  }
+  tag = hmm_preload_get_tag(ptr);
+  if (tag) {
+    return mm_usable_size((char *)ptr - tag->offset) - tag->offset;
+  }
+  return mm_usable_size(ptr);
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *realloc(void *ptr, size_t size) {
+  if (!ptr) {
+    return malloc(size);
+  }
+  if (size == 0) {
+    free(ptr);
+    return NULL;
+  }
+
+  // Keep the block when the new size still fits and does not waste half of it
+  size_t usable = malloc_usable_size(ptr);
+  int is_plain = !hmm_preload_is_bootstrap(ptr) && !hmm_preload_get_tag(ptr);
+  if (size <= usable && size >= usable / 2 && is_plain) {
+    return ptr;
+  }
+
+  // Blocks of the byte family resize in place whenever they can; objects of
+  // a size class cannot leave their class
+  if (is_plain && usable > HMM_PRELOAD_CLASS_MAX_SIZE &&
+      size > HMM_PRELOAD_CLASS_MAX_SIZE && size <= HMM_PRELOAD_MAX_SIZE) {
+    hmm_preload_busy = 1;
+    void *new_ptr = xrealloc(ptr, (int)HMM_PRELOAD_ROUND(size));
+    hmm_preload_busy = 0;
+    if (!new_ptr) {
+      errno = ENOMEM;
+    }
+    return new_ptr;
+  }
+
+  void *new_ptr = malloc(size);
+  if (!new_ptr) {
+    return NULL;
+  }
+  memcpy(new_ptr, ptr, size < usable ? size : usable);
+  free(ptr);
+  return new_ptr;
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT int posix_memalign(void **memptr, size_t alignment,
+                                      size_t size) {
+  if (alignment % sizeof(void *) || (alignment & (alignment - 1))) {
+    return EINVAL;
+  }
+  void *ptr = hmm_preload_alloc_aligned(alignment, size);
+  if (!ptr) {
+    return ENOMEM;
+  }
+  *memptr = ptr;
+  return 0;
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *aligned_alloc(size_t alignment, size_t size) {
+  if (alignment == 0 || (alignment & (alignment - 1))) {
+    errno = EINVAL;
+    return NULL;
+  }
+  return hmm_preload_alloc_aligned(alignment, size);
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *memalign(size_t alignment, size_t size) {
+  return aligned_alloc(alignment, size);
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *valloc(size_t size) {
+  return hmm_preload_alloc_aligned(getpagesize(), size);
+}
+
+MM_ALLOC_TEXT
+HMM_PRELOAD_EXPORT void *pvalloc(size_t size) {
+  size_t page_size = getpagesize();
+  return hmm_preload_alloc_aligned(page_size,
+                                   (size + page_size - 1) & ~(page_size - 1));
+}
@@ -0,0 +1,173 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_registry_race_test.c ********/
+/****************************************************************/
+
+/**
+ * @file memory_manager_registry_race_test.c
+ * @brief Concurrent registration test of the page family registry.
+ *
+ * This program releases 8 threads at once on the page family registry. Each
+ * thread:
+ *
+ * - looks up or registers the same 40 shared families with
+ *   `mm_get_page_family()`, in a different order, and allocates from them,
+ *   from a typed family (`XCALLOC_T()`) and from names resolved by
+ *   `xcalloc()`,
+ * - registers plain and slab families of its own while other threads walk
+ *   the registry through `mm_get_stats()`.
+ *
+ * Every thread must end up with the same handle for each shared family. The
+ * test is built with `-fsanitize=thread` by `make check`, so ThreadSanitizer
+ * reports any unsynchronized access to the registry as well.
+ *
+ * Usage: hmm_registry_race_test
+ */
+
+#include "memory_manager_api.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+//-----------------< Macros section -----------------/
+#define TEST_THREADS 8
+#define TEST_SHARED_FAMILIES 40
+#define TEST_OWN_FAMILIES 5
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Structure of the typed family shared by all threads.
+ */
+typedef struct test_obj_ {
+  long payload[3]; /**< Some data. */
+} test_obj_t;
+
+//-----------------< Global variables section -----------------/
+static pthread_barrier_t test_barrier;
+
+/**
+ * @brief Handle of each shared family, as seen by each thread.
+ */
+static mm_family_handle_t test_handles[TEST_THREADS][TEST_SHARED_FAMILIES];
+
+/**
+ * @brief Number of failed checks, over all threads.
+ */
+static int test_failures = 0;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Records a failed check.
+ */
+static void test_fail(long thread_id, const char *what) {
+  printf("Error: Thread %ld: %s\n", thread_id, what);
+  __atomic_fetch_add(&test_failures, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Body of a test thread.
+ *
+ * @param arg Index of the thread.
+ */
+static void *test_thread(void *arg) {
+  long thread_id = (long)arg;
+  char name[32];
+  int i;
+
+  pthread_barrier_wait(&test_barrier);
+
+  for (i = 0; i < TEST_SHARED_FAMILIES; i++) {
+    int family = (i + thread_id) % TEST_SHARED_FAMILIES;
+    uint32_t size = 8 + family;
+
+    snprintf(name, sizeof(name), "shared_%d", family);
+    mm_family_handle_t handle = mm_get_page_family(name, size);
+    test_handles[thread_id][family] = handle;
+    if (!handle) {
+      test_fail(thread_id, "mm_get_page_family() failed");
+      continue;
+    }
+
+    char *data = xcalloc_family(handle, 2);
+    if (!data) {
+      test_fail(thread_id, "xcalloc_family() failed");
+    } else {
+      memset(data, 1, 2 * size);
+      xfree(data);
+    }
+
+    test_obj_t *obj = XCALLOC_T(1, test_obj_t);
+    unsigned int *values = xcalloc("sizeof(unsigned int)", 3);
+    int *bytes = xcalloc("7", 1);
+    if (!obj || !values || !bytes) {
+      test_fail(thread_id, "allocation by type failed");
+      continue;
+    }
+    XFREE(obj);
+    XFREE(values);
+    XFREE(bytes);
+  }
+
+  // Private families are registered while the other threads walk the registry
+  for (i = 0; i < TEST_OWN_FAMILIES; i++) {
+    mm_stats_t stats;
+
+    snprintf(name, sizeof(name), "own_%ld_%d", thread_id, i);
+    mm_family_handle_t handle = (i & 1)
+                                    ? mm_instantiate_new_slab_family(name, 24)
+                                    : mm_instantiate_new_page_family(name, 40);
+    void *data = handle ? xcalloc_family(handle, 1) : NULL;
+    if (!data) {
+      test_fail(thread_id, "allocation from an own family failed");
+    } else {
+      XFREE(data);
+    }
+    mm_get_stats(&stats);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+  pthread_t threads[TEST_THREADS];
+  long i;
+  int family;
+
+  mm_init();
+  pthread_barrier_init(&test_barrier, NULL, TEST_THREADS);
+  for (i = 0; i < TEST_THREADS; i++) {
+    pthread_create(&threads[i], NULL, test_thread, (void *)i);
+  }
+  for (i = 0; i < TEST_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_barrier_destroy(&test_barrier);
+
+  for (family = 0; family < TEST_SHARED_FAMILIES; family++) {
+    for (i = 1; i < TEST_THREADS; i++) {
+      if (test_handles[i][family] != test_handles[0][family]) {
+        printf("Error: Threads registered shared_%d twice\n", family);
+        test_failures++;
+        break;
+      }
+    }
+  }
+
+  // Unknown structures are rejected instead of getting an empty family
+  if (xcalloc("sizeof(struct unknown)", 1)) {
+    printf("Error: An unknown structure was allocated\n");
+    test_failures++;
+  }
+
+  printf("registry race: %s\n", test_failures ? "FAILED" : "passed");
+  return test_failures != 0;
+}
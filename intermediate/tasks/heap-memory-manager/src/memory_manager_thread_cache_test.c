@@ -0,0 +1,142 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_thread_cache_test.c *********/
+/****************************************************************/
+
+/**
+ * @file memory_manager_thread_cache_test.c
+ * @brief Thread exit and double free tests of the per-thread cache.
+ *
+ * A thread allocates objects through its cache, then registers a
+ * thread-specific data destructor of its own. That destructor runs after
+ * the cache's destructor has flushed the cache, and frees objects and
+ * allocates new ones. Once the thread is joined, no object may be left
+ * behind in the dead thread's cache: the families must hold no live bytes.
+ *
+ * A child process then frees an object twice. The second free must abort
+ * instead of putting the object in the cache a second time, from where two
+ * allocations would get it.
+ *
+ * Usage: hmm_thread_cache_test
+ */
+
+#include "memory_manager_api.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//-----------------< Macros section -----------------/
+#define TEST_OBJECTS 16
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Object allocated by the test thread.
+ */
+typedef struct test_obj_ {
+  uint64_t payload[4]; /**< Some data. */
+} test_obj_t;
+
+//-----------------< Global variables section -----------------/
+static pthread_key_t test_key;
+static test_obj_t *test_late_objects[TEST_OBJECTS];
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Destructor run after the thread cache's own.
+ */
+static void test_late_destructor(void *arg) {
+  int i;
+
+  (void)arg;
+  for (i = 0; i < TEST_OBJECTS; i++) {
+    XFREE(test_late_objects[i]);
+  }
+  // An allocation this late must not refill the cache either
+  XFREE(XCALLOC(1, test_obj_t));
+}
+
+/**
+ * @brief Body of the test thread.
+ */
+static void *test_thread(void *arg) {
+  test_obj_t *early = XCALLOC(1, test_obj_t);
+  int i;
+
+  (void)arg;
+  for (i = 0; i < TEST_OBJECTS; i++) {
+    test_late_objects[i] = XCALLOC(1, test_obj_t);
+  }
+  XFREE(early);
+
+  // Created after the cache's key, so its destructor runs afterwards
+  pthread_key_create(&test_key, test_late_destructor);
+  pthread_setspecific(test_key, &test_key);
+  return NULL;
+}
+
+/**
+ * @brief Frees an object twice in a child process.
+ *
+ * @return 0 if the child was aborted, 1 otherwise.
+ */
+static int test_double_free(void) {
+  int status;
+
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    printf("Error: fork() failed\n");
+    return 1;
+  }
+  if (pid == 0) {
+    // The failed assertion is expected, keep its report out of the output
+    int fd = open("/dev/null", O_WRONLY);
+    dup2(fd, STDERR_FILENO);
+    test_obj_t *obj = XCALLOC(1, test_obj_t);
+    XFREE(obj);
+    XFREE(obj);
+    _exit(0);
+  }
+  waitpid(pid, &status, 0);
+
+  int passed = WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+  printf("thread cache double free: %s\n", passed ? "passed" : "FAILED");
+  return !passed;
+}
+
+/**
+ * @brief The main function.
+ *
+ * @return 0 if every test passed, 1 otherwise.
+ */
+int main(void) {
+  pthread_t thread;
+  mm_stats_t stats;
+  int failures = 0;
+
+  mm_init();
+  MM_REG_STRUCT(test_obj_t);
+  mm_set_thread_cache(1);
+
+  pthread_create(&thread, NULL, test_thread, NULL);
+  pthread_join(thread, NULL);
+
+  mm_get_stats(&stats);
+  printf("thread cache teardown: %s\n",
+         stats.bytes_in_use ? "FAILED" : "passed");
+  if (stats.bytes_in_use) {
+    printf("Error: %lu bytes left in the cache of an exited thread\n",
+           (unsigned long)stats.bytes_in_use);
+    failures++;
+  }
+
+  failures += test_double_free();
+  return failures != 0;
+}
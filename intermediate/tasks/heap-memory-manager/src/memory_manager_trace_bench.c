@@ -0,0 +1,692 @@
+/****************************************************************/
+/******* Author    : Mahmoud Abdelraouf Mahmoud *****************/
+/******* Date      : 16 Oct 2026                *****************/
+/******* Version   : 0.1                        *****************/
+/******* File Name : memory_manager_trace_bench.c ***************/
+/****************************************************************/
+
+/**
+ * @file memory_manager_trace_bench.c
+ * @brief Allocation trace benchmark comparing the Memory Manager with glibc.
+ *
+ * This program replays synthetic allocation traces against the Memory
+ * Manager (`xmalloc_family()`/`xfree()`) and against glibc
+ * (`malloc()`/`free()`), and prints one machine-readable record per trace
+ * and allocator with:
+ *
+ * - the throughput in operations (allocations plus frees) per second,
+ * - the median and 99th percentile latency of an operation,
+ * - the resident set size at the end of the trace, before teardown,
+ * - the fragmentation ratio, i.e. the resident memory gained during the
+ *   trace divided by the bytes the live objects requested, or null when no
+ *   object is live.
+ *
+ * The prodcons trace frees everything it allocates, so its memory is
+ * sampled halfway through, while objects are in flight between the threads.
+ *
+ * Every run happens in a child process so that the allocators do not share
+ * resident memory. Both allocators replay the exact same sequence of
+ * requests for a given seed.
+ *
+ * Traces:
+ * - uniform:  random alloc/free over a working set, uniform sizes.
+ * - powerlaw: same pattern, sizes drawn from a power law (many small
+ *             objects, a few up to `max_size`).
+ * - prodcons: a producer thread allocates, a consumer thread frees.
+ * - lifetime: mostly short-lived objects interleaved with long-lived ones.
+ *
+ * Usage: hmm_trace_bench [-t trace] [-a hmm|glibc] [-n ops] [-w working_set]
+ *                        [-m min_size] [-M max_size] [-s seed] [-f csv|json]
+ */
+
+#include "memory_manager_api.h"
+#include "bench_common.h"
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+//-----------------< Macros section -----------------/
+#define BENCH_DEFAULT_OPS 2000000
+#define BENCH_DEFAULT_WORKING_SET 20000
+#define BENCH_DEFAULT_MIN_SIZE 16
+#define BENCH_DEFAULT_MAX_SIZE 512
+#define BENCH_DEFAULT_SEED 42
+
+/**
+ * @brief One operation out of this many is timed individually.
+ */
+#define BENCH_LATENCY_STRIDE 8
+
+/**
+ * @brief Largest size served from a size class page family; larger requests
+ * use a byte-sized family and end up in large object spans.
+ */
+#define BENCH_CLASS_MAX_SIZE 4096
+#define BENCH_CLASS_GRANULE 16
+#define BENCH_MAX_CLASSES 64
+
+/**
+ * @brief Capacity of the producer/consumer ring.
+ */
+#define BENCH_RING_SIZE 1024
+
+/**
+ * @brief Number of recently allocated objects kept by the lifetime trace
+ * before they are freed, and share of long-lived allocations.
+ */
+#define BENCH_SHORT_LIVED_WINDOW 64
+#define BENCH_LONG_LIVED_EVERY 10
+
+//-----------------< UserDefinedDataTypes User defined data types
+//-----------------/
+/**
+ * @brief Allocator under test.
+ */
+typedef enum {
+  BENCH_ALLOC_HMM = 0,  /**< The Memory Manager. */
+  BENCH_ALLOC_GLIBC = 1 /**< glibc malloc. */
+} bench_allocator_t;
+
+/**
+ * @brief Parameters shared by all traces.
+ */
+typedef struct bench_config_ {
+  unsigned long ops;       /**< Number of operations of a trace. */
+  uint32_t working_set;    /**< Number of object slots. */
+  uint32_t min_size;       /**< Smallest request in bytes. */
+  uint32_t max_size;       /**< Largest request in bytes. */
+  uint64_t seed;           /**< Seed of the request sequence. */
+} bench_config_t;
+
+/**
+ * @brief Measurements of one run, sent from the child to the parent.
+ */
+typedef struct bench_result_ {
+  unsigned long ops;  /**< Operations performed. */
+  double ops_per_sec; /**< Throughput. */
+  double p50_ns;      /**< Median operation latency. */
+  double p99_ns;      /**< 99th percentile operation latency. */
+  long rss_kb;        /**< Resident set size at the end of the trace. */
+  long live_kb;       /**< Bytes requested by the live objects. */
+  double frag_ratio;  /**< Resident memory gained per live byte, NaN when
+                         no object is live. */
+} bench_result_t;
+
+/**
+ * @brief State of a run: allocator, random generator and latency samples.
+ */
+typedef struct bench_run_ {
+  bench_allocator_t allocator; /**< Allocator under test. */
+  const bench_config_t *config; /**< Trace parameters. */
+  uint64_t rng;                 /**< xorshift64 state. */
+  uint64_t *samples;            /**< Sampled latencies in nanoseconds. */
+  unsigned long sample_count;   /**< Number of latency samples. */
+  unsigned long op_count;       /**< Operations performed. */
+  uint64_t live_bytes;          /**< Bytes requested by live objects. */
+  long peak_rss_kb;             /**< Resident set size sampled mid-trace by
+                                   traces that end with nothing live, 0 if
+                                   not sampled. */
+  uint64_t peak_live_bytes;     /**< Bytes live when `peak_rss_kb` was
+                                   sampled. */
+} bench_run_t;
+
+/**
+ * @brief A trace: name and replay function.
+ */
+typedef struct bench_trace_ {
+  const char *name;              /**< Name used on the command line. */
+  void (*replay)(bench_run_t *); /**< Runs the trace. */
+} bench_trace_t;
+
+/**
+ * @brief Single-producer single-consumer ring of the prodcons trace.
+ */
+typedef struct bench_ring_ {
+  void *objects[BENCH_RING_SIZE]; /**< Objects in flight. */
+  uint32_t sizes[BENCH_RING_SIZE]; /**< Sizes of the objects in flight. */
+  unsigned long head;             /**< Next slot written by the producer. */
+  unsigned long tail;             /**< Next slot read by the consumer. */
+} bench_ring_t;
+
+//-----------------< Global variables section -----------------/
+/**
+ * @brief Size class page families of the Memory Manager.
+ */
+static mm_family_handle_t bench_class_families[BENCH_MAX_CLASSES];
+
+/**
+ * @brief Size class index of each `BENCH_CLASS_GRANULE` bytes of request.
+ */
+static uint8_t bench_class_of_granule[BENCH_CLASS_MAX_SIZE /
+                                          BENCH_CLASS_GRANULE +
+                                      1];
+
+/**
+ * @brief Page family of one byte structures, used for requests larger than
+ * `BENCH_CLASS_MAX_SIZE`.
+ */
+static mm_family_handle_t bench_byte_family;
+
+//-----------------< Functions implementation section -----------------/
+/**
+ * @brief Returns the resident set size of the process in kilobytes.
+ */
+static long bench_rss_kb(void) {
+  long size = 0, resident = 0;
+  FILE *statm = fopen("/proc/self/statm", "r");
+
+  if (statm) {
+    if (fscanf(statm, "%ld %ld", &size, &resident) != 2) {
+      resident = 0;
+    }
+    fclose(statm);
+  }
+  return resident * (getpagesize() / 1024);
+}
+
+/**
+ * @brief Registers the size class page families of the Memory Manager.
+ *
+ * Classes are 16 bytes apart up to 256 bytes, then four per power of two up
+ * to `BENCH_CLASS_MAX_SIZE`.
+ */
+static void bench_hmm_setup(void) {
+  char name[32];
+  uint32_t size = BENCH_CLASS_GRANULE, count = 0, granule = 0;
+
+  mm_init();
+  while (count < BENCH_MAX_CLASSES) {
+    snprintf(name, sizeof(name), "bench_class_%u", size);
+    bench_class_families[count++] = mm_instantiate_new_page_family(name, size);
+    for (; granule <= size / BENCH_CLASS_GRANULE; granule++) {
+      bench_class_of_granule[granule] = count - 1;
+    }
+    if (size == BENCH_CLASS_MAX_SIZE) {
+      break;
+    }
+    size += size < 256 ? BENCH_CLASS_GRANULE : (size / 4) & ~15u;
+    if (size > BENCH_CLASS_MAX_SIZE) {
+      size = BENCH_CLASS_MAX_SIZE;
+    }
+  }
+  bench_byte_family = mm_instantiate_new_page_family("bench_byte", 1);
+}
+
+/**
+ * @brief Allocates `size` bytes with the allocator under test.
+ */
+static inline void *bench_alloc(bench_run_t *run, uint32_t size) {
+  if (run->allocator == BENCH_ALLOC_GLIBC) {
+    return malloc(size);
+  }
+  if (size <= BENCH_CLASS_MAX_SIZE) {
+    uint32_t granule =
+        (size + BENCH_CLASS_GRANULE - 1) / BENCH_CLASS_GRANULE;
+    return xmalloc_family(
+        bench_class_families[bench_class_of_granule[granule]], 1);
+  }
+  return xmalloc_family(bench_byte_family, size);
+}
+
+/**
+ * @brief Frees an object with the allocator under test.
+ */
+static inline void bench_free(bench_run_t *run, void *ptr) {
+  if (run->allocator == BENCH_ALLOC_GLIBC) {
+    free(ptr);
+  } else {
+    xfree(ptr);
+  }
+}
+
+/**
+ * @brief Allocates an object, touches its first and last bytes and samples
+ * the latency of the allocation.
+ */
+static void *bench_timed_alloc(bench_run_t *run, uint32_t size) {
+  void *ptr;
+
+  if (run->op_count++ % BENCH_LATENCY_STRIDE == 0) {
+    uint64_t start = bench_now_ns();
+    ptr = bench_alloc(run, size);
+    run->samples[run->sample_count++] = bench_now_ns() - start;
+  } else {
+    ptr = bench_alloc(run, size);
+  }
+
+  ((char *)ptr)[0] = 1;
+  ((char *)ptr)[size - 1] = 1;
+  run->live_bytes += size;
+  return ptr;
+}
+
+/**
+ * @brief Frees an object and samples the latency of the free.
+ */
+static void bench_timed_free(bench_run_t *run, void *ptr, uint32_t size) {
+  if (run->op_count++ % BENCH_LATENCY_STRIDE == 0) {
+    uint64_t start = bench_now_ns();
+    bench_free(run, ptr);
+    run->samples[run->sample_count++] = bench_now_ns() - start;
+  } else {
+    bench_free(run, ptr);
+  }
+  run->live_bytes -= size;
+}
+
+/**
+ * @brief Returns a size drawn uniformly between the configured bounds.
+ */
+static inline uint32_t bench_uniform_size(bench_run_t *run) {
+  const bench_config_t *config = run->config;
+  return config->min_size +
+         bench_rand(&run->rng) % (config->max_size - config->min_size + 1);
+}
+
+/**
+ * @brief Returns a size drawn from a power law: each octave above
+ * `min_size` is half as likely as the previous one.
+ */
+static inline uint32_t bench_powerlaw_size(bench_run_t *run) {
+  const bench_config_t *config = run->config;
+  uint64_t bits = bench_rand(&run->rng);
+  uint32_t size = config->min_size;
+
+  while ((bits & 1) && size * 2 <= config->max_size) {
+    size *= 2;
+    bits >>= 1;
+  }
+  size += (bits >> 8) % size;
+  return size > config->max_size ? config->max_size : size;
+}
+
+/**
+ * @brief Random alloc/free over the working set, sizes from `next_size`.
+ */
+static void bench_replay_slots(bench_run_t *run,
+                               uint32_t (*next_size)(bench_run_t *)) {
+  uint32_t working_set = run->config->working_set;
+  void **slots = calloc(working_set, sizeof(void *));
+  uint32_t *sizes = calloc(working_set, sizeof(uint32_t));
+  while (run->op_count < run->config->ops) {
+    uint32_t slot = bench_rand(&run->rng) % working_set;
+    if (slots[slot]) {
+      bench_timed_free(run, slots[slot], sizes[slot]);
+      slots[slot] = NULL;
+    } else {
+      sizes[slot] = next_size(run);
+      slots[slot] = bench_timed_alloc(run, sizes[slot]);
+    }
+  }
+
+  // The live objects stay allocated for the memory measurement and go away
+  // with the child process
+}
+
+/**
+ * @brief Replays the uniform trace.
+ */
+static void bench_replay_uniform(bench_run_t *run) {
+  bench_replay_slots(run, bench_uniform_size);
+}
+
+/**
+ * @brief Replays the power law trace.
+ */
+static void bench_replay_powerlaw(bench_run_t *run) {
+  bench_replay_slots(run, bench_powerlaw_size);
+}
+
+/**
+ * @brief Replays the lifetime trace.
+ *
+ * Every `BENCH_LONG_LIVED_EVERY`th allocation is long-lived and replaces a
+ * random long-lived slot; every other one is short-lived and freed after
+ * `BENCH_SHORT_LIVED_WINDOW` more allocations. The long-lived objects end up
+ * scattered between pages of short-lived ones, which is what fragments a
+ * heap.
+ */
+static void bench_replay_lifetime(bench_run_t *run) {
+  uint32_t working_set = run->config->working_set;
+  void **long_lived = calloc(working_set, sizeof(void *));
+  uint32_t *long_sizes = calloc(working_set, sizeof(uint32_t));
+  void *short_lived[BENCH_SHORT_LIVED_WINDOW] = {0};
+  uint32_t short_sizes[BENCH_SHORT_LIVED_WINDOW];
+  unsigned long allocations = 0;
+
+  while (run->op_count < run->config->ops) {
+    uint32_t size = bench_uniform_size(run);
+    if (allocations++ % BENCH_LONG_LIVED_EVERY == 0) {
+      uint32_t slot = bench_rand(&run->rng) % working_set;
+      if (long_lived[slot]) {
+        bench_timed_free(run, long_lived[slot], long_sizes[slot]);
+      }
+      long_sizes[slot] = size;
+      long_lived[slot] = bench_timed_alloc(run, size);
+    } else {
+      uint32_t slot = allocations % BENCH_SHORT_LIVED_WINDOW;
+      if (short_lived[slot]) {
+        bench_timed_free(run, short_lived[slot], short_sizes[slot]);
+      }
+      short_sizes[slot] = size;
+      short_lived[slot] = bench_timed_alloc(run, size);
+    }
+  }
+}
+
+/**
+ * @brief Arguments of the consumer thread of the prodcons trace.
+ */
+typedef struct bench_consumer_arg_ {
+  bench_run_t run;    /**< Consumer's own run state and samples. */
+  bench_ring_t *ring; /**< Ring shared with the producer. */
+  unsigned long count; /**< Number of objects to free. */
+} bench_consumer_arg_t;
+
+/**
+ * @brief Consumer thread: frees every object the producer hands over.
+ */
+static void *bench_consumer(void *arg) {
+  bench_consumer_arg_t *consumer = arg;
+  bench_ring_t *ring = consumer->ring;
+  unsigned long i;
+
+  for (i = 0; i < consumer->count; i++) {
+    while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ring->tail) {
+      sched_yield();
+    }
+    uint32_t slot = ring->tail % BENCH_RING_SIZE;
+    bench_timed_free(&consumer->run, ring->objects[slot], ring->sizes[slot]);
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+/**
+ * @brief Samples the resident set size and the bytes of the objects in the
+ * ring, i.e. allocated by the producer and not yet taken by the consumer.
+ *
+ * The consumer keeps running, so the objects it frees meanwhile are still
+ * counted as live.
+ */
+static void bench_sample_in_flight(bench_run_t *run, bench_ring_t *ring,
+                                   unsigned long head) {
+  unsigned long tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  uint64_t live_bytes = 0;
+
+  for (; tail < head; tail++) {
+    live_bytes += ring->sizes[tail % BENCH_RING_SIZE];
+  }
+  run->peak_rss_kb = bench_rss_kb();
+  run->peak_live_bytes = live_bytes;
+}
+
+/**
+ * @brief Replays the producer/consumer trace.
+ *
+ * The calling thread allocates and a second thread frees, so every object
+ * is freed by a thread other than the one that allocated it.
+ */
+static void bench_replay_prodcons(bench_run_t *run) {
+  bench_ring_t *ring = calloc(1, sizeof(bench_ring_t));
+  bench_consumer_arg_t consumer;
+  unsigned long count = run->config->ops / 2, i;
+  pthread_t tid;
+
+  consumer.run = *run;
+  consumer.run.samples = malloc((count / BENCH_LATENCY_STRIDE + 1) *
+                                sizeof(uint64_t));
+  consumer.run.sample_count = 0;
+  consumer.run.op_count = 0;
+  consumer.run.live_bytes = 0;
+  consumer.ring = ring;
+  consumer.count = count;
+  pthread_create(&tid, NULL, bench_consumer, &consumer);
+
+  for (i = 0; i < count; i++) {
+    while (i - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >=
+           BENCH_RING_SIZE) {
+      sched_yield();
+    }
+    uint32_t slot = i % BENCH_RING_SIZE;
+    ring->sizes[slot] = bench_uniform_size(run);
+    ring->objects[slot] = bench_timed_alloc(run, ring->sizes[slot]);
+    __atomic_store_n(&ring->head, i + 1, __ATOMIC_RELEASE);
+
+    // Everything is freed by the end, so measure the objects in flight
+    if (i + 1 == count / 2) {
+      bench_sample_in_flight(run, ring, i + 1);
+    }
+  }
+  pthread_join(tid, NULL);
+
+  // Merge the consumer's measurements into the run
+  memcpy(run->samples + run->sample_count, consumer.run.samples,
+         consumer.run.sample_count * sizeof(uint64_t));
+  run->sample_count += consumer.run.sample_count;
+  run->op_count += consumer.run.op_count;
+  run->live_bytes += consumer.run.live_bytes;
+  free(consumer.run.samples);
+  free(ring);
+}
+
+/**
+ * @brief Compares two latency samples, for qsort().
+ */
+static int bench_cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a;
+  uint64_t y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Runs one trace with one allocator in the calling process.
+ *
+ * @param trace Trace to replay.
+ * @param allocator Allocator under test.
+ * @param config Trace parameters.
+ * @param result Receives the measurements.
+ */
+static void bench_run_trace(const bench_trace_t *trace,
+                            bench_allocator_t allocator,
+                            const bench_config_t *config,
+                            bench_result_t *result) {
+  bench_run_t run = {0};
+
+  run.allocator = allocator;
+  run.config = config;
+  run.rng = config->seed ? config->seed : 1;
+  run.samples =
+      malloc((config->ops / BENCH_LATENCY_STRIDE + 2) * sizeof(uint64_t));
+  if (allocator == BENCH_ALLOC_HMM) {
+    bench_hmm_setup();
+  }
+
+  // Fault the sample buffer in so that it does not count as allocator memory
+  memset(run.samples, 0,
+         (config->ops / BENCH_LATENCY_STRIDE + 2) * sizeof(uint64_t));
+  long rss_base = bench_rss_kb();
+
+  uint64_t start = bench_now_ns();
+  trace->replay(&run);
+  double elapsed = (bench_now_ns() - start) / 1e9;
+
+  qsort(run.samples, run.sample_count, sizeof(uint64_t), bench_cmp_u64);
+  result->ops = run.op_count;
+  result->ops_per_sec = run.op_count / elapsed;
+  result->p50_ns = run.sample_count ? run.samples[run.sample_count / 2] : 0;
+  result->p99_ns =
+      run.sample_count ? run.samples[run.sample_count * 99 / 100] : 0;
+  // Traces that end with nothing live were sampled on the way
+  uint64_t live_bytes = run.live_bytes;
+  result->rss_kb = bench_rss_kb();
+  if (run.peak_rss_kb) {
+    result->rss_kb = run.peak_rss_kb;
+    live_bytes = run.peak_live_bytes;
+  }
+  result->live_kb = live_bytes / 1024;
+  result->frag_ratio =
+      live_bytes ? (result->rss_kb - rss_base) * 1024.0 / live_bytes : NAN;
+  free(run.samples);
+}
+
+/**
+ * @brief Runs one trace with one allocator in a child process.
+ *
+ * @return 0 on success, -1 if the child failed.
+ */
+static int bench_run_isolated(const bench_trace_t *trace,
+                              bench_allocator_t allocator,
+                              const bench_config_t *config,
+                              bench_result_t *result) {
+  int fds[2], status;
+  pid_t pid;
+
+  if (pipe(fds) != 0) {
+    return -1;
+  }
+
+  pid = fork();
+  if (pid == 0) {
+    close(fds[0]);
+    bench_run_trace(trace, allocator, config, result);
+    ssize_t written = write(fds[1], result, sizeof(*result));
+    _exit(written == sizeof(*result) ? 0 : 1);
+  }
+
+  close(fds[1]);
+  ssize_t got = pid > 0 ? read(fds[0], result, sizeof(*result)) : -1;
+  close(fds[0]);
+  if (pid > 0) {
+    waitpid(pid, &status, 0);
+  }
+  return got == sizeof(*result) ? 0 : -1;
+}
+
+/**
+ * @brief Prints a usage message.
+ */
+static void bench_usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [-t uniform|powerlaw|prodcons|lifetime] [-a hmm|glibc]\n"
+          "          [-n ops] [-w working_set] [-m min_size] [-M max_size]\n"
+          "          [-s seed] [-f csv|json]\n",
+          prog);
+}
+
+/**
+ * @brief The main function.
+ *
+ * @param argc The number of command-line arguments.
+ * @param argv An array of command-line arguments.
+ * @return An integer indicating the exit status of the program.
+ */
+int main(int argc, char **argv) {
+  static const bench_trace_t traces[] = {
+      {"uniform", bench_replay_uniform},
+      {"powerlaw", bench_replay_powerlaw},
+      {"prodcons", bench_replay_prodcons},
+      {"lifetime", bench_replay_lifetime},
+  };
+  static const char *allocator_names[] = {"hmm", "glibc"};
+  bench_config_t config = {BENCH_DEFAULT_OPS, BENCH_DEFAULT_WORKING_SET,
+                           BENCH_DEFAULT_MIN_SIZE, BENCH_DEFAULT_MAX_SIZE,
+                           BENCH_DEFAULT_SEED};
+  const char *trace_filter = NULL, *allocator_filter = NULL;
+  int json = 0, first = 1, opt;
+  size_t t, a;
+
+  while ((opt = getopt(argc, argv, "t:a:n:w:m:M:s:f:h")) != -1) {
+    switch (opt) {
+    case 't':
+      trace_filter = optarg;
+      break;
+    case 'a':
+      allocator_filter = optarg;
+      break;
+    case 'n':
+      config.ops = strtoul(optarg, NULL, 10);
+      break;
+    case 'w':
+      config.working_set = strtoul(optarg, NULL, 10);
+      break;
+    case 'm':
+      config.min_size = strtoul(optarg, NULL, 10);
+      break;
+    case 'M':
+      config.max_size = strtoul(optarg, NULL, 10);
+      break;
+    case 's':
+      config.seed = strtoull(optarg, NULL, 10);
+      break;
+    case 'f':
+      json = strcmp(optarg, "json") == 0;
+      break;
+    default:
+      bench_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (config.min_size == 0 || config.max_size < config.min_size ||
+      config.working_set == 0) {
+    bench_usage(argv[0]);
+    return 1;
+  }
+
+  if (json) {
+    printf("[\n");
+  } else {
+    printf("trace,allocator,ops,ops_per_sec,p50_ns,p99_ns,rss_kb,live_kb,"
+           "frag_ratio\n");
+  }
+
+  for (t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+    if (trace_filter && strcmp(trace_filter, traces[t].name) != 0) {
+      continue;
+    }
+    for (a = 0; a < sizeof(allocator_names) / sizeof(allocator_names[0]);
+         a++) {
+      bench_result_t result;
+      if (allocator_filter && strcmp(allocator_filter, allocator_names[a])) {
+        continue;
+      }
+      if (bench_run_isolated(&traces[t], (bench_allocator_t)a, &config,
+                             &result) != 0) {
+        fprintf(stderr, "%s/%s: run failed\n", traces[t].name,
+                allocator_names[a]);
+        continue;
+      }
+      if (json) {
+        // JSON has no NaN, a ratio without live objects is null
+        char frag_ratio[32] = "null";
+        if (!isnan(result.frag_ratio)) {
+          snprintf(frag_ratio, sizeof(frag_ratio), "%.3f", result.frag_ratio);
+        }
+        printf("%s  {\"trace\": \"%s\", \"allocator\": \"%s\", \"ops\": %lu, "
+               "\"ops_per_sec\": %.0f, \"p50_ns\": %.0f, \"p99_ns\": %.0f, "
+               "\"rss_kb\": %ld, \"live_kb\": %ld, \"frag_ratio\": %s}",
+               first ? "" : ",\n", traces[t].name, allocator_names[a],
+               result.ops, result.ops_per_sec, result.p50_ns, result.p99_ns,
+               result.rss_kb, result.live_kb, frag_ratio);
+      } else {
+        printf("%s,%s,%lu,%.0f,%.0f,%.0f,%ld,%ld,%.3f\n", traces[t].name,
+               allocator_names[a], result.ops, result.ops_per_sec,
+               result.p50_ns, result.p99_ns, result.rss_kb, result.live_kb,
+               result.frag_ratio);
+      }
+      first = 0;
+      fflush(stdout);
+    }
+  }
+
+  if (json) {
+    printf("\n]\n");
+  }
+  return 0;
+}